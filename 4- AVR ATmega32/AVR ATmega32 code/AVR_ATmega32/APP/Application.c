@@ -7,11 +7,74 @@
  *******************************************************************************/
 #include "Application.h"
 
+/*********************** Definitions ***********************/
+/* Closing speed estimator of one direction */
+typedef struct
+{
+	uint16 lastMM;			/* Previous valid distance */
+	uint32 lastTimestamp;	/* Its echo time in microseconds */
+	uint8 hasLast;			/* FALSE until a valid sample is seen, or after an echo timeout */
+	sint16 speed;			/* Filtered closing speed in mm/s, positive when approaching */
+} App_ClosingType;
+
+/* Collision avoidance decision for one direction */
+typedef enum
+{
+	APP_ZONE_CLEAR, APP_ZONE_WARNING, APP_ZONE_BRAKE
+} App_ZoneType;
+
+static App_ZoneType App_collisionZone(uint16 distanceMM, sint16 closingSpeed);
+static sint16 App_closingSpeed(sint16 measured, sint8 throttle);
+static uint8 App_isCommand(uint8 command);
+
 /*********************** Global Variables ***********************/
 volatile uint16 g_distanceRight    = 0;
 volatile uint16 g_distanceForward  = 0;
 volatile uint16 g_distanceBackward = 0;
 volatile uint8  g_selection 	   = 0;
+volatile uint8  g_warning		   = FALSE;	/* Obstacle inside the warning zone */
+
+/* Last drive command, throttle and turn in percent, and the driving speed they are scaled to */
+static sint8 g_throttle = 0;
+static sint8 g_turn = 0;
+static sint8 g_requestedThrottle = 0;	/* Throttle of the last command, before the obstacle block */
+static sint16 g_speedMM_S = (MOTOR_SPEED_ONE * MOTION_FULL_SPEED_MM_S) / 100;
+static uint32 g_joystickTime = 0;		/* Time of the last joystick packet in milliseconds */
+static uint8 g_braking = FALSE;			/* Brake pulse running, the commands are applied at its end */
+static uint8 g_commandPending = FALSE;	/* A command came during the brake pulse */
+static uint8 g_halted = FALSE;			/* Stopped after a brake pulse, the throttle is not driven any more */
+static uint8 g_presence = FALSE;		/* Someone near the car, the drive commands are dropped */
+
+/* Full range distances and closing speeds used by collisionAvoidance */
+static uint16 g_distanceForwardMM  = 0;
+static uint16 g_distanceBackwardMM = 0;
+static App_ClosingType g_closingForward  = {0, 0, FALSE, 0};
+static App_ClosingType g_closingBackward = {0, 0, FALSE, 0};
+
+/*
+ * Task table, ordered by priority. Times are in scheduler ticks (1ms).
+ * The sensors cycle takes up to 60ms, sensing and avoidance poll it faster so
+ * a new cycle is acted on within 10ms.
+ */
+static Scheduler_TaskType g_tasks[] = {
+	{.task = readDistance, .period = 10, .offset = 0, .deadline = 10},
+	{.task = collisionAvoidance, .period = 10, .offset = 1, .deadline = 10},
+	{.task = App_commandTask, .period = 10, .offset = 2, .deadline = 10},
+	{.task = DcMotor_rampTick, .period = MOTOR_RAMP_PERIOD_MS, .offset = 0, .deadline = MOTOR_RAMP_PERIOD_MS},
+#if (MOTOR_SPEED_CONTROL == TRUE)
+	{.task = DcMotor_speedTick, .period = MOTOR_SPEED_PERIOD_MS, .offset = 1, .deadline = MOTOR_SPEED_PERIOD_MS},
+#endif
+	{.task = Parking_task, .period = PARKING_TASK_PERIOD_MS, .offset = 3, .deadline = PARKING_TASK_PERIOD_MS},
+	{.task = App_feedbackTask, .period = APP_FEEDBACK_PERIOD_MS, .offset = 2, .deadline = APP_FEEDBACK_PERIOD_MS},
+	{.task = Pattern_task, .period = PATTERN_TICK_MS, .offset = 4, .deadline = PATTERN_TICK_MS},
+	{.task = PIR_task, .period = PIR_SAMPLE_PERIOD_MS, .offset = 5, .deadline = PIR_SAMPLE_PERIOD_MS},
+	{.task = App_telemetryTask, .period = APP_TELEMETRY_PERIOD_MS, .offset = 3, .deadline = APP_TELEMETRY_PERIOD_MS},
+	{.task = App_lcdTask, .period = APP_LCD_PERIOD_MS, .offset = 4, .deadline = APP_LCD_PERIOD_MS},
+	{.task = LCD_task, .period = LCD_TASK_PERIOD_MS, .offset = 0, .deadline = LCD_TASK_PERIOD_MS},
+#if (TRACE_ENABLE == TRUE)
+	{.task = Trace_task, .period = TRACE_TASK_PERIOD_MS, .offset = 6, .deadline = TRACE_TASK_PERIOD_MS}
+#endif
+};
 
 /****************** Interrupt Service Routines ******************/
 /*
@@ -28,80 +91,329 @@ int main(void)
 {
 	SREG |= (1 << 7);		/* Enable global interrupts */
 
-	UART_Init(&config);
-	UART_SetRxCallback(App_Receive);
+	Timebase_init();		/* Free running Timer1 shared by all drivers */
+
+	UART_Init(&config);		/* Received commands are queued and run by App_commandTask */
 
 	LCD_init();
-	LEDS_init();
-	Buzzer_init();
-	DcMotor_Init(MOTOR_SPEED_ONE);
+	Pattern_init();			/* Buzzer and LEDs */
+	DcMotor_Init();
 
 	Ultrasonic_init();
 
+	PIR_init();				/* Presence changes are reported to App_presence by PIR_task */
+	PIR_setCallBack(App_presence);
+
+	Scheduler_init(g_tasks, sizeof(g_tasks) / sizeof(g_tasks[0]));
+
 	while (1)
 	{
-		readDistance();			/* Read distances from Three Ultrasonics */
-		collisionAvoidance();	/* Handle collision avoidance mode  */
+		Scheduler_dispatch();	/* Run the released tasks */
 	}
 }
 
 /********************* Functions Definitions *********************/
+
+/*
+ * Description :
+ * 	- Drive with a throttle and a turn in percent of the driving speed, turn positive to the right.
+ * 	- Turn 100 is the angular speed that makes the wheels differ by the driving speed.
+ */
+static void App_drive(sint8 throttle, sint8 turn)
+{
+	sint32 l_linear;
+	sint32 l_angular = -(((sint32)turn * g_speedMM_S * 1000) / (100 * MOTION_TRACK_MM));
+
+	if(TRUE == g_presence)
+	{
+		return;		/* Stays stopped, no throttle is left for collisionAvoidance to brake on */
+	}
+
+	g_requestedThrottle = throttle;
+	/*
+	 * Towards an obstacle inside the brake zone of the commanded speed only the turn is kept, a held
+	 * joystick does not restart after the brake pulse and creep into the stop margin.
+	 */
+	if(((throttle > 0) && (APP_ZONE_BRAKE == App_collisionZone(g_distanceForwardMM,
+			App_closingSpeed(g_closingForward.speed, throttle)))) ||
+		((throttle < 0) && (APP_ZONE_BRAKE == App_collisionZone(g_distanceBackwardMM,
+			App_closingSpeed(g_closingBackward.speed, throttle)))))
+	{
+		throttle = 0;
+	}
+	l_linear = ((sint32)throttle * g_speedMM_S) / 100;
+
+	g_throttle = throttle;
+	g_turn = turn;
+	g_halted = FALSE;
+	if(TRUE == g_braking)
+	{
+		g_commandPending = TRUE;	/* Driven by collisionAvoidance once the pulse is over */
+	}
+	else
+	{
+		Motion_set((sint16)l_linear, (sint16)l_angular);
+	}
+}
+
+/*
+ * Description : Stop the car and forget the drive command.
+ */
+static void App_stop(void)
+{
+	g_throttle = 0;
+	g_requestedThrottle = 0;
+	g_turn = 0;
+	g_commandPending = FALSE;
+	Stop();
+}
+
+/*
+ * Description : Clamp a joystick axis to -APP_JOYSTICK_MAX..APP_JOYSTICK_MAX.
+ */
+static sint8 App_joystickAxis(uint8 value)
+{
+	sint8 l_axis = (sint8)value;
+
+	if(l_axis > APP_JOYSTICK_MAX)
+	{
+		l_axis = APP_JOYSTICK_MAX;
+	}
+	else if(l_axis < -APP_JOYSTICK_MAX)
+	{
+		l_axis = -APP_JOYSTICK_MAX;
+	}
+	return l_axis;
+}
+
+void App_commandTask(void)
+{
+	static uint8 l_packet[APP_JOYSTICK_PACKET_LENGTH];
+	static uint8 l_length = 0;
+	uint8 l_command;
+	uint8 i;
+	uint8 j;
+
+	/* Run the commands queued by the UART receive interrupt */
+	while (UART_readByte(&l_command))
+	{
+		if((0 == l_length) && (APP_TRACE_DUMP_COMMAND == l_command))
+		{
+#if (TRACE_ENABLE == TRUE)
+			Trace_dump();
+#endif
+			continue;		/* Never a drive command, even without the trace */
+		}
+		if((0 == l_length) && (APP_JOYSTICK_HEADER != l_command))
+		{
+			/* While the stream runs a byte out of a packet is a lost packet remainder, only a stop goes through */
+			if((APP_JOYSTICK_HEADER != g_selection) || ('S' == l_command))
+			{
+				App_Receive(l_command);
+			}
+			continue;
+		}
+
+		l_packet[l_length++] = l_command;
+		if(APP_JOYSTICK_PACKET_LENGTH == l_length)
+		{
+			l_length = 0;
+			if((l_packet[0] ^ l_packet[1] ^ l_packet[2]) == l_packet[3])
+			{
+				App_joystick(App_joystickAxis(l_packet[1]), App_joystickAxis(l_packet[2]));
+			}
+			else
+			{
+				/* Corrupted or misaligned: dropped, the next header in it starts the next packet */
+				for(i = 1; i < APP_JOYSTICK_PACKET_LENGTH; i++)
+				{
+					if(APP_JOYSTICK_HEADER == l_packet[i])
+					{
+						for(j = i; j < APP_JOYSTICK_PACKET_LENGTH; j++)
+						{
+							l_packet[l_length++] = l_packet[j];
+						}
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	/* The link or the phone is gone, do not keep driving on the last packet */
+	if((APP_JOYSTICK_HEADER == g_selection) && ((Timebase_millis() - g_joystickTime) >= APP_JOYSTICK_TIMEOUT_MS))
+	{
+		g_selection = 'S';
+		App_stop();
+	}
+}
+
+void App_joystick(sint8 turn, sint8 throttle)
+{
+	if(APP_JOYSTICK_HEADER != g_selection)
+	{
+		Parking_abort();	/* Only the first packet, the ramp is never restarted by the stream */
+		g_selection = APP_JOYSTICK_HEADER;
+	}
+	g_joystickTime = Timebase_millis();
+	App_drive(throttle, turn);
+}
+
+void App_presence(PIR_Sensor sensor, uint8 present)
+{
+	(void)sensor;
+	(void)present;
+
+	/* Blocked while any of the sensors sees someone */
+	g_presence = ((TRUE == PIR_isPresent(PIR_SENSOR0)) || (TRUE == PIR_isPresent(PIR_SENSOR1))) ? TRUE : FALSE;
+	if(TRUE == g_presence)
+	{
+		Parking_abort();
+		App_stop();
+		Pattern_cadence(PATTERN_GREEN, 1, 1);
+	}
+	else
+	{
+		Pattern_stop(PATTERN_GREEN);
+	}
+}
+
+/*
+ * Description : TRUE for the one character commands run by App_Receive.
+ */
+static uint8 App_isCommand(uint8 command)
+{
+	switch(command)
+	{
+	case 'F': case 'B': case 'S': case 'R': case 'L': case 'A': case 'H': case 'P':
+	case '1': case '2': case '3':
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
 void App_Receive(uint8 recievedMSG)
 {
+	if(FALSE == App_isCommand(recievedMSG))
+	{
+		return;		/* Line endings and noise change nothing, the joystick timeout keeps running */
+	}
+
+	Parking_abort();		/* Any new command takes the car back from the parking planner */
+
 	g_selection = recievedMSG ;
 	switch (recievedMSG)
 	{
 	case 'F':
-		Forward();			/* Move forward */
+		App_drive(100, 0);		/* Move forward */
 		break;
 	case 'B':
-		Backward();			/* Move backward */
+		App_drive(-100, 0);		/* Move backward */
 		break;
 	case 'S':
-		Stop();				/* Stop movement */
+		App_stop();				/* Stop movement */
 		break;
 	case 'R':
-		Right_Forward();	/* Turn right and move forward */
+		App_drive(50, 100);		/* Turn right and move forward, the right wheel stops */
 		break;
 	case 'L':
-		Left_Forward();		/* Turn left and move forward */
+		App_drive(50, -100);	/* Turn left and move forward, the left wheel stops */
 		break;
 	case 'A':
-		Right_Backward();	/* Turn right and move backward */
+		App_drive(-50, -100);	/* Turn right and move backward, the right wheel stops */
 		break;
 	case 'H':
-		Left_Backward();	/* Turn left and move backward */
+		App_drive(-50, 100);	/* Turn left and move backward, the left wheel stops */
 		break;
 	case 'P':
-		autoParking();		/* Perform auto-parking */
+		g_throttle = 0;			/* The planner drives, not checked by collisionAvoidance */
+		g_requestedThrottle = 0;
+		g_turn = 0;
+		g_commandPending = FALSE;
+		g_braking = FALSE;		/* The planner owns the motors, a brake pulse end must not stop them */
+		if(FALSE == g_presence)
+		{
+			Parking_start();	/* Auto-parking, run by Parking_task */
+		}
 		break;
 	case '1':
-		DcMotor_Init(MOTOR_SPEED_ONE);	/* Reinitialize motor with new speed */
+		g_speedMM_S = (MOTOR_SPEED_ONE * MOTION_FULL_SPEED_MM_S) / 100;
+		App_drive(g_throttle, g_turn);	/* Keep moving the same way at the new speed */
 		break;
 	case '2':
-		DcMotor_Init(MOTOR_SPEED_TWO);	/* Reinitialize motor with new speed */
+		g_speedMM_S = (MOTOR_SPEED_TWO * MOTION_FULL_SPEED_MM_S) / 100;
+		App_drive(g_throttle, g_turn);
 		break;
 	case '3':
-		DcMotor_Init(MOTOR_MAX_SPEED);	/* Reinitialize motor with new speed */
+		g_speedMM_S = (MOTOR_MAX_SPEED * MOTION_FULL_SPEED_MM_S) / 100;
+		App_drive(g_throttle, g_turn);
 		break;
 	}
 }
 
-void readDistance(void)
+/*
+ * Description :
+ * 	- Update the closing speed estimate of one direction with its latest sample.
+ * 	- The speed is taken between two time stamped valid samples and averaged with
+ * 	  the previous estimate (half weight each) to smooth the echo jitter.
+ */
+static void App_updateClosing(App_ClosingType * closing_Ptr, const Ultrasonic_SampleType * sample_Ptr)
 {
-	uint16 l_nums[3];
+	uint32 l_elapsedMs;
+	sint32 l_speed;
 
-	g_distanceRight = Ultrasonic_readDistance(U_right);
+	if(FALSE == sample_Ptr->valid)
+	{
+		/* Nothing in range, restart from the next echo */
+		closing_Ptr->hasLast = FALSE;
+		closing_Ptr->speed = 0;
+		return;
+	}
+
+	if(TRUE == closing_Ptr->hasLast)
+	{
+		l_elapsedMs = (sample_Ptr->timestamp - closing_Ptr->lastTimestamp + 500u) / 1000u;
+		if(0 == l_elapsedMs)
+		{
+			return;		/* Same sample as last time */
+		}
+		l_speed = ((sint32)closing_Ptr->lastMM - (sint32)sample_Ptr->distanceMM) * 1000 / (sint32)l_elapsedMs;
+		if((l_speed > APP_SPEED_LIMIT_MM_S) || (l_speed < -APP_SPEED_LIMIT_MM_S))
+		{
+			return;		/* Glitch, keep the previous sample as reference */
+		}
+		closing_Ptr->speed = (sint16)((closing_Ptr->speed + l_speed) / 2);
+	}
 
-	_delay_ms(100);
+	closing_Ptr->lastMM = sample_Ptr->distanceMM;
+	closing_Ptr->lastTimestamp = sample_Ptr->timestamp;
+	closing_Ptr->hasLast = TRUE;
+}
 
-	g_distanceForward = Ultrasonic_readDistance(U_forward);
+void readDistance(void)
+{
+	static uint16 l_lastCycle = 0;
+	uint16 l_cycle = Ultrasonic_getCycleCount();
+	Ultrasonic_SampleType l_sample;
 
-	_delay_ms(100);
+	/* The sensors are measured in the background, only act on a completed cycle */
+	if(l_cycle == l_lastCycle)
+	{
+		return;
+	}
+	l_lastCycle = l_cycle;
 
-	g_distanceBackward = Ultrasonic_readDistance(U_backward);
+	Ultrasonic_getSample(U_forward, &l_sample);
+	g_distanceForwardMM = l_sample.distanceMM;
+	App_updateClosing(&g_closingForward, &l_sample);
+	Ultrasonic_getSample(U_backward, &l_sample);
+	g_distanceBackwardMM = l_sample.distanceMM;
+	App_updateClosing(&g_closingBackward, &l_sample);
 
-	_delay_ms(100);
+	g_distanceRight = Ultrasonic_readDistance(U_right);
+	g_distanceForward = Ultrasonic_readDistance(U_forward);
+	g_distanceBackward = Ultrasonic_readDistance(U_backward);
 
 	if(g_distanceRight >= 100)
 	{
@@ -115,128 +427,302 @@ void readDistance(void)
 	{
 		g_distanceBackward = 99;
 	}
+}
+
+void App_telemetryTask(void)
+{
+#if (TELEMETRY_MODE == TELEMETRY_MODE_BINARY)
+	Telemetry_SampleType l_frame;
+	Ultrasonic_SampleType l_sample;
+
+	/* Full range distances straight from the sensors, not the clamped globals */
+	l_frame.flags = (TRUE == g_warning) ? TELEMETRY_FLAG_WARNING : 0;
+	Ultrasonic_getSample(U_right, &l_sample);
+	l_frame.distanceRightMM = l_sample.distanceMM;
+	l_frame.flags |= (TRUE == l_sample.valid) ? TELEMETRY_FLAG_RIGHT_VALID : 0;
+	Ultrasonic_getSample(U_forward, &l_sample);
+	l_frame.distanceForwardMM = l_sample.distanceMM;
+	l_frame.flags |= (TRUE == l_sample.valid) ? TELEMETRY_FLAG_FORWARD_VALID : 0;
+	Ultrasonic_getSample(U_backward, &l_sample);
+	l_frame.distanceBackwardMM = l_sample.distanceMM;
+	l_frame.flags |= (TRUE == l_sample.valid) ? TELEMETRY_FLAG_BACKWARD_VALID : 0;
+	l_frame.motor1Duty = DcMotor_getDuty(0);
+	l_frame.motor2Duty = DcMotor_getDuty(1);
+
+	Telemetry_send(&l_frame);
+#else
+	uint16 l_nums[3];
 
 	l_nums[0] = g_distanceRight;
 	l_nums[1] = g_distanceForward;
 	l_nums[2] = g_distanceBackward;
 
 	UART_SendNumbersWithDelimiter(l_nums, 3, ',');
+#endif
 }
 
-void collisionAvoidance(void)
+/*
+ * Description : Write a distance (0 - 99) as two characters into the LCD line.
+ */
+static void App_formatDistance(char * str, uint16 distance)
+{
+	str[0] = (distance >= 10) ? ('0' + (distance / 10)) : ' ';
+	str[1] = '0' + (distance % 10);
+}
+
+/*
+ * Description : Parking status shown on the second LCD row.
+ */
+static const char * App_parkingStatus(Parking_StateType state)
 {
-	if(g_distanceForward <= 40 && (g_selection == 'F' || g_selection == 'R' || g_selection == 'L'))
+	switch(state)
 	{
-		if(g_distanceForward <= 30)
-		{
-			Backward();
-			_delay_ms(100);
-			Stop();
-			Buzzer_off();
-		}
-		else
-		{
-			Buzzer_on();
-		}
+	case PARKING_SEARCH:
+		return "SEARCHING";
+	case PARKING_ALIGN:
+	case PARKING_PIVOT_IN:
+	case PARKING_REVERSE:
+	case PARKING_PIVOT_OUT:
+	case PARKING_CENTER:
+		return "SPACE Available";
+	case PARKING_DONE:
+		return "PARKED";
+	case PARKING_UNCENTERED:
+		return "PARKED OFF CTR";
+	case PARKING_NO_SPACE:
+		return "NO SPACE";
+	case PARKING_FAILED:
+		return "PARKING FAILED";
+	case PARKING_ABORTED:
+		return "PARKING ABORTED";
+	default:
+		return "";
+	}
+}
+
+void App_lcdTask(void)
+{
+	/* Row 0: "F:xx R:xx B:xx  ", row 1: parking status */
+	static char l_distances[APP_LCD_LINE_LENGTH + 1] = "F:   R:   B:    ";
+	char l_status[APP_LCD_LINE_LENGTH + 1];
+	const char * l_text = App_parkingStatus(Parking_getState());
+	uint8 i;
+
+	App_formatDistance(&l_distances[2], g_distanceForward);
+	App_formatDistance(&l_distances[7], g_distanceRight);
+	App_formatDistance(&l_distances[12], g_distanceBackward);
+
+	/* Padded with spaces so a shorter status clears the previous one */
+	for(i = 0; i < APP_LCD_LINE_LENGTH; i++)
+	{
+		l_status[i] = (*l_text != '\0') ? *l_text++ : ' ';
 	}
-	else if(g_distanceBackward <= 40 && (g_selection == 'B' || g_selection == 'A' || g_selection == 'H'))
+	l_status[APP_LCD_LINE_LENGTH] = '\0';
+
+	/* Only the changed cells are sent, by LCD_task */
+	LCD_print(0, 0, l_distances);
+	LCD_print(1, 0, l_status);
+}
+
+/*
+ * Description : Nearest valid distance among the watched sides, 0 when nothing is in range.
+ */
+static uint16 App_nearestMM(uint8 forward, uint8 backward)
+{
+	uint16 l_nearest = 0;
+
+	if((TRUE == forward) && (TRUE == g_closingForward.hasLast))
 	{
-		if(g_distanceBackward <= 30)
-		{
-			Forward();
-			_delay_ms(100);
-			Stop();
-			Buzzer_off();
-		}
-		else
-		{
-			Buzzer_on();
-		}
+		l_nearest = g_distanceForwardMM;
 	}
-	else
+	if((TRUE == backward) && (TRUE == g_closingBackward.hasLast) &&
+		((0 == l_nearest) || (g_distanceBackwardMM < l_nearest)))
+	{
+		l_nearest = g_distanceBackwardMM;
+	}
+	return l_nearest;
+}
+
+/*
+ * Description : Blue LED pattern of a parking state, only started when the state changes.
+ */
+static void App_parkingFeedback(Parking_StateType state)
+{
+	static const uint8 l_blinkSteps[] = {25, 25};
+	static const uint8 l_flashesSteps[] = {10, 10, 10, 10, 10};
+	static const Pattern_Type l_blink = {l_blinkSteps, sizeof(l_blinkSteps), TRUE};
+	static const Pattern_Type l_flashes = {l_flashesSteps, sizeof(l_flashesSteps), FALSE};
+
+	switch(state)
 	{
-		Buzzer_off();
+	case PARKING_SEARCH:
+		Pattern_play(PATTERN_BLUE, &l_blink);
+		break;
+	case PARKING_ALIGN:
+	case PARKING_PIVOT_IN:
+	case PARKING_REVERSE:
+	case PARKING_PIVOT_OUT:
+	case PARKING_CENTER:
+		break;		/* Keeps blinking */
+	case PARKING_DONE:
+	case PARKING_UNCENTERED:
+		Pattern_cadence(PATTERN_BLUE, 1, 1);		/* In the slot either way, the LCD tells them apart */
+		break;
+	case PARKING_NO_SPACE:
+	case PARKING_FAILED:
+	case PARKING_ABORTED:
+		Pattern_play(PATTERN_BLUE, &l_flashes);
+		break;
+	default:
+		Pattern_stop(PATTERN_BLUE);
+		break;
 	}
 }
 
-void autoParking (void)
+void App_feedbackTask(void)
 {
-	uint8 l_counter = 0;
+	static Parking_StateType l_lastParking = PARKING_IDLE;
+	Parking_StateType l_parking = Parking_getState();
+	uint8 l_parkingActive = Parking_isActive();
+	uint16 l_nearest = App_nearestMM((g_requestedThrottle > 0) || (TRUE == l_parkingActive),
+									 (g_requestedThrottle < 0) || (TRUE == l_parkingActive));
+	uint32 l_periodMs;
+
+	if(l_parking != l_lastParking)
+	{
+		l_lastParking = l_parking;
+		App_parkingFeedback(l_parking);
+	}
+
+	if((0 != l_nearest) && (l_nearest <= APP_STOP_MARGIN_MM))
+	{
+		l_periodMs = APP_BEEP_ON_MS;	/* Continuous */
+	}
+	else if((0 != l_nearest) && (l_nearest < (APP_WARNING_DISTANCE * 10u)))
+	{
+		/* Proportional to the distance between the stop margin and the warning distance */
+		l_periodMs = APP_BEEP_NEAR_MS + (((uint32)(APP_BEEP_FAR_MS - APP_BEEP_NEAR_MS) * (l_nearest - APP_STOP_MARGIN_MM)) /
+				((APP_WARNING_DISTANCE * 10u) - APP_STOP_MARGIN_MM));
+	}
+	else if(TRUE == g_warning)
+	{
+		l_periodMs = APP_BEEP_FAR_MS;
+	}
+	else
+	{
+		l_periodMs = 0;
+	}
+
+	if(0 == l_periodMs)
+	{
+		Pattern_stop(PATTERN_BUZZER);
+		Pattern_stop(PATTERN_RED);
+	}
+	else
+	{
+		Pattern_cadence(PATTERN_BUZZER, APP_BEEP_ON_MS / PATTERN_TICK_MS, (uint8)(l_periodMs / PATTERN_TICK_MS));
+		Pattern_cadence(PATTERN_RED, APP_BEEP_ON_MS / PATTERN_TICK_MS, (uint8)(l_periodMs / PATTERN_TICK_MS));
+	}
+}
 
-	LCD_clearScreen();
+/*
+ * Description :
+ * 	- Closing speed for the collision decision: the measured one, or the speed commanded by the
+ * 	  throttle when higher (the estimate lags a car that is speeding up).
+ */
+static sint16 App_closingSpeed(sint16 measured, sint8 throttle)
+{
+	sint16 l_commanded = (sint16)(((sint32)((throttle < 0) ? -throttle : throttle) * g_speedMM_S) / 100);
 
-	_delay_ms(500);
+	return (l_commanded > measured) ? l_commanded : measured;
+}
 
-	readDistance();
+/*
+ * Description :
+ * 	- Time to collision decision for one direction.
+ * 	- The time is taken to the stop margin: (distance - margin) / closing speed.
+ */
+static App_ZoneType App_collisionZone(uint16 distanceMM, sint16 closingSpeed)
+{
+	uint32 l_ahead;
 
-	Forward();
+	if(distanceMM <= APP_STOP_MARGIN_MM)
+	{
+		return APP_ZONE_BRAKE;
+	}
 
-	while (30 <= g_distanceRight)
+	/* Compared as distance * 1000 against speed * time, no division */
+	l_ahead = (uint32)(distanceMM - APP_STOP_MARGIN_MM) * 1000u;
+	if(closingSpeed > 0)
 	{
-		readDistance();
-		collisionAvoidance();
+		if(l_ahead <= (uint32)closingSpeed * APP_TTC_BRAKE_MS)
+		{
+			return APP_ZONE_BRAKE;
+		}
+		if(l_ahead <= (uint32)closingSpeed * APP_TTC_WARNING_MS)
+		{
+			return APP_ZONE_WARNING;
+		}
+	}
+
+	return (distanceMM <= (APP_WARNING_DISTANCE * 10u)) ? APP_ZONE_WARNING : APP_ZONE_CLEAR;
+}
+
+void collisionAvoidance(void)
+{
+	static uint32 l_brakeStart = 0;
+	App_ZoneType l_zone;
+	sint8 l_throttle;
 
-		_delay_ms(100);
+	if(TRUE == g_braking)
+	{
+		/* Hold the reverse pulse, then stop or drive the command received meanwhile */
+		if((Timebase_millis() - l_brakeStart) >= APP_BRAKE_PULSE_MS)
+		{
+			g_braking = FALSE;
+			if(TRUE == g_commandPending)
+			{
+				g_commandPending = FALSE;
+				App_drive(g_requestedThrottle, g_turn);	/* Blocked again if still towards the obstacle */
+			}
+			else
+			{
+				g_halted = TRUE;
+				Stop();
+			}
+		}
+		return;
+	}
 
-		l_counter++;
-		if (5 < l_counter)
+	/*
+	 * The checked side follows the commanded direction, a spin in place checks none. Once halted the
+	 * car only brakes again on the measured closing speed, it is not pushed away from the obstacle.
+	 */
+	l_throttle = (TRUE == g_halted) ? 0 : g_throttle;
+	if(g_throttle > 0)
+	{
+		l_zone = App_collisionZone(g_distanceForwardMM, App_closingSpeed(g_closingForward.speed, l_throttle));
+		if(APP_ZONE_BRAKE == l_zone)
 		{
-			LCD_displayStringRowColumn(1, 0, "SPACE Available");
-
-			Stop();
-
-			_delay_ms(500);
-
-			Left_Forward_Parking(100);
-			_delay_ms(500);
-			Backward();
-			_delay_ms(100);
-			Left_Forward_Parking(100);
-			_delay_ms(500);
-			Backward();
-			_delay_ms(100);
-			Left_Forward_Parking(100);
-			_delay_ms(500);
-
-			Stop();
-			_delay_ms(500);
-
-			Backward();
-			_delay_ms(900);
-
-			Stop();
-
-			_delay_ms(500);
-
-			Right_Forward_Parking(100);
-			_delay_ms(700);
-			Backward();
-			_delay_ms(500);
-			Right_Forward_Parking(100);
-			_delay_ms(700);
-			Backward();
-			_delay_ms(500);
-			Right_Forward_Parking(100);
-			_delay_ms(700);
-			Backward();
-			_delay_ms(200);
-			Right_Forward_Parking(100);
-			_delay_ms(700);
-			Backward();
-			_delay_ms(200);
-			Right_Forward_Parking(100);
-			_delay_ms(200);
-			Stop();
-			_delay_ms(700);
-			_delay_ms(700);
-
-			break;
+			Motion_set(-g_speedMM_S, 0);
+			l_brakeStart = Timebase_millis();
+			g_braking = TRUE;
 		}
 	}
-	if (5 > l_counter)
+	else if(g_throttle < 0)
 	{
-		LCD_displayStringRowColumn(1, 0, "NO SPACE");
+		l_zone = App_collisionZone(g_distanceBackwardMM, App_closingSpeed(g_closingBackward.speed, l_throttle));
+		if(APP_ZONE_BRAKE == l_zone)
+		{
+			Motion_set(g_speedMM_S, 0);
+			l_brakeStart = Timebase_millis();
+			g_braking = TRUE;
+		}
+	}
+	else
+	{
+		l_zone = APP_ZONE_CLEAR;
 	}
 
-	Stop();
+	g_warning = (APP_ZONE_WARNING == l_zone) ? TRUE : FALSE;
 }
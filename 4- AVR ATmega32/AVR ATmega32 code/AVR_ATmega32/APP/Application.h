@@ -12,6 +12,15 @@
 #include "../MCAL/EXT_INT/EXT_INT.h"	/* Include external interrupt driver */
 #include "../MCAL/UART/UART.h"
 
+/*********************** SERVICE Layer includes ***********************/
+#include "../SERVICE/TIMEBASE/timebase.h"			/* Shared system time */
+#include "../SERVICE/SCHEDULER/scheduler.h"			/* Cooperative task scheduler */
+#include "../SERVICE/TELEMETRY/telemetry.h"			/* Binary telemetry frames */
+#include "../SERVICE/PARKING/parking.h"				/* Auto-parking planner */
+#include "../SERVICE/MOTION/motion.h"				/* Differential drive commands */
+#include "../SERVICE/PATTERN/pattern.h"				/* Buzzer and LEDs patterns */
+#include "../SERVICE/TRACE/trace.h"					/* Interrupts and tasks event trace */
+
 /*********************** HAL Layer includes  ***********************/
 #include "../HAL/Ultrasonic/ultrasonic_sensor.h"	/* ultrasonic sensor driver */
 #include "../HAL/BUZZER/buzzer.h"					/* Buzzer sensor driver */
@@ -32,6 +41,75 @@ UART_ConfigType config = {
 	.parity   = 0	,
 	.stopBits = 1 	};
 
+/*
+ * Commands received over UART:
+ * 	- One character: 'F' forward, 'B' backward, 'S' stop, 'R'/'L' turn right/left forward,
+ * 	  'A'/'H' turn right/left backward, 'P' auto-parking, '1'/'2'/'3' driving speed.
+ * 	- 'T' sends the event trace buffer (with TRACE_ENABLE, ignored without), the drive state is not changed.
+ * 	- Joystick packet of 4 bytes: 'J', x, y, check. x (turn, positive right) and y (throttle,
+ * 	  positive forward) are signed bytes from -100 to 100, check is 'J' ^ x ^ y. The phone sends
+ * 	  it at 20Hz or more while the joystick is held, every packet sets a new target the ramp reaches
+ * 	  from the current duties. The car stops when no packet came for APP_JOYSTICK_TIMEOUT_MS.
+ * 	  A packet failing its check is dropped and the parser resyncs on the next 'J'. While the
+ * 	  stream runs the bytes out of a packet are dropped, except 'S', so the payload of a misaligned
+ * 	  packet is never run as a command.
+ * 	- Any other byte (line endings, noise) is ignored.
+ * 	- A command received during a brake pulse is applied at its end.
+ * Both drive through Motion_set: throttle 100 is the driving speed, turn 100 with throttle 0 spins
+ * the car in place with the wheels at half the driving speed. The turn characters are throttle 50
+ * and turn 100, the inner wheel stops.
+ */
+#define APP_JOYSTICK_HEADER		('J')
+#define APP_JOYSTICK_PACKET_LENGTH	(4u)
+#define APP_JOYSTICK_MAX		(100)
+#define APP_JOYSTICK_TIMEOUT_MS	(250u)		/* Five packets lost at 20Hz */
+#define APP_TRACE_DUMP_COMMAND	('T')
+
+/*
+ * Collision avoidance, time to collision based:
+ * 	- The closing speed is estimated from consecutive time stamped forward/backward samples. It lags
+ * 	  the car by a sensor cycle or two, so the commanded speed is taken when it is higher: a car
+ * 	  starting again towards a near obstacle is blocked (or braked) before it picks up speed.
+ * 	- Braking starts once the obstacle would be reached within APP_TTC_BRAKE_MS (measured to the
+ * 	  stop margin), so a fast car brakes earlier and a slow one later. Closer than the margin it
+ * 	  always brakes, inside the warning distance or APP_TTC_WARNING_MS it only beeps.
+ */
+#define APP_WARNING_DISTANCE	(40u)		/* Centimetres */
+#define APP_STOP_MARGIN_MM		(120u)		/* Distance kept to the obstacle */
+#define APP_TTC_BRAKE_MS		(250u)
+#define APP_TTC_WARNING_MS		(1000u)
+#define APP_SPEED_LIMIT_MM_S	(3000)		/* Faster estimates are echo glitches and are dropped */
+#define APP_BRAKE_PULSE_MS		(100u)
+
+/*
+ * Driver feedback, parking sensor style, played by the pattern engine:
+ * 	- The nearest obstacle on the side the car is driven to (both sides while parking) sets the
+ * 	  beep cadence of the buzzer and the red LED: a beep of APP_BEEP_ON_MS every APP_BEEP_FAR_MS at
+ * 	  the warning distance, down to every APP_BEEP_NEAR_MS at the stop margin, continuous inside it.
+ * 	  A time to collision warning further away beeps every APP_BEEP_FAR_MS.
+ * 	- Blue LED: blinks while parking, stays on when parked (centered or not, the LCD tells them
+ * 	  apart), flashes three times when no slot was found or the maneuver failed or was aborted.
+ * 	- Green LED: on while the motion is blocked by a presence.
+ */
+#define APP_FEEDBACK_PERIOD_MS	(50u)
+#define APP_BEEP_ON_MS			(50u)
+#define APP_BEEP_FAR_MS			(800u)
+#define APP_BEEP_NEAR_MS		(150u)
+
+/*
+ * Telemetry period: a CSV line every 100ms, or a 16 bytes binary frame every 20ms
+ * (800 bytes/s, inside the 960 bytes/s of the 9600 baud link).
+ */
+#if (TELEMETRY_MODE == TELEMETRY_MODE_BINARY)
+#define APP_TELEMETRY_PERIOD_MS	(20u)
+#else
+#define APP_TELEMETRY_PERIOD_MS	(100u)
+#endif
+
+/* LCD content: rows of 16 characters refreshed every APP_LCD_PERIOD_MS into the LCD shadow buffer */
+#define APP_LCD_LINE_LENGTH		(16u)
+#define APP_LCD_PERIOD_MS		(50u)
+
 /*********************** Functions Prototypes ***********************/
 
 /*
@@ -40,22 +118,59 @@ UART_ConfigType config = {
  */
 uint8 motorSpeed(uint8 speed);
 
-/*
- * Description :
- * 	- Function to handle the auto-parking functionality.
- * 	- This function controls the car's movement to park automatically.
- */
-void autoParking(void);
-
 /*
  * Description :
  * 	- Function to read the distance from the ultrasonic sensor.
  * 	- This function retrieves and processes the distance measurement.
+ * 	- Non-blocking, the globals are updated once per completed sensors cycle.
  */
 void readDistance(void);
 
 void App_Receive(uint8 recievedMSG);
 
+/*
+ * Description :
+ * 	- Drive from a joystick packet, turn and throttle from -APP_JOYSTICK_MAX to APP_JOYSTICK_MAX.
+ * 	- The first packet takes the car back from the parking planner, the next ones only move the targets.
+ */
+void App_joystick(sint8 turn, sint8 throttle);
+
+/*
+ * Description :
+ * 	- Command task, executes the bytes received over UART outside of the interrupt.
+ * 	- Assembles the joystick packets and stops the car when they stop coming.
+ */
+void App_commandTask(void);
+
+/*
+ * Description :
+ * 	- Collision avoidance task, brakes with a short reverse pulse when an obstacle is too close.
+ * 	- Non-blocking, the brake pulse is ended by a later run of the task.
+ */
 void collisionAvoidance(void);
 
+/*
+ * Description : Telemetry task, sends the latest distances over UART as one CSV line or one binary frame.
+ */
+void App_telemetryTask(void);
+
+/*
+ * Description : LCD task, writes the distances (first row) and the parking status (second row) to the LCD shadow buffer.
+ */
+void App_lcdTask(void);
+
+/*
+ * Description :
+ * 	- PIR callback, called by PIR_task when the debounced presence of a sensor changes.
+ * 	- While a sensor sees someone near the car, the car is stopped, parking is aborted and the drive
+ * 	  commands are dropped (no brake pulse either). Nothing resumes when the presence ends, the next
+ * 	  command drives again.
+ */
+void App_presence(PIR_Sensor sensor, uint8 present);
+
+/*
+ * Description : Feedback task, sets the buzzer and LEDs patterns from the obstacles and the parking state.
+ */
+void App_feedbackTask(void);
+
 #endif /* APP_APPLICATION_H_ */
@@ -4,13 +4,16 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../HAL/MOTOR/motor.c 
+../HAL/MOTOR/motor.c \
+../HAL/MOTOR/speed_pi.c 
 
 OBJS += \
-./HAL/MOTOR/motor.o 
+./HAL/MOTOR/motor.o \
+./HAL/MOTOR/speed_pi.o 
 
 C_DEPS += \
-./HAL/MOTOR/motor.d 
+./HAL/MOTOR/motor.d \
+./HAL/MOTOR/speed_pi.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -4,13 +4,16 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../HAL/Ultrasonic/ultrasonic_sensor.c 
+../HAL/Ultrasonic/ultrasonic_sensor.c \
+../HAL/Ultrasonic/ultrasonic_filter.c 
 
 OBJS += \
-./HAL/Ultrasonic/ultrasonic_sensor.o 
+./HAL/Ultrasonic/ultrasonic_sensor.o \
+./HAL/Ultrasonic/ultrasonic_filter.o 
 
 C_DEPS += \
-./HAL/Ultrasonic/ultrasonic_sensor.d 
+./HAL/Ultrasonic/ultrasonic_sensor.d \
+./HAL/Ultrasonic/ultrasonic_filter.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
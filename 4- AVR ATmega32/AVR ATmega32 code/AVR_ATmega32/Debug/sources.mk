@@ -23,6 +23,7 @@ SUBDIRS := \
 APP \
 HAL/3\ Leds \
 HAL/BUZZER \
+HAL/ENCODER \
 HAL/LCD \
 HAL/MOTOR \
 HAL/PIR \
@@ -33,4 +34,11 @@ MCAL/ICU \
 MCAL/PWM \
 MCAL/TIMER \
 MCAL/UART \
+SERVICE/TIMEBASE \
+SERVICE/SCHEDULER \
+SERVICE/TELEMETRY \
+SERVICE/PARKING \
+SERVICE/MOTION \
+SERVICE/PATTERN \
+SERVICE/TRACE \
 
@@ -19,11 +19,11 @@ void Buzzer_init(void)
 void Buzzer_on(void)
 {
     /* Activate the buzzer */
-    GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_HIGH);
+    GPIO_SET_PIN(BUZZER_PORT_ID, BUZZER_PIN_ID);
 }
 
 void Buzzer_off(void)
 {
     /* Deactivate the buzzer */
-    GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+    GPIO_CLEAR_PIN(BUZZER_PORT_ID, BUZZER_PIN_ID);
 }
@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Module       : Wheel Encoder
+ * File Name    : encoder.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the wheel speed encoders driver
+ *******************************************************************************/
+#include "encoder.h"
+#include "../../MCAL/EXT_INT/EXT_INT.h"
+#include "../../MCAL/ICU/icu.h"
+#include "../../SERVICE/TIMEBASE/timebase.h"	/* Shared free running Timer1 */
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Definitions                                       *
+ *******************************************************************************/
+#define ENCODER_WHEELS_NUM			(2u)
+#define ENCODER_RPM_US				(60000000u / ENCODER_PULSES_PER_REV)	/* rpm = ENCODER_RPM_US / period */
+
+/* Edge history of one wheel */
+typedef struct
+{
+	uint32 lastEdge;		/* Time of the last rising edge in microseconds */
+	uint32 period;			/* Time between the last two rising edges in microseconds */
+	uint16 count;			/* Rising edges counted */
+} Encoder_StateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static volatile Encoder_StateType g_wheels[ENCODER_WHEELS_NUM];
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Record a rising edge of a wheel, edges closer than ENCODER_MIN_PERIOD_US are dropped.
+ */
+static void Encoder_edge(Encoder_Wheel wheel, uint32 time)
+{
+	uint32 l_period = time - g_wheels[wheel].lastEdge;
+
+	if(l_period < ENCODER_MIN_PERIOD_US)
+	{
+		return;
+	}
+	/* A first edge after a stop only restarts the history, its period would be the stop time */
+	g_wheels[wheel].period = (l_period < ENCODER_STOP_TIMEOUT_US) ? l_period : 0;
+	g_wheels[wheel].lastEdge = time;
+	g_wheels[wheel].count++;
+}
+
+static void Encoder_edgeProcessing_ICU(void)
+{
+	/* The capture happened (TCNT1 - ICR1) ticks before now */
+	uint16 l_age = Timebase_getTicks() - ICU_getInputCaptureValue();
+
+	Encoder_edge(ENCODER_RIGHT, Timebase_micros() - (l_age >> TIMEBASE_TICK_SHIFT));
+}
+
+static void Encoder_edgeProcessing_INT2(void)
+{
+	Encoder_edge(ENCODER_LEFT, Timebase_micros());
+}
+
+void Encoder_init(void)
+{
+	EXT_INT_ConfigType EXT_INT_Configrations = {INT_2, RISING_EDGE_INT2};
+
+	uint8 i;
+
+	Timebase_init();
+	for(i = 0; i < ENCODER_WHEELS_NUM; i++)
+	{
+		/* As if the last edge was a stop ago, the first edge only starts the history */
+		g_wheels[i].lastEdge = Timebase_micros() - ENCODER_STOP_TIMEOUT_US;
+	}
+
+	GPIO_setupPinDirection(ENCODER_RIGHT_PORT_ID, ENCODER_RIGHT_PIN_ID, PIN_INPUT);
+	GPIO_setupPinDirection(ENCODER_LEFT_PORT_ID, ENCODER_LEFT_PIN_ID, PIN_INPUT);
+
+	/* Capture on the running timebase without resetting it */
+	ICU_setCallBack(Encoder_edgeProcessing_ICU);
+	ICU_enable(RAISING);
+
+	external_interrupt_setCallBack(Encoder_edgeProcessing_INT2, INT_2);
+	external_interrupt_init(&EXT_INT_Configrations);
+}
+
+uint16 Encoder_getRpm(Encoder_Wheel wheel)
+{
+	uint8 l_sreg = SREG;
+	uint32 l_lastEdge;
+	uint32 l_period;
+	uint32 l_since;
+
+	cli();		/* The edge history is written from interrupts, copy it atomically */
+	l_lastEdge = g_wheels[wheel].lastEdge;
+	l_period = g_wheels[wheel].period;
+	SREG = l_sreg;
+
+	l_since = Timebase_micros() - l_lastEdge;
+	if((0 == l_period) || (l_since >= ENCODER_STOP_TIMEOUT_US))
+	{
+		return 0;
+	}
+
+	/* Slowing down: the next edge is already later than the last period */
+	if(l_since > l_period)
+	{
+		l_period = l_since;
+	}
+	return (uint16)(ENCODER_RPM_US / l_period);
+}
+
+uint16 Encoder_getCount(Encoder_Wheel wheel)
+{
+	uint8 l_sreg = SREG;
+	uint16 l_count;
+
+	cli();
+	l_count = g_wheels[wheel].count;
+	SREG = l_sreg;
+
+	return l_count;
+}
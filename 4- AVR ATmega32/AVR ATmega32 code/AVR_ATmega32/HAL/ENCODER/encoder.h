@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Module       : Wheel Encoder
+ * File Name    : encoder.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the wheel speed encoders driver
+ *******************************************************************************/
+#ifndef HAL_ENCODER_H_
+#define HAL_ENCODER_H_
+
+#include "../../MCAL/GPIO/gpio.h"  	/* Include GPIO driver for the pin ids */
+#include "../../LIB/std_types.h"  	/* Include standard types */
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * One slotted disc encoder per wheel, the rising edges are time stamped on the shared timebase:
+ * 	- Right wheel (motor 1) on ICP1/PD6, the edge time is latched by hardware in ICR1.
+ * 	- Left wheel (motor 2) on INT2/PB2, the edge time is read in the interrupt.
+ * The speed comes from the period between the last two edges, or from the time since the last
+ * edge when the wheel slows down, so a stopping wheel is seen without waiting for the next slot.
+ * 20 slots: 294rpm (full duty) gives an edge every 10ms, 30rpm every 100ms.
+ */
+#define ENCODER_RIGHT_PORT_ID		PORTD_ID
+#define ENCODER_RIGHT_PIN_ID		PIN6_ID		/* ICP1 */
+#define ENCODER_LEFT_PORT_ID		PORTB_ID
+#define ENCODER_LEFT_PIN_ID			PIN2_ID		/* INT2 */
+
+#define ENCODER_PULSES_PER_REV		(20u)
+#define ENCODER_MIN_PERIOD_US		(1000u)		/* Shorter periods are contact bounce (3000rpm) */
+#define ENCODER_STOP_TIMEOUT_US		(200000u)	/* No edge for this long: the wheel is stopped (15rpm) */
+
+typedef enum {
+	ENCODER_RIGHT, ENCODER_LEFT		/* Same order as the motors */
+}Encoder_Wheel;
+
+/*******************************************************************************
+ *                       Functions Prototypes                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Set up both encoder inputs and start time stamping their rising edges.
+ * 	- Starts the timebase if no other driver did.
+ */
+void Encoder_init(void);
+
+/*
+ * Description :
+ * 	- Return the speed of a wheel, non-blocking.
+ * Returns     :
+ * 	- The wheel speed in rpm, 0 when stopped. The encoder has a single channel, the sign
+ * 	  is the commanded direction.
+ */
+uint16 Encoder_getRpm(Encoder_Wheel wheel);
+
+/*
+ * Description :
+ * 	- Return the number of slots counted on a wheel since Encoder_init (wraps at 16 bits).
+ */
+uint16 Encoder_getCount(Encoder_Wheel wheel);
+
+#endif /* HAL_ENCODER_H_ */
@@ -11,15 +11,128 @@
 #include "lcd.h"  /* Include LCD header file */
 #include "../../MCAL/GPIO/gpio.h"  /* Include GPIO driver for pin control */
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LCD_ADDRESS_UNKNOWN            0xFF  /* The display cursor position is not known */
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static char g_shadow[LCD_ROWS][LCD_COLS];        /* Characters the application wants displayed */
+static uint16 g_dirty[LCD_ROWS];                 /* Cells not sent yet, one bit per column */
+static uint8 g_address = LCD_ADDRESS_UNKNOWN;    /* DDRAM address of the display cursor */
+static uint8 g_row = 0;                          /* Row the writer is sending */
+#if (LCD_DATA_BITS_MODE == 4)
+static uint8 g_pendingByte;                      /* Byte whose lower nibble is still to send */
+static uint8 g_pendingRs;                        /* Its RS level */
+static uint8 g_lowPending = FALSE;
+#endif
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
 
+/*
+ * Description :
+ * Latch one bus transfer: the lower nibble of value in 4-bit mode, the whole value in 8-bit mode.
+ * Parameters  :
+ * - rs: LOGIC_LOW for an instruction, LOGIC_HIGH for data.
+ * - value: The bits to put on the data pins.
+ */
+static void LCD_writeBus(uint8 rs, uint8 value)
+{
+    GPIO_WRITE_PIN(LCD_RS_PORT_ID, LCD_RS_PIN_ID, rs);  /* RS set before E (Tas = 40ns) */
+    GPIO_SET_PIN(LCD_E_PORT_ID, LCD_E_PIN_ID);  /* Enable LCD (E = 1) */
+
+#if (LCD_DATA_BITS_MODE == 4)
+    GPIO_WRITE_PIN(LCD_DATA_PORT_ID, LCD_DB4_PIN_ID, GET_BIT(value, 0));
+    GPIO_WRITE_PIN(LCD_DATA_PORT_ID, LCD_DB5_PIN_ID, GET_BIT(value, 1));
+    GPIO_WRITE_PIN(LCD_DATA_PORT_ID, LCD_DB6_PIN_ID, GET_BIT(value, 2));
+    GPIO_WRITE_PIN(LCD_DATA_PORT_ID, LCD_DB7_PIN_ID, GET_BIT(value, 3));
+#elif (LCD_DATA_BITS_MODE == 8)
+    GPIO_PORT_REG(LCD_DATA_PORT_ID) = value;  /* Output the value to the data bus (D0-D7) */
+#endif
+
+    _delay_us(LCD_ENABLE_PULSE_US);  /* E pulse width (PWEH = 230ns) and data setup (Tdsw = 80ns) */
+    GPIO_CLEAR_PIN(LCD_E_PORT_ID, LCD_E_PIN_ID);  /* Disable LCD (E = 0), data latched */
+    _delay_us(LCD_ENABLE_PULSE_US);  /* Hold (Th = 10ns) and E cycle time (TcycE = 500ns) */
+}
+
+/*
+ * Description :
+ * Finish a byte the writer has started, before a blocking transfer uses the bus.
+ */
+static void LCD_flushWriter(void)
+{
+#if (LCD_DATA_BITS_MODE == 4)
+    if (g_lowPending == TRUE)
+    {
+        LCD_writeBus(g_pendingRs, g_pendingByte & 0x0F);
+        g_lowPending = FALSE;
+        _delay_us(LCD_EXECUTION_US);
+    }
+#endif
+}
+
+/*
+ * Description :
+ * Send a whole byte and wait for its execution.
+ * Parameters  :
+ * - rs: LOGIC_LOW for an instruction, LOGIC_HIGH for data.
+ * - value: The byte to be sent.
+ */
+static void LCD_sendByte(uint8 rs, uint8 value)
+{
+    LCD_flushWriter();
+
+#if (LCD_DATA_BITS_MODE == 4)
+    LCD_writeBus(rs, value >> 4);  /* Higher nibble first */
+    LCD_writeBus(rs, value & 0x0F);
+#elif (LCD_DATA_BITS_MODE == 8)
+    LCD_writeBus(rs, value);
+#endif
+
+    _delay_us(LCD_EXECUTION_US);
+}
+
+/*
+ * Description :
+ * Calculate the DDRAM address of a cell.
+ * Parameters  :
+ * - row: The row number (0 to 3).
+ * - col: The column number (0 to 15).
+ */
+static uint8 LCD_address(uint8 row, uint8 col)
+{
+    uint8 lcd_memory_address = col;
+
+    switch (row)
+    {
+    case 1:
+        lcd_memory_address = col + 0x40;
+        break;
+    case 2:
+        lcd_memory_address = col + 0x10;
+        break;
+    case 3:
+        lcd_memory_address = col + 0x50;
+        break;
+    default:
+        break;
+    }
+
+    return lcd_memory_address;
+}
+
 /*
  * Description :
  * Initialize the LCD:
  * 1. Setup the LCD pins directions using the GPIO driver.
  * 2. Setup the LCD Data Mode (4-bits or 8-bits).
+ * 3. Clear the display and the shadow buffer.
  */
 void LCD_init(void)
 {
@@ -36,9 +149,15 @@ void LCD_init(void)
     GPIO_setupPinDirection(LCD_DATA_PORT_ID, LCD_DB6_PIN_ID, PIN_OUTPUT);
     GPIO_setupPinDirection(LCD_DATA_PORT_ID, LCD_DB7_PIN_ID, PIN_OUTPUT);
 
-    /* Send initialization commands for 4-bit mode */
-    LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
-    LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
+    /* Initialization by instruction: 3 times "8-bit mode" then "4-bit mode", one nibble each */
+    LCD_writeBus(LOGIC_LOW, LCD_TWO_LINES_FOUR_BITS_MODE_INIT1 >> 4);
+    _delay_ms(5);  /* > 4.1ms */
+    LCD_writeBus(LOGIC_LOW, LCD_TWO_LINES_FOUR_BITS_MODE_INIT1 & 0x0F);
+    _delay_us(150);  /* > 100us */
+    LCD_writeBus(LOGIC_LOW, LCD_TWO_LINES_FOUR_BITS_MODE_INIT2 >> 4);
+    _delay_us(LCD_EXECUTION_US);
+    LCD_writeBus(LOGIC_LOW, LCD_TWO_LINES_FOUR_BITS_MODE_INIT2 & 0x0F);
+    _delay_us(LCD_EXECUTION_US);
 
     /* Set 2-line LCD, 4-bit mode, and 5x7 dot display */
     LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE);
@@ -52,7 +171,7 @@ void LCD_init(void)
 #endif
 
     LCD_sendCommand(LCD_CURSOR_OFF);  /* Turn cursor off */
-    LCD_sendCommand(LCD_CLEAR_COMMAND);  /* Clear LCD at the beginning */
+    LCD_clearScreen();  /* Clear LCD at the beginning */
 }
 
 /*
@@ -63,41 +182,17 @@ void LCD_init(void)
  */
 void LCD_sendCommand(uint8 command)
 {
-    GPIO_writePin(LCD_RS_PORT_ID, LCD_RS_PIN_ID, LOGIC_LOW);  /* Instruction Mode (RS = 0) */
-    _delay_ms(1);  /* Delay for processing (Tas = 50ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);  /* Enable LCD (E = 1) */
-    _delay_ms(1);  /* Delay for processing (Tpw - Tdws = 190ns) */
+    LCD_sendByte(LOGIC_LOW, command);
 
-#if (LCD_DATA_BITS_MODE == 4)
-    /* Send the higher nibble of the command */
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB4_PIN_ID, GET_BIT(command, 4));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB5_PIN_ID, GET_BIT(command, 5));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB6_PIN_ID, GET_BIT(command, 6));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB7_PIN_ID, GET_BIT(command, 7));
-
-    _delay_ms(1);  /* Delay for processing (Tdsw = 100ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);  /* Disable LCD (E = 0) */
-    _delay_ms(1);  /* Delay for processing (Th = 13ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);  /* Enable LCD (E = 1) */
-    _delay_ms(1);  /* Delay for processing (Tpw - Tdws = 190ns) */
-
-    /* Send the lower nibble of the command */
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB4_PIN_ID, GET_BIT(command, 0));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB5_PIN_ID, GET_BIT(command, 1));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB6_PIN_ID, GET_BIT(command, 2));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB7_PIN_ID, GET_BIT(command, 3));
-
-    _delay_ms(1);  /* Delay for processing (Tdsw = 100ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);  /* Disable LCD (E = 0) */
-    _delay_ms(1);  /* Delay for processing (Th = 13ns) */
-
-#elif (LCD_DATA_BITS_MODE == 8)
-    /* Send the entire command in 8-bit mode */
-    GPIO_writePort(LCD_DATA_PORT_ID, command);  /* Output the command to the data bus (D0-D7) */
-    _delay_ms(1);  /* Delay for processing (Tdsw = 100ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);  /* Disable LCD (E = 0) */
-    _delay_ms(1);  /* Delay for processing (Th = 13ns) */
-#endif
+    if (command & LCD_SET_CURSOR_LOCATION)
+    {
+        g_address = command & ~LCD_SET_CURSOR_LOCATION;  /* Keep track of the cursor for LCD_task */
+    }
+    else if ((command == LCD_CLEAR_COMMAND) || (command == LCD_GO_TO_HOME))
+    {
+        _delay_us(LCD_CLEAR_EXECUTION_US);  /* The slow instructions */
+        g_address = 0;
+    }
 }
 
 /*
@@ -108,41 +203,12 @@ void LCD_sendCommand(uint8 command)
  */
 void LCD_displayCharacter(uint8 data)
 {
-    GPIO_writePin(LCD_RS_PORT_ID, LCD_RS_PIN_ID, LOGIC_HIGH);  /* Data Mode (RS = 1) */
-    _delay_ms(1);  /* Delay for processing (Tas = 50ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);  /* Enable LCD (E = 1) */
-    _delay_ms(1);  /* Delay for processing (Tpw - Tdws = 190ns) */
+    LCD_sendByte(LOGIC_HIGH, data);
 
-#if (LCD_DATA_BITS_MODE == 4)
-    /* Send the higher nibble of the data */
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB4_PIN_ID, GET_BIT(data, 4));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB5_PIN_ID, GET_BIT(data, 5));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB6_PIN_ID, GET_BIT(data, 6));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB7_PIN_ID, GET_BIT(data, 7));
-
-    _delay_ms(1);  /* Delay for processing (Tdsw = 100ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);  /* Disable LCD (E = 0) */
-    _delay_ms(1);  /* Delay for processing (Th = 13ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);  /* Enable LCD (E = 1) */
-    _delay_ms(1);  /* Delay for processing (Tpw - Tdws = 190ns) */
-
-    /* Send the lower nibble of the data */
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB4_PIN_ID, GET_BIT(data, 0));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB5_PIN_ID, GET_BIT(data, 1));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB6_PIN_ID, GET_BIT(data, 2));
-    GPIO_writePin(LCD_DATA_PORT_ID, LCD_DB7_PIN_ID, GET_BIT(data, 3));
-
-    _delay_ms(1);  /* Delay for processing (Tdsw = 100ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);  /* Disable LCD (E = 0) */
-    _delay_ms(1);  /* Delay for processing (Th = 13ns) */
-
-#elif (LCD_DATA_BITS_MODE == 8)
-    /* Send the entire data in 8-bit mode */
-    GPIO_writePort(LCD_DATA_PORT_ID, data);  /* Output the data to the data bus (D0-D7) */
-    _delay_ms(1);  /* Delay for processing (Tdsw = 100ns) */
-    GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);  /* Disable LCD (E = 0) */
-    _delay_ms(1);  /* Delay for processing (Th = 13ns) */
-#endif
+    if (g_address != LCD_ADDRESS_UNKNOWN)
+    {
+        g_address++;  /* The cursor moves right after a data write */
+    }
 }
 
 /*
@@ -170,27 +236,8 @@ void LCD_displayString(const char *Str)
  */
 void LCD_moveCursor(uint8 row, uint8 col)
 {
-    uint8 lcd_memory_address;
-
-    /* Calculate the required address in the LCD DDRAM */
-    switch (row)
-    {
-    case 0:
-        lcd_memory_address = col;
-        break;
-    case 1:
-        lcd_memory_address = col + 0x40;
-        break;
-    case 2:
-        lcd_memory_address = col + 0x10;
-        break;
-    case 3:
-        lcd_memory_address = col + 0x50;
-        break;
-    }
-
-    /* Move the LCD cursor to this specific address */
-    LCD_sendCommand(lcd_memory_address | LCD_SET_CURSOR_LOCATION);
+    /* Move the LCD cursor to the required address in the LCD DDRAM */
+    LCD_sendCommand(LCD_address(row, col) | LCD_SET_CURSOR_LOCATION);
 }
 
 /*
@@ -222,9 +269,137 @@ void LCD_intgerToString(int data)
 
 /*
  * Description :
- * Clear the LCD screen.
+ * Clear the LCD screen, the shadow buffer is cleared too.
  */
 void LCD_clearScreen(void)
 {
+    uint8 row, col;
+
     LCD_sendCommand(LCD_CLEAR_COMMAND);  /* Send clear display command */
+
+    for (row = 0; row < LCD_ROWS; row++)
+    {
+        for (col = 0; col < LCD_COLS; col++)
+        {
+            g_shadow[row][col] = ' ';
+        }
+        g_dirty[row] = 0;
+    }
+}
+
+/*
+ * Description :
+ * Write a string into the shadow buffer at a specified row and column, only changed cells are marked.
+ * Parameters  :
+ * - row: The row number (0 or 1).
+ * - col: The column number (0 to 15).
+ * - Str: Pointer to the string to be written.
+ */
+void LCD_print(uint8 row, uint8 col, const char *Str)
+{
+    if (row >= LCD_ROWS)
+    {
+        return;
+    }
+
+    while ((*Str != '\0') && (col < LCD_COLS))
+    {
+        if (g_shadow[row][col] != *Str)
+        {
+            g_shadow[row][col] = *Str;
+            g_dirty[row] |= (uint16)1 << col;
+        }
+        Str++;
+        col++;
+    }
+}
+
+/*
+ * Description :
+ * Send the next nibble of the changed cells: a cursor move when the next cell is not where the
+ * display cursor is, then the character. Consecutive cells need no cursor move.
+ */
+void LCD_task(void)
+{
+    uint8 i;
+    uint8 col;
+    uint8 address;
+
+#if (LCD_DATA_BITS_MODE == 4)
+    if (g_lowPending == TRUE)
+    {
+        LCD_writeBus(g_pendingRs, g_pendingByte & 0x0F);  /* Second half of the byte started last call */
+        g_lowPending = FALSE;
+        return;
+    }
+#endif
+
+    /* Stay on the current row until it is sent, then look at the next ones */
+    for (i = 0; (i < LCD_ROWS) && (g_dirty[g_row] == 0); i++)
+    {
+        g_row = (g_row + 1) % LCD_ROWS;
+    }
+    if (g_dirty[g_row] == 0)
+    {
+        return;  /* The display shows the whole buffer */
+    }
+
+    for (col = 0; !(g_dirty[g_row] & ((uint16)1 << col)); col++)
+    {
+    }
+    address = LCD_address(g_row, col);
+
+#if (LCD_DATA_BITS_MODE == 4)
+    if (address != g_address)
+    {
+        g_pendingRs = LOGIC_LOW;
+        g_pendingByte = address | LCD_SET_CURSOR_LOCATION;
+        g_address = address;
+    }
+    else
+    {
+        g_pendingRs = LOGIC_HIGH;
+        g_pendingByte = g_shadow[g_row][col];
+        g_dirty[g_row] &= ~((uint16)1 << col);
+        g_address++;
+    }
+    LCD_writeBus(g_pendingRs, g_pendingByte >> 4);
+    g_lowPending = TRUE;
+#elif (LCD_DATA_BITS_MODE == 8)
+    if (address != g_address)
+    {
+        LCD_writeBus(LOGIC_LOW, address | LCD_SET_CURSOR_LOCATION);
+        g_address = address;
+    }
+    else
+    {
+        LCD_writeBus(LOGIC_HIGH, g_shadow[g_row][col]);
+        g_dirty[g_row] &= ~((uint16)1 << col);
+        g_address++;
+    }
+#endif
+}
+
+/*
+ * Description :
+ * Check whether the LCD shows the whole shadow buffer.
+ * Returns     : TRUE when no cell is waiting to be sent.
+ */
+uint8 LCD_isSynced(void)
+{
+    uint8 row;
+
+    for (row = 0; row < LCD_ROWS; row++)
+    {
+        if (g_dirty[row] != 0)
+        {
+            return FALSE;
+        }
+    }
+
+#if (LCD_DATA_BITS_MODE == 4)
+    return (g_lowPending == TRUE) ? FALSE : TRUE;
+#else
+    return TRUE;
+#endif
 }
@@ -22,6 +22,22 @@
 #error "Number of Data bits should be equal to 4 or 8"
 #endif
 
+/* Display geometry, the shadow buffer holds one character per cell */
+#define LCD_ROWS                       2
+#define LCD_COLS                       16
+
+#if (LCD_COLS > 16)
+#error "The dirty cells of a row are kept in 16 bits"
+#endif
+
+/* Timings from the HD44780 datasheet */
+#define LCD_ENABLE_PULSE_US            1     /* E high (PWEH >= 230ns, data setup tDSW >= 80ns) and E low time */
+#define LCD_EXECUTION_US               40    /* Execution of most instructions and data writes (37us) */
+#define LCD_CLEAR_EXECUTION_US         1600  /* Execution of clear display and return home (1.52ms) */
+
+/* Period the application calls LCD_task with, one nibble is sent per call */
+#define LCD_TASK_PERIOD_MS             1
+
 /* LCD HW Ports and Pins Ids */
 #define LCD_RS_PORT_ID                 PORTA_ID  /* Port for RS pin */
 #define LCD_RS_PIN_ID                  PIN1_ID   /* Pin for RS */
@@ -114,8 +130,37 @@ void LCD_intgerToString(int data);
 
 /*
  * Description :
- * Clear the LCD screen.
+ * Clear the LCD screen, the shadow buffer is cleared too.
  */
 void LCD_clearScreen(void);
 
+/*
+ * Description :
+ * Write a string into the shadow buffer at a specified row and column, nothing is sent here.
+ * Only the cells that changed are marked to be sent by LCD_task, the string is clipped at the
+ * end of the row.
+ * Parameters  :
+ * - row: The row number (0 or 1).
+ * - col: The column number (0 to 15).
+ * - Str: Pointer to the string to be written.
+ */
+void LCD_print(uint8 row, uint8 col, const char *Str);
+
+/*
+ * Description :
+ * Send the changed cells of the shadow buffer to the LCD, one nibble per call (one byte per call
+ * in 8-bit mode), so a call takes a few microseconds. The call period covers the execution time
+ * of the previous byte. Called every LCD_TASK_PERIOD_MS.
+ * The blocking functions above write the LCD directly and are meant for the initialization,
+ * cells they write are not tracked by the shadow buffer.
+ */
+void LCD_task(void);
+
+/*
+ * Description :
+ * Check whether the LCD shows the whole shadow buffer.
+ * Returns     : TRUE when no cell is waiting to be sent.
+ */
+uint8 LCD_isSynced(void);
+
 #endif /* LCD_H_ */
@@ -9,13 +9,34 @@
 #include "motor.h"  /* Include Motor header file */
 #include "../../MCAL/GPIO/gpio.h"  /* Include GPIO driver for pin control */
 #include "../../MCAL/PWM/pwm.h"  /* Include PWM driver for speed control */
-#include <util/delay.h>  /* Include delay utility for timing */
+#if (MOTOR_SPEED_CONTROL == TRUE)
+#include "../ENCODER/encoder.h"  /* Measured wheel speeds */
+#include "../Ultrasonic/ultrasonic_sensor.h"  /* The echo capture must leave ICP1 and INT2 to the encoders */
+
+#if (ULTRASONIC_ECHO_CAPTURE == ULTRASONIC_CAPTURE_ICU)
+#error "The right wheel encoder needs ICP1, use the EXT_INT echo capture or disable MOTOR_SPEED_CONTROL"
+#endif
+#endif
+#include <avr/io.h>  /* To use the SREG register */
+#include <avr/interrupt.h>  /* For cli() */
 
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
 
-uint8 max_Speed = 0;  /* Variable to store the maximum speed of the motor */
+static volatile sint8 g_targetDuty[2] = {0, 0};   /* Target signed duty of motor 1 and motor 2 */
+static volatile sint8 g_currentDuty[2] = {0, 0};  /* Signed duty applied to motor 1 and motor 2 */
+
+#if (MOTOR_SPEED_CONTROL == TRUE)
+static SpeedPi_Type g_speedPi[2];  /* Speed controller of motor 1 and motor 2, used by DcMotor_speedTick */
+static DcMotor_State g_speedDirection[2] = {STOP, STOP};  /* Last direction each wheel was driven in */
+static uint8 g_reversing[2] = {FALSE, FALSE};  /* Wheel still turning the old way after a reversal */
+#endif
+
+/* H-bridge inputs of each motor on MOTOR_PORT_CONNECTION */
+#define MOTOR1_PINS_MASK    ((1 << PIN_INT1) | (1 << PIN_INT2))
+#define MOTOR2_PINS_MASK    ((1 << PIN_INT3) | (1 << PIN_INT4))
+#define MOTOR_PINS_MASK     (MOTOR1_PINS_MASK | MOTOR2_PINS_MASK)
 
 /*******************************************************************************
  *                       Static Functions Definitions                          *
@@ -23,13 +44,49 @@ uint8 max_Speed = 0;  /* Variable to store the maximum speed of the motor */
 
 /*
  * Description :
- * Static function to handle the maximum speed of the motor.
+ * Static function to get the H-bridge input levels of one motor.
  * Parameters  :
- * - speed: The maximum speed to be set.
+ * - state: The motor state (STOP, CW, CCW).
+ * - pinA: Input high for CW.
+ * - pinB: Input high for CCW.
+ * Returns     : The levels of both inputs, one bit per pin of MOTOR_PORT_CONNECTION.
  */
-static void Handel_Max_Speed(uint8 speed)
+static uint8 DcMotor_pinsOf(DcMotor_State state, uint8 pinA, uint8 pinB)
 {
-    max_Speed = speed;
+    uint8 l_pins = 0;
+
+    if (CW == state)
+    {
+        l_pins = (1 << pinA);
+    }
+    else if (CCW == state)
+    {
+        l_pins = (1 << pinB);
+    }
+
+    return l_pins;
+}
+
+/*
+ * Description :
+ * Static function to get the state of a signed duty.
+ * Parameters  :
+ * - duty: Signed duty (-100 to 100), positive is CCW (forward).
+ */
+static DcMotor_State DcMotor_stateOf(sint8 duty)
+{
+    return (duty > 0) ? CCW : ((duty < 0) ? CW : STOP);
+}
+
+/*
+ * Description :
+ * Static function to get the speed of a signed duty.
+ * Parameters  :
+ * - duty: Signed duty (-100 to 100).
+ */
+static uint8 DcMotor_speedOf(sint8 duty)
+{
+    return (duty < 0) ? (uint8)(-duty) : (uint8)duty;
 }
 
 /*******************************************************************************
@@ -40,13 +97,11 @@ static void Handel_Max_Speed(uint8 speed)
  * Description :
  * Function to initialize the DC motor.
  * This function sets up the necessary pin directions and stops the motor initially.
- * Parameters  :
- * - MAXSPEED: The maximum speed of the motor (0 to 100).
  */
-void DcMotor_Init(uint8 MAXSPEED)
+void DcMotor_Init(void)
 {
-    /* Set the maximum speed */
-    Handel_Max_Speed(MAXSPEED);
+    /* Start both PWM channels once at 0% duty, the ramp only changes the duty afterwards */
+    Timer_Configuration configrations = {NON_INVERTING, F_CPU_CLOCK, MOTOR_STOP};
 
     /* For motor 1 */
     GPIO_setupPinDirection(MOTOR_PORT_CONNECTION, PIN_INT1, PIN_OUTPUT);  /* Set INT1 as output */
@@ -58,203 +113,220 @@ void DcMotor_Init(uint8 MAXSPEED)
     GPIO_setupPinDirection(MOTOR_PORT_CONNECTION, PIN_INT4, PIN_OUTPUT);  /* Set INT4 as output */
     GPIO_setupPinDirection(ENABLE2_PORT_CONNECTION, ENABLE2_PIN, PIN_OUTPUT);  /* Set Enable2 as output */
 
+    PWM_init(PWM_CHANNEL_OC0, &configrations);
+    PWM_init(PWM_CHANNEL_OC2, &configrations);
+
+#if (MOTOR_SPEED_CONTROL == TRUE)
+    Encoder_init();
+    SpeedPi_reset(&g_speedPi[0]);
+    SpeedPi_reset(&g_speedPi[1]);
+#endif
+
     /* Stop the motor at the beginning */
-    GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT1, LOGIC_LOW);
-    GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT2, LOGIC_LOW);
-    GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT3, LOGIC_LOW);
-    GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT4, LOGIC_LOW);
+    g_targetDuty[0] = g_targetDuty[1] = 0;
+    g_currentDuty[0] = g_currentDuty[1] = 0;
+    DcMotor_setBoth(STOP, STOP);
 }
 
 /*
  * Description :
- * Function to rotate motor 1 in a specific direction and speed.
+ * Function to set the direction of both motors, the four H-bridge inputs change in a single store.
+ * The duties are not changed.
  * Parameters  :
- * - state: The motor state (STOP, CW, CCW).
- * - speed: The motor speed (0 to 100).
+ * - motor1State: The state of motor 1, the right wheel (STOP, CW, CCW).
+ * - motor2State: The state of motor 2, the left wheel (STOP, CW, CCW).
  */
-void DcMotor1_Rotate(DcMotor_State state, uint8 speed)
+void DcMotor_setBoth(DcMotor_State motor1State, DcMotor_State motor2State)
 {
-    /* Configure PWM for motor 1 */
-	Timer_Configuration configrations = {NON_INVERTING, F_CPU_CLOCK, speed};
-    PWM_Timer0_Start(&configrations);
-
-    /* Control motor 1 direction */
-    switch (state)
-    {
-    case STOP:
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT1, LOGIC_LOW);
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT2, LOGIC_LOW);
-        break;
-
-    case CW:
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT1, LOGIC_HIGH);
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT2, LOGIC_LOW);
-        break;
-
-    case CCW:
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT1, LOGIC_LOW);
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT2, LOGIC_HIGH);
-        break;
-    }
+    GPIO_writePortMasked(MOTOR_PORT_CONNECTION, MOTOR_PINS_MASK,
+            DcMotor_pinsOf(motor1State, PIN_INT1, PIN_INT2) | DcMotor_pinsOf(motor2State, PIN_INT3, PIN_INT4));
 }
 
 /*
  * Description :
- * Function to rotate motor 2 in a specific direction and speed.
+ * Function to set the target duty of both wheels, the ramp reaches it from the current duty.
  * Parameters  :
- * - state: The motor state (STOP, CW, CCW).
- * - speed: The motor speed (0 to 100).
+ * - motor1Duty: Target of motor 1 (-100 to 100), negative is backward.
+ * - motor2Duty: Target of motor 2 (-100 to 100), negative is backward.
  */
-void DcMotor2_Rotate(DcMotor_State state, uint8 speed)
+void DcMotor_setTarget(sint8 motor1Duty, sint8 motor2Duty)
 {
-    /* Configure PWM for motor 2 */
-	Timer_Configuration configrations = {NON_INVERTING, F_CPU_CLOCK, speed};
-    PWM_Timer2_Start(&configrations);
+    uint8 l_sreg = SREG;
 
-    /* Control motor 2 direction */
-    switch (state)
-    {
-    case STOP:
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT3, LOGIC_LOW);
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT4, LOGIC_LOW);
-        break;
-
-    case CW:
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT3, LOGIC_HIGH);
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT4, LOGIC_LOW);
-        break;
-
-    case CCW:
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT3, LOGIC_LOW);
-        GPIO_writePin(MOTOR_PORT_CONNECTION, PIN_INT4, LOGIC_HIGH);
-        break;
-    }
+    cli();  /* Keep both targets consistent for the ramp tick */
+    g_targetDuty[0] = motor1Duty;
+    g_targetDuty[1] = motor2Duty;
+    SREG = l_sreg;
 }
 
 /*
  * Description :
- * Function to move the car forward.
- * This function gradually increases the speed of both motors to move the car forward.
+ * Function to advance the ramp by one step, called every MOTOR_RAMP_PERIOD_MS.
+ * A step that would cross zero stops at 0 for one tick, so reversing always ramps down and
+ * the bridge is in STOP for a ramp period before its direction changes.
+ * With MOTOR_SPEED_CONTROL only the setpoints move, DcMotor_speedTick drives the bridges.
  */
-void Forward(void)
+void DcMotor_rampTick(void)
 {
-    for (int i = 0; i <= max_Speed; i = i + 10)
+    uint8 l_sreg = SREG;
+    sint8 l_current;
+    sint8 l_target;
+    uint8 l_changed = FALSE;
+    uint8 i;
+
+    cli();  /* Commands may come from interrupts, do not mix a step with a new target or a Stop */
+    for (i = 0; i < 2; i++)
     {
-        DcMotor1_Rotate(CCW, i);
-        DcMotor2_Rotate(CCW, i);
-        _delay_ms(DELAY_MOTOR);
+        l_current = g_currentDuty[i];
+        l_target = g_targetDuty[i];
+
+        if (l_current == l_target)
+        {
+            continue;
+        }
+        l_changed = TRUE;
+
+        if (l_current < l_target)
+        {
+            l_current = ((l_target - l_current) > MOTOR_RAMP_STEP) ? (l_current + MOTOR_RAMP_STEP) : l_target;
+        }
+        else
+        {
+            l_current = ((l_current - l_target) > MOTOR_RAMP_STEP) ? (l_current - MOTOR_RAMP_STEP) : l_target;
+        }
+
+        if (((g_currentDuty[i] > 0) && (l_current < 0)) || ((g_currentDuty[i] < 0) && (l_current > 0)))
+        {
+            l_current = 0;  /* Land on STOP before the direction changes */
+        }
+
+        g_currentDuty[i] = l_current;
     }
-}
 
-/*
- * Description :
- * Function to move the car backward.
- * This function gradually increases the speed of both motors to move the car backward.
- */
-void Backward(void)
-{
-    for (int i = 0; i <= max_Speed; i = i + 10)
+#if (MOTOR_SPEED_CONTROL == FALSE)
+    if (TRUE == l_changed)
     {
-        DcMotor1_Rotate(CW, i);
-        DcMotor2_Rotate(CW, i);
-        _delay_ms(DELAY_MOTOR);
+        /* Both wheels take their step together, the directions in one store */
+        PWM_setDuty(PWM_CHANNEL_OC0, DcMotor_speedOf(g_currentDuty[0]));
+        PWM_setDuty(PWM_CHANNEL_OC2, DcMotor_speedOf(g_currentDuty[1]));
+        DcMotor_setBoth(DcMotor_stateOf(g_currentDuty[0]), DcMotor_stateOf(g_currentDuty[1]));
     }
+#else
+    (void)l_changed;  /* DcMotor_speedTick applies the new setpoints */
+#endif
+    SREG = l_sreg;
 }
 
-
+#if (MOTOR_SPEED_CONTROL == TRUE)
 /*
  * Description :
- * Function to stop the car.
- * This function stops both motors.
+ * Function to run the wheel speed controllers, called every MOTOR_SPEED_PERIOD_MS.
+ * The setpoint of a wheel is its ramped duty in percent of SPEED_PI_FULL_DUTY_RPM, the PI
+ * output is the PWM duty. A stopped setpoint stops the wheel and clears its controller.
+ * The encoders have a single channel: after a reversal the wheel still turns the old way,
+ * it is driven open loop until its speed drops under half the setpoint.
  */
-void Stop(void)
+void DcMotor_speedTick(void)
 {
-    DcMotor1_Rotate(STOP, MOTOR_STOP);
-    DcMotor2_Rotate(STOP, MOTOR_STOP);
-}
+    uint8 l_sreg;
+    sint8 l_setpoint[2];
+    uint8 l_duty[2];
+    uint16 l_setpointRpm;
+    uint16 l_measuredRpm;
+    uint8 i;
 
-/*
- * Description :
- * Function to turn the car right while moving forward.
- * This function stops motor 1 and gradually increases the speed of motor 2.
- */
-void Right_Forward(void)
-{
-    for (int i = 0; i <= max_Speed; i = i + 10)
-    {
-        DcMotor1_Rotate(STOP, MOTOR_STOP);
-        DcMotor2_Rotate(CCW, i);
-        _delay_ms(DELAY_MOTOR);
-    }
-}
-void Right_Forward_Parking(uint8 speed)
-{
-    for (int i = 0; i <= speed; i = i + 10)
+    /* The controllers run with the interrupts enabled, the echo time stamps must not wait for them */
+    for (i = 0; i < 2; i++)
     {
-        DcMotor1_Rotate(CW, 50);
-        DcMotor2_Rotate(CCW, i);
-        _delay_ms(DELAY_MOTOR);
+        l_setpoint[i] = g_currentDuty[i];
+        if (MOTOR_STOP == l_setpoint[i])
+        {
+            SpeedPi_reset(&g_speedPi[i]);
+            l_duty[i] = MOTOR_STOP;
+        }
+        else
+        {
+            l_setpointRpm = ((uint16)DcMotor_speedOf(l_setpoint[i]) * SPEED_PI_FULL_DUTY_RPM) / 100u;
+            l_measuredRpm = Encoder_getRpm((Encoder_Wheel)i);
+
+            if (DcMotor_stateOf(l_setpoint[i]) != g_speedDirection[i])
+            {
+                g_reversing[i] = (STOP != g_speedDirection[i]) ? TRUE : FALSE;
+                g_speedDirection[i] = DcMotor_stateOf(l_setpoint[i]);
+                SpeedPi_reset(&g_speedPi[i]);
+            }
+            if (TRUE == g_reversing[i])
+            {
+                if (l_measuredRpm < (l_setpointRpm / 2u))
+                {
+                    g_reversing[i] = FALSE;
+                }
+                else
+                {
+                    l_measuredRpm = 0;  /* Old direction, no usable speed */
+                }
+            }
+            l_duty[i] = SpeedPi_update(&g_speedPi[i], l_setpointRpm, l_measuredRpm);
+        }
     }
-}
 
-/*
- * Description :
- * Function to turn the car left while moving forward.
- * This function stops motor 2 and gradually increases the speed of motor 1.
- */
-void Left_Forward(void)
-{
-    for (int i = 0; i <= max_Speed; i = i + 10)
+    l_sreg = SREG;
+    cli();  /* Apply both wheels together, unless a Stop or a reversal came in meanwhile */
+    for (i = 0; i < 2; i++)
     {
-        DcMotor1_Rotate(CCW, i);
-        DcMotor2_Rotate(STOP, MOTOR_STOP);
-        _delay_ms(DELAY_MOTOR);
+        if (DcMotor_stateOf(g_currentDuty[i]) != DcMotor_stateOf(l_setpoint[i]))
+        {
+            SpeedPi_reset(&g_speedPi[i]);
+            l_duty[i] = DcMotor_speedOf(g_currentDuty[i]);
+        }
     }
+    PWM_setDuty(PWM_CHANNEL_OC0, l_duty[0]);
+    PWM_setDuty(PWM_CHANNEL_OC2, l_duty[1]);
+    DcMotor_setBoth(DcMotor_stateOf(g_currentDuty[0]), DcMotor_stateOf(g_currentDuty[1]));
+    SREG = l_sreg;
 }
+#endif
 
 /*
  * Description :
- * Function to turn the car left while moving forward (for parking).
- * This function stops motor 2 and gradually increases the speed of motor 1 to the maximum speed.
+ * Function to check if both wheels reached their target.
+ * Returns     : TRUE when the ramp is done.
  */
-void Left_Forward_Parking(uint8 speed)
+uint8 DcMotor_isRampDone(void)
 {
-    for (int i = 0; i <= speed; i = i + 10)
-    {
-        DcMotor1_Rotate(CCW, i);
-        DcMotor2_Rotate(CW, 50);
-        _delay_ms(DELAY_MOTOR);
-    }
+    return ((g_currentDuty[0] == g_targetDuty[0]) && (g_currentDuty[1] == g_targetDuty[1])) ? TRUE : FALSE;
 }
 
 /*
  * Description :
- * Function to turn the car right while moving backward.
- * This function stops motor 1 and gradually increases the speed of motor 2.
+ * Function to get the signed duty currently applied to a motor.
+ * Parameters  :
+ * - motor: 0 for motor 1, 1 for motor 2.
+ * Returns     : The applied duty (-100 to 100), negative is backward.
  */
-void Right_Backward(void)
+sint8 DcMotor_getDuty(uint8 motor)
 {
-    for (int i = 0; i <= max_Speed; i = i + 10)
-    {
-        DcMotor1_Rotate(STOP, MOTOR_STOP);
-        DcMotor2_Rotate(CW, i);
-        _delay_ms(DELAY_MOTOR);
-    }
+    return g_currentDuty[motor];
 }
 
-
 /*
  * Description :
- * Function to turn the car left while moving backward.
- * This function stops motor 2 and gradually increases the speed of motor 1.
+ * Function to stop the car.
+ * This function stops both motors immediately and cancels any ramp.
  */
-void Left_Backward(void)
+void Stop(void)
 {
-    for (int i = 0; i <= max_Speed; i = i + 10)
-    {
-        DcMotor1_Rotate(CW, i);
-        DcMotor2_Rotate(STOP, MOTOR_STOP);
-        _delay_ms(DELAY_MOTOR);
-    }
-}
+    uint8 l_sreg = SREG;
 
+    cli();
+    g_targetDuty[0] = g_targetDuty[1] = 0;
+    g_currentDuty[0] = g_currentDuty[1] = 0;
+    PWM_setDuty(PWM_CHANNEL_OC0, MOTOR_STOP);
+    PWM_setDuty(PWM_CHANNEL_OC2, MOTOR_STOP);
+    DcMotor_setBoth(STOP, STOP);
+#if (MOTOR_SPEED_CONTROL == TRUE)
+    SpeedPi_reset(&g_speedPi[0]);
+    SpeedPi_reset(&g_speedPi[1]);
+#endif
+    SREG = l_sreg;
+}
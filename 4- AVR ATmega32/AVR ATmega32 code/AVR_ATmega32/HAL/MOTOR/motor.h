@@ -10,17 +10,29 @@
 #define HAL_MOTOR_H_
 
 #include "../../LIB/std_types.h"  /* Include standard types header file */
+#include "speed_pi.h"  /* Wheel speed controller */
 
 /*******************************************************************************
  *                                Configurations                               *
  *******************************************************************************/
 
-#define DELAY_MOTOR                 (0)      /* Delay for motor operations (if needed) */
+#define MOTOR_RAMP_STEP             (10)     /* Duty change per ramp tick */
+#define MOTOR_RAMP_PERIOD_MS        (5)      /* Period the application calls DcMotor_rampTick with */
 #define MOTOR_STOP                  (0)      /* Motor stop speed */
 
-#define MOTOR_SPEED_ONE             (70)     /* Motor first speed */
-#define MOTOR_SPEED_TWO             (85)     /* Motor second speed */
-#define MOTOR_MAX_SPEED             (100)    /* Motor maximum speed */
+/*
+ * Wheel speed control:
+ * - TRUE: the ramped duty is a speed setpoint (percent of SPEED_PI_FULL_DUTY_RPM), DcMotor_speedTick
+ *   measures the wheels with the encoders and sets the PWM duty every MOTOR_SPEED_PERIOD_MS,
+ *   so a wheel keeps its speed with the battery voltage, the load and the motor mismatch.
+ * - FALSE: the ramped duty goes straight to the PWM (open loop), the encoders are not used.
+ */
+#define MOTOR_SPEED_CONTROL         (TRUE)
+#define MOTOR_SPEED_PERIOD_MS       SPEED_PI_PERIOD_MS  /* Period the application calls DcMotor_speedTick with */
+
+#define MOTOR_SPEED_ONE             (70)     /* First driving speed, duty */
+#define MOTOR_SPEED_TWO             (85)     /* Second driving speed, duty */
+#define MOTOR_MAX_SPEED             (100)    /* Maximum driving speed, duty */
 
 #define MOTOR_PORT_CONNECTION       PORTC_ID /* Motor port connection */
 #define PIN_INT1                    PIN4_ID  /* Motor pin INT1 */
@@ -51,74 +63,73 @@ typedef enum
  *******************************************************************************/
 
 /*
- * Description :
- * Function to initialize the DC motor.
- * Parameters  :
- * - MAXSPEED: The maximum speed of the motor (0 to 100).
- */
-void DcMotor_Init(uint8 MAXSPEED);
-
-/*
- * Description :
- * Function to rotate the motor in a specific direction and speed.
- * Parameters  :
- * - state: The motor state (STOP, CW, CCW).
- * - speed: The motor speed (0 to 100).
+ * Motion commands (DcMotor_setTarget, or Motion_set in SERVICE/MOTION) only set a target
+ * and return immediately. The target is a signed duty per wheel, positive drives forward (CCW).
+ * DcMotor_rampTick moves the applied duty MOTOR_RAMP_STEP closer to the target on every call,
+ * starting from the current duty, so a new command never restarts the ramp from 0.
+ * With MOTOR_SPEED_CONTROL the applied duty is the speed setpoint of DcMotor_speedTick.
+ * Stop is applied immediately.
  */
-void DcMotor_Rotate(DcMotor_State state, uint8 speed);
 
 /*
  * Description :
- * Function to move the car forward.
+ * Function to initialize the DC motor, both wheels are stopped.
  */
-void Forward(void);
+void DcMotor_Init(void);
 
 /*
  * Description :
- * Function to move the car backward.
+ * Function to set the direction of both motors, the four H-bridge inputs change in a single store,
+ * so the bridges never pass through a mix of the old and the new directions. The duties are not changed.
+ * Parameters  :
+ * - motor1State: The state of motor 1, the right wheel (STOP, CW, CCW).
+ * - motor2State: The state of motor 2, the left wheel (STOP, CW, CCW).
  */
-void Backward(void);
+void DcMotor_setBoth(DcMotor_State motor1State, DcMotor_State motor2State);
 
 /*
  * Description :
- * Function to stop the car.
+ * Function to set the target duty of both wheels, the ramp reaches it from the current duty.
+ * Parameters  :
+ * - motor1Duty: Target of motor 1 (-100 to 100), negative is backward.
+ * - motor2Duty: Target of motor 2 (-100 to 100), negative is backward.
  */
-void Stop(void);
+void DcMotor_setTarget(sint8 motor1Duty, sint8 motor2Duty);
 
 /*
  * Description :
- * Function to turn the car right while moving forward.
+ * Function to advance the ramp by one step, called every MOTOR_RAMP_PERIOD_MS.
  */
-void Right_Forward(void);
+void DcMotor_rampTick(void);
 
 /*
  * Description :
- * Function to turn the car left while moving forward.
+ * Function to run the wheel speed controllers, called every MOTOR_SPEED_PERIOD_MS
+ * (only with MOTOR_SPEED_CONTROL).
  */
-void Left_Forward(void);
+void DcMotor_speedTick(void);
 
 /*
  * Description :
- * Function to turn the car left while moving forward (for parking).
+ * Function to check if both wheels reached their target.
+ * Returns     : TRUE when the ramp is done.
  */
-void Forward_Parking(uint8 speed);
-void Backward_Parking(uint8 speed);
-void Right_Forward_Parking(uint8 speed);
-void Left_Forward_Parking(uint8 speed);
-void Right_Backward_Parking(uint8 speed);
-void Left_Backward_Parking(uint8 speed);
-
+uint8 DcMotor_isRampDone(void);
 
 /*
  * Description :
- * Function to turn the car right while moving backward.
+ * Function to get the signed duty currently applied to a motor.
+ * Parameters  :
+ * - motor: 0 for motor 1, 1 for motor 2.
+ * Returns     : The applied duty (-100 to 100), negative is backward. With MOTOR_SPEED_CONTROL,
+ *               the speed setpoint in percent of SPEED_PI_FULL_DUTY_RPM.
  */
-void Right_Backward(void);
+sint8 DcMotor_getDuty(uint8 motor);
 
 /*
  * Description :
- * Function to turn the car left while moving backward.
+ * Function to stop the car immediately, the ramp is cancelled.
  */
-void Left_Backward(void);
+void Stop(void);
 
 #endif /* HAL_MOTOR_H_ */
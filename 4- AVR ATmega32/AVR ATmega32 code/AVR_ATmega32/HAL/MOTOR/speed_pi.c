@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Module       : Speed PI
+ * File Name    : speed_pi.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the fixed point PI wheel speed controller
+ *******************************************************************************/
+#include "speed_pi.h"
+
+/*******************************************************************************
+ *                           Definitions                                       *
+ *******************************************************************************/
+#define SPEED_PI_ONE_Q12		(4096)
+#define SPEED_PI_MAX_Q12		(100 * SPEED_PI_ONE_Q12)	/* 100% duty */
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+void SpeedPi_reset(SpeedPi_Type * pi_Ptr)
+{
+	pi_Ptr->integralQ12 = 0;
+	pi_Ptr->lastSetpoint = 0;
+	pi_Ptr->steadyPeriods = 0;
+}
+
+uint8 SpeedPi_update(SpeedPi_Type * pi_Ptr, uint16 setpointRpm, uint16 measuredRpm)
+{
+	sint32 l_error = (sint32)setpointRpm - (sint32)measuredRpm;
+	sint32 l_feedForward = ((sint32)setpointRpm * SPEED_PI_MAX_Q12) / (sint32)SPEED_PI_FULL_DUTY_RPM;
+	sint32 l_integral = pi_Ptr->integralQ12;
+	sint32 l_output;
+	uint16 l_step = (setpointRpm > pi_Ptr->lastSetpoint) ? (setpointRpm - pi_Ptr->lastSetpoint) :
+			(pi_Ptr->lastSetpoint - setpointRpm);
+
+	if(l_step > SPEED_PI_HOLD_STEP_RPM)
+	{
+		pi_Ptr->steadyPeriods = 0;
+	}
+	else if(pi_Ptr->steadyPeriods < SPEED_PI_HOLD_PERIODS)
+	{
+		pi_Ptr->steadyPeriods++;
+	}
+	pi_Ptr->lastSetpoint = setpointRpm;
+
+	if(setpointRpm < SPEED_PI_MIN_RPM)
+	{
+		/* Too slow to measure within a few periods, feed forward only */
+		pi_Ptr->integralQ12 = 0;
+		return (uint8)((l_feedForward + (SPEED_PI_ONE_Q12 / 2)) / SPEED_PI_ONE_Q12);
+	}
+
+	if(0 == measuredRpm)
+	{
+		/* Starting: no speed until the second encoder edge, drive the wheel open loop meanwhile */
+		l_error = 0;
+	}
+	else if(SPEED_PI_HOLD_PERIODS == pi_Ptr->steadyPeriods)
+	{
+		l_integral += l_error * SPEED_PI_KI_Q12;
+	}
+
+	/* Keep the integral within one full duty either way */
+	if(l_integral > SPEED_PI_MAX_Q12)
+	{
+		l_integral = SPEED_PI_MAX_Q12;
+	}
+	else if(l_integral < -SPEED_PI_MAX_Q12)
+	{
+		l_integral = -SPEED_PI_MAX_Q12;
+	}
+
+	l_output = l_feedForward + (l_error * SPEED_PI_KP_Q12) + l_integral;
+
+	/* Saturated: keep the output at the limit and the integral where it was when it pushes further */
+	if(l_output > SPEED_PI_MAX_Q12)
+	{
+		l_output = SPEED_PI_MAX_Q12;
+		if(l_error > 0)
+		{
+			l_integral = pi_Ptr->integralQ12;
+		}
+	}
+	else if(l_output < 0)
+	{
+		l_output = 0;
+		if(l_error < 0)
+		{
+			l_integral = pi_Ptr->integralQ12;
+		}
+	}
+	pi_Ptr->integralQ12 = l_integral;
+
+	return (uint8)((l_output + (SPEED_PI_ONE_Q12 / 2)) / SPEED_PI_ONE_Q12);
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Module       : Speed PI
+ * File Name    : speed_pi.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the fixed point PI wheel speed controller
+ *******************************************************************************/
+#ifndef HAL_MOTOR_SPEED_PI_H_
+#define HAL_MOTOR_SPEED_PI_H_
+
+#include "../../LIB/std_types.h"  	/* Include standard types */
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * One controller per wheel, run every SPEED_PI_PERIOD_MS on the speed measured by the encoder:
+ * 	duty = setpoint * 100 / SPEED_PI_FULL_DUTY_RPM		(feed forward, the open loop duty)
+ * 	     + Kp * error + sum(Ki * error)					(error = setpoint - measured, in rpm)
+ * The gains are in Q12 (1/4096 % duty per rpm). The integral only moves while the duty is not
+ * saturated in the direction of the error (anti windup), so it never has to unwind after a stall
+ * or a setpoint above what the battery can reach.
+ * The feed forward gives the wheel its open loop response, so the maneuvers calibrated on it keep
+ * their timing, and the PI trims the speed error (battery, load, motor mismatch):
+ * 	- Kp is kept low, the encoder gives a new period every 10ms at full speed but only every 50ms
+ * 	  at 20% duty and higher gains overshoot on that delay.
+ * 	- The integral starts SPEED_PI_HOLD_PERIODS after the last setpoint step, once the wheel is
+ * 	  done with its open loop transient, then removes the remaining error within about 0.5s.
+ * 	  A step is a change of more than SPEED_PI_HOLD_STEP_RPM in one period (the ramp of a new
+ * 	  command moves up to 59rpm per period). The small moves of a joystick stream keep the integral
+ * 	  running, else a packet every 50ms would hold the wheel open loop.
+ * Without a measured speed yet (measuredRpm 0, the wheel is starting) the wheel is driven open loop.
+ * Under SPEED_PI_MIN_RPM the wheel is always driven open loop: an encoder edge comes every 4 periods
+ * or less often, a short move (a parking pivot at 20% duty is 5 edges long) ends before the loop
+ * can act and its result would depend on where the encoder slots were when it started.
+ */
+#define SPEED_PI_FULL_DUTY_RPM		(294u)		/* No load wheel speed at 100% duty (1000 mm/s) */
+#define SPEED_PI_PERIOD_MS			(10u)
+#define SPEED_PI_KP_Q12				(820)		/* 0.2 % per rpm */
+#define SPEED_PI_KI_Q12				(56)		/* 0.014 % per rpm and period, Ti = 150ms */
+#define SPEED_PI_HOLD_PERIODS		(20u)		/* 200ms, two wheel time constants */
+#define SPEED_PI_HOLD_STEP_RPM		(15u)		/* 5% duty */
+#define SPEED_PI_MIN_RPM			(75u)		/* About 25% duty, an encoder edge every 40ms */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/* Controller state of one wheel */
+typedef struct
+{
+	sint32 integralQ12;		/* Integral term in 1/4096 % duty */
+	uint16 lastSetpoint;	/* Setpoint of the previous period in rpm */
+	uint8 steadyPeriods;	/* Periods since the last setpoint step, up to SPEED_PI_HOLD_PERIODS */
+} SpeedPi_Type;
+
+/*******************************************************************************
+ *                       Functions Prototypes                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Clear the integral, used when the wheel stops or changes direction.
+ */
+void SpeedPi_reset(SpeedPi_Type * pi_Ptr);
+
+/*
+ * Description :
+ * 	- Run one period of the controller.
+ * 	- Integer only, constant time.
+ * Returns     :
+ * 	- The duty to apply (0 to 100).
+ */
+uint8 SpeedPi_update(SpeedPi_Type * pi_Ptr, uint16 setpointRpm, uint16 measuredRpm);
+
+#endif /* HAL_MOTOR_SPEED_PI_H_ */
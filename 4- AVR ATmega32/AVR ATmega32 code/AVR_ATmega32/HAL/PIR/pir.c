@@ -8,6 +8,27 @@
 
 #include "pir.h"  /* Include PIR Sensor header file */
 
+/*******************************************************************************
+ *                           Definitions                                       *
+ *******************************************************************************/
+
+#define PIR_WARMUP_SAMPLES  (PIR_WARMUP_MS / PIR_SAMPLE_PERIOD_MS)
+
+/* Debounce state of one sensor */
+typedef struct
+{
+    uint8 present;  /* Debounced presence */
+    uint8 count;    /* Samples in a row that read the other level */
+} PIR_StateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static PIR_StateType g_sensors[PIR_SENSORS_NUM];
+static uint16 g_warmup = 0;  /* Samples left before the sensors are trusted */
+static void (*g_callBackPtr)(PIR_Sensor sensor, uint8 present) = NULL_PTR;
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
@@ -15,37 +36,79 @@
 /*
  * Description :
  * Function to initialize the PIR sensor.
- * This function sets up the necessary pin directions for the PIR sensor.
+ * This function sets up the necessary pin directions for the PIR sensor, no presence is reported.
  */
 void PIR_init(void)
 {
+    uint8 i;
+
     /* Configure PIR sensor 0 pin as input */
     GPIO_setupPinDirection(PIR_PORT, PIR0_PIN, PIN_INPUT);
 
     /* Configure PIR sensor 1 pin as input */
     GPIO_setupPinDirection(PIR_PORT, PIR1_PIN, PIN_INPUT);
+
+    for (i = 0; i < PIR_SENSORS_NUM; i++)
+    {
+        g_sensors[i].present = FALSE;
+        g_sensors[i].count = 0;
+    }
+    g_warmup = PIR_WARMUP_SAMPLES;
+}
+
+void PIR_setCallBack(void (*a_ptr)(PIR_Sensor sensor, uint8 present))
+{
+    g_callBackPtr = a_ptr;
 }
 
 /*
  * Description :
- * Function to read the value from PIR sensor 0.
- * Returns     :
- * - The value read from the PIR sensor pin (0 or 1).
+ * Function to debounce one sample of a sensor, the callback is called when the presence changes.
+ */
+static void PIR_debounce(PIR_Sensor sensor, uint8 level)
+{
+    PIR_StateType * l_sensor = &g_sensors[sensor];
+
+    if (level == l_sensor->present)
+    {
+        l_sensor->count = 0;
+        return;
+    }
+
+    if (++l_sensor->count >= PIR_DEBOUNCE_SAMPLES)
+    {
+        l_sensor->present = level;
+        l_sensor->count = 0;
+        if (g_callBackPtr != NULL_PTR)
+        {
+            (*g_callBackPtr)(sensor, level);
+        }
+    }
+}
+
+/*
+ * Description :
+ * Function to sample both sensors and run their debounce, called every PIR_SAMPLE_PERIOD_MS.
  */
-uint8 PIR_ReadValue1(void)
+void PIR_task(void)
 {
-    /* Read and return the value from PIR sensor 0 */
-    return GPIO_readPin(PIR_PORT, PIR0_PIN);
+    if (g_warmup > 0)
+    {
+        g_warmup--;
+        return;
+    }
+
+    PIR_debounce(PIR_SENSOR0, GPIO_READ_PIN(PIR_PORT, PIR0_PIN) ? TRUE : FALSE);
+    PIR_debounce(PIR_SENSOR1, GPIO_READ_PIN(PIR_PORT, PIR1_PIN) ? TRUE : FALSE);
 }
 
 /*
  * Description :
- * Function to read the value from PIR sensor 1.
+ * Function to get the debounced presence of a sensor.
  * Returns     :
- * - The value read from the PIR sensor pin (0 or 1).
+ * - TRUE while the sensor sees someone.
  */
-uint8 PIR_ReadValue2(void)
+uint8 PIR_isPresent(PIR_Sensor sensor)
 {
-    /* Read and return the value from PIR sensor 1 */
-    return GPIO_readPin(PIR_PORT, PIR1_PIN);
+    return g_sensors[sensor].present;
 }
@@ -17,10 +17,33 @@
  *                                Definitions                                  *
  *******************************************************************************/
 
-/* PIR sensor port and pin definitions */
+/*
+ * PIR sensor port and pin definitions.
+ * PD2/PD3 are the ultrasonic echo interrupts INT0/INT1, the sensors are on the free PD4/PD5
+ * (OC1B/OC1A, Timer1 drives no output pin).
+ */
 #define PIR_PORT      PORTD_ID  /* Port where the PIR sensors are connected */
-#define PIR0_PIN      PIN2_ID   /* Pin for PIR sensor 0 */
-#define PIR1_PIN      PIN3_ID   /* Pin for PIR sensor 1 */
+#define PIR0_PIN      PIN4_ID   /* Pin for PIR sensor 0 */
+#define PIR1_PIN      PIN5_ID   /* Pin for PIR sensor 1 */
+
+/*
+ * The pins are sampled by PIR_task every PIR_SAMPLE_PERIOD_MS, there is no busy polling.
+ * A new level must be read PIR_DEBOUNCE_SAMPLES times in a row before the presence changes,
+ * then the callback is called once with the new presence. The sensor output is unreliable
+ * for a while after power up, no presence is reported during PIR_WARMUP_MS.
+ */
+#define PIR_SAMPLE_PERIOD_MS    (20u)     /* Period the application calls PIR_task with */
+#define PIR_DEBOUNCE_SAMPLES    (5u)      /* 100ms stable level */
+#define PIR_WARMUP_MS           (30000u)
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum
+{
+    PIR_SENSOR0, PIR_SENSOR1, PIR_SENSORS_NUM
+} PIR_Sensor;
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
@@ -28,25 +51,30 @@
 
 /*
  * Description :
- * Function to read the value from PIR sensor 0.
- * Returns     :
- * - The value read from the PIR sensor pin (0 or 1).
+ * Function to initialize the PIR sensor.
+ * This function sets up the necessary pin directions for the PIR sensor, no presence is reported.
  */
-uint8 PIR_ReadValue1(void);
+void PIR_init(void);
 
 /*
  * Description :
- * Function to read the value from PIR sensor 1.
- * Returns     :
- * - The value read from the PIR sensor pin (0 or 1).
+ * Function to set the function called when the debounced presence of a sensor changes.
+ * The callback runs from PIR_task, not from an interrupt.
  */
-uint8 PIR_ReadValue2(void);
+void PIR_setCallBack(void (*a_ptr)(PIR_Sensor sensor, uint8 present));
 
 /*
  * Description :
- * Function to initialize the PIR sensor.
- * This function sets up the necessary pin directions for the PIR sensor.
+ * Function to sample both sensors and run their debounce, called every PIR_SAMPLE_PERIOD_MS.
  */
-void PIR_init(void);
+void PIR_task(void);
+
+/*
+ * Description :
+ * Function to get the debounced presence of a sensor.
+ * Returns     :
+ * - TRUE while the sensor sees someone.
+ */
+uint8 PIR_isPresent(PIR_Sensor sensor);
 
 #endif /* HAL_PIR_SENSOR_H_ */
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Module       : Ultrasonic Filter
+ * File Name    : ultrasonic_filter.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the per sensor distance filter (median + fixed point EWMA)
+ *******************************************************************************/
+#include "ultrasonic_filter.h"
+
+/*******************************************************************************
+ *                           Definitions                                       *
+ *******************************************************************************/
+/* Compare and swap so that a <= b, building block of the median networks */
+#define FILTER_SORT(a, b)	do { if((a) > (b)) { uint16 l_tmp = (a); (a) = (b); (b) = l_tmp; } } while(0)
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+void UltrasonicFilter_reset(Ultrasonic_FilterType * filter_Ptr)
+{
+	filter_Ptr->index = 0;
+	filter_Ptr->primed = FALSE;
+}
+
+#if (ULTRASONIC_FILTER_MEDIAN_N > 1u)
+/*
+ * Description :
+ * 	- Median of the window, on a local copy so the ring keeps its order.
+ * 	- Fixed compare networks: 3 compares for 3 samples, 7 for 5 samples.
+ */
+static uint16 UltrasonicFilter_median(const uint16 * window)
+{
+	uint16 p0 = window[0], p1 = window[1], p2 = window[2];
+#if (ULTRASONIC_FILTER_MEDIAN_N == 3u)
+	FILTER_SORT(p0, p1);
+	FILTER_SORT(p1, p2);
+	FILTER_SORT(p0, p1);
+	return p1;
+#else
+	uint16 p3 = window[3], p4 = window[4];
+	FILTER_SORT(p0, p1);
+	FILTER_SORT(p3, p4);
+	FILTER_SORT(p0, p3);
+	FILTER_SORT(p1, p4);
+	FILTER_SORT(p1, p2);
+	FILTER_SORT(p2, p3);
+	FILTER_SORT(p1, p2);
+	return p2;
+#endif
+}
+#endif
+
+uint16 UltrasonicFilter_update(Ultrasonic_FilterType * filter_Ptr, uint16 distanceMM)
+{
+	uint8 i;
+	uint16 l_value;
+
+	if(FALSE == filter_Ptr->primed)
+	{
+		/* First sample: fill the history with it, no ramp up from 0 */
+		for(i = 0; i < ULTRASONIC_FILTER_MEDIAN_N; i++)
+		{
+			filter_Ptr->window[i] = distanceMM;
+		}
+		filter_Ptr->smoothQ8 = (uint32)distanceMM << 8;
+		filter_Ptr->primed = TRUE;
+		return distanceMM;
+	}
+
+	/* Median stage */
+#if (ULTRASONIC_FILTER_MEDIAN_N > 1u)
+	filter_Ptr->window[filter_Ptr->index] = distanceMM;
+	filter_Ptr->index++;
+	if(filter_Ptr->index >= ULTRASONIC_FILTER_MEDIAN_N)
+	{
+		filter_Ptr->index = 0;
+	}
+	l_value = UltrasonicFilter_median(filter_Ptr->window);
+#else
+	l_value = distanceMM;
+#endif
+
+	/* Smoothing stage: s = s - s / 2^k + x / 2^k, unsigned so the shifts stay exact */
+#if (ULTRASONIC_FILTER_EWMA_SHIFT > 0u)
+	filter_Ptr->smoothQ8 = filter_Ptr->smoothQ8 - (filter_Ptr->smoothQ8 >> ULTRASONIC_FILTER_EWMA_SHIFT)
+			+ (((uint32)l_value << 8) >> ULTRASONIC_FILTER_EWMA_SHIFT);
+	l_value = (uint16)((filter_Ptr->smoothQ8 + 128u) >> 8);	/* Rounded back to mm */
+#endif
+
+	return l_value;
+}
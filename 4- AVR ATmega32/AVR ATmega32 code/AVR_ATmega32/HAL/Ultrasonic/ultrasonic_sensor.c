@@ -6,157 +6,348 @@
  * Description  : Source file for the Ultrasonic Sensor driver
  *******************************************************************************/
 #include "ultrasonic_sensor.h"  /* Include Ultrasonic Sensor header file */
+#include "../../LIB/common_macros.h"  /* Include common macros for bit manipulation */
 
 /*******************************************************************************
- *                           Global Variables                                  *
+ *                           Definitions                                       *
  *******************************************************************************/
-volatile static uint16 g_highTime_INT0 = 0;	/* Stores the high time (pulse width) */
-volatile static uint8 g_edgeTime_INT0 = 0;	/* Tracks the number of edges detected */
+#define ULTRASONIC_ECHO_TIMEOUT_TICKS	(ULTRASONIC_ECHO_TIMEOUT_US * TIMEBASE_TICKS_PER_US)
+#define ULTRASONIC_TRIGGER_TICKS		(ULTRASONIC_TRIGGER_US * TIMEBASE_TICKS_PER_US)
+#define ULTRASONIC_TICKS_PER_CM			(ULTRASONIC_US_PER_CM * TIMEBASE_TICKS_PER_US)
+#define ULTRASONIC_NO_SENSOR			(0xFFu)		/* Echo channel idle */
+
+/*
+ * Echo channels: one per external interrupt (indexed by EXT_INT_Type), or the single ICU.
+ * Rounds: the groups of the sensors table, or one sensor per round with the ICU.
+ */
+#if (ULTRASONIC_ECHO_CAPTURE == ULTRASONIC_CAPTURE_EXT_INT)
+#define ULTRASONIC_CHANNELS_NUM			(3u)
+#define ULTRASONIC_ROUNDS_NUM			ULTRASONIC_GROUPS_NUM
+#define ULTRASONIC_CHANNEL(sensor)		(g_sensors[(sensor)].echoSource)
+#define ULTRASONIC_IN_ROUND(sensor, round)	(g_sensors[(sensor)].group == (round))
+#else
+#define ULTRASONIC_CHANNELS_NUM			(1u)
+#define ULTRASONIC_ROUNDS_NUM			ULTRASONIC_SENSORS_NUM
+#define ULTRASONIC_CHANNEL(sensor)		(0u)
+#define ULTRASONIC_IN_ROUND(sensor, round)	((sensor) == (round))
+#endif
+
+/* Echo measurement states of a sensor in flight */
+typedef enum
+{
+	ECHO_WAIT_RISING, ECHO_WAIT_FALLING
+} Ultrasonic_EchoState;
 
-volatile static uint16 g_highTime_INT1 = 0;	/* Stores the high time (pulse width) */
-volatile static uint8 g_edgeTime_INT1 = 0;	/* Tracks the number of edges detected */
+/* Measurement in flight on one echo input */
+typedef struct
+{
+	uint8 sensor;					/* Ultrasonic in flight, ULTRASONIC_NO_SENSOR when idle */
+	Ultrasonic_EchoState state;
+	uint16 echoStart;				/* Timer1 value at the echo rising edge */
+} Ultrasonic_ChannelType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* Sensors table (indexed by Ultrasonic) */
+static const Ultrasonic_ConfigType g_sensors[ULTRASONIC_SENSORS_NUM] = {
+	/* trigger pin,	echo,	group */
+	{TRIGGER2_PIN,	INT_1,	0},		/* U_forward  */
+	{TRIGGER1_PIN,	INT_0,	1},		/* U_right    */
+	{TRIGGER3_PIN,	INT_1,	2}		/* U_backward */
+};
+
+static volatile Ultrasonic_SampleType g_samples[ULTRASONIC_SENSORS_NUM];	/* Latest sample per sensor */
+static Ultrasonic_FilterType g_filters[ULTRASONIC_SENSORS_NUM];			/* Filter state per sensor, used from the interrupts only */
+static volatile uint8 g_freshMask = 0;				/* Bit per sensor, set when a new sample is published */
+static volatile uint16 g_cycleCount = 0;			/* Completed full cycles */
+
+static volatile Ultrasonic_ChannelType g_channels[ULTRASONIC_CHANNELS_NUM];
+static volatile uint8 g_round = 0;					/* Round in flight */
+static volatile uint8 g_pendingMask = 0;			/* Bit per sensor of the round still waiting for its echo */
+static volatile uint8 g_triggers = 0;				/* Trigger pins of the round while its pulse is high, else 0 */
 
 /*******************************************************************************
  *                      	Functions Prototypes                               *
  *******************************************************************************/
+static void Ultrasonic_startRound(uint8 round);
+#if (ULTRASONIC_ECHO_CAPTURE == ULTRASONIC_CAPTURE_EXT_INT)
 static void Ultrasonic_edgeProcessing_INT0(void);
+static void Ultrasonic_edgeProcessing_INT1(void);
 static void Ultrasonic_edgeProcessing_INT2(void);
+#else
+static void Ultrasonic_edgeProcessing_ICU(void);
+#endif
+static void Ultrasonic_compareMatch(void);
+
+#if (ULTRASONIC_ECHO_CAPTURE == ULTRASONIC_CAPTURE_EXT_INT)
+/* Edge callback of each echo input (indexed by EXT_INT_Type) */
+static void (* const g_edgeCallbacks[ULTRASONIC_CHANNELS_NUM])(void) = {
+	Ultrasonic_edgeProcessing_INT0, Ultrasonic_edgeProcessing_INT1, Ultrasonic_edgeProcessing_INT2
+};
+#endif
 
 /*******************************************************************************
  *                      	Functions Definitions                              *
  *******************************************************************************/
 void Ultrasonic_init(void)
 {
-	EXT_INT_ConfigType EXT_INT0_Configrations = {INT_0, RISING_EDGE};
-	external_interrupt_setCallBack(Ultrasonic_edgeProcessing_INT0, INT_0); /* Set the callback function for INT0 */
-	external_interrupt_init(&EXT_INT0_Configrations);	/* Initialize INT0 with the specified configuration */
+	uint8 i;
 
-	EXT_INT_ConfigType EXT_INT2_Configrations = {INT_1, RISING_EDGE};
-	external_interrupt_setCallBack(Ultrasonic_edgeProcessing_INT2, INT_1); /* Set the callback function for INT2 */
-	external_interrupt_init(&EXT_INT2_Configrations);	/* Initialize INT2 with the specified configuration */
+	/* Set up pin direction for the trigger pins as output */
+	for(i = 0; i < ULTRASONIC_SENSORS_NUM; i++)
+	{
+		GPIO_setupPinDirection(TRIGGERS_PORT_CONNECTION, g_sensors[i].triggerPin, PIN_OUTPUT);
+	}
+	for(i = 0; i < ULTRASONIC_CHANNELS_NUM; i++)
+	{
+		g_channels[i].sensor = ULTRASONIC_NO_SENSOR;
+	}
 
-	/* Set up pin direction for trigger pin as output */
-	GPIO_setupPinDirection(TRIGGERS_PORT_CONNECTION, TRIGGER1_PIN, PIN_OUTPUT);
-	GPIO_setupPinDirection(TRIGGERS_PORT_CONNECTION, TRIGGER2_PIN, PIN_OUTPUT);
-	GPIO_setupPinDirection(TRIGGERS_PORT_CONNECTION, TRIGGER3_PIN, PIN_OUTPUT);
+	/* Timer1 free runs as the shared timebase, echo widths are taken as differences */
+	Timebase_init();
+	Timer_setCompareCallBack(Ultrasonic_compareMatch, TIMER1_ID);
+
+#if (ULTRASONIC_ECHO_CAPTURE == ULTRASONIC_CAPTURE_EXT_INT)
+	for(i = 0; i < ULTRASONIC_SENSORS_NUM; i++)
+	{
+		/* Only the echo inputs in use are taken and enabled, waiting for a rising edge */
+		EXT_INT_ConfigType EXT_INT_Configrations = {g_sensors[i].echoSource,
+				(INT_2 == g_sensors[i].echoSource) ? RISING_EDGE_INT2 : RISING_EDGE};
+		external_interrupt_setCallBack(g_edgeCallbacks[g_sensors[i].echoSource], g_sensors[i].echoSource);
+		external_interrupt_init(&EXT_INT_Configrations);
+	}
+#else
+	/* Capture on the running timebase without resetting it */
+	ICU_setCallBack(Ultrasonic_edgeProcessing_ICU);
+	ICU_enable(RAISING);
+#endif
+
+	/* Start the first round, the next ones are chained from the interrupts */
+	Ultrasonic_startRound(0);
 }
 
-static void Ultrasonic_Trigger(Ultrasonic ultrasonic)
+/*
+ * Description :
+ * 	- Raise the triggers of all the sensors of a round, the compare match A ends the pulse
+ * 	  ULTRASONIC_TRIGGER_US later and then arms the echo timeout.
+ */
+static void Ultrasonic_startRound(uint8 round)
 {
-	switch(ultrasonic)
-	{
-	case U_right:
-		/* Set the trigger pin to high for 10us */
-		GPIO_writePin(TRIGGERS_PORT_CONNECTION, TRIGGER1_PIN, LOGIC_HIGH);
-		_delay_us(10);
-		/* Set the trigger pin back to low */
-		GPIO_writePin(TRIGGERS_PORT_CONNECTION, TRIGGER1_PIN, LOGIC_LOW);
-		break;
-
-	case U_forward:
-		/* Set the trigger pin to high for 10us */
-		GPIO_writePin(TRIGGERS_PORT_CONNECTION, TRIGGER2_PIN, LOGIC_HIGH);
-		_delay_us(10);
-		/* Set the trigger pin back to low */
-		GPIO_writePin(TRIGGERS_PORT_CONNECTION, TRIGGER2_PIN, LOGIC_LOW);
-		break;
-
-	case U_backward:
-		/* Set the trigger pin to high for 10us */
-		GPIO_writePin(TRIGGERS_PORT_CONNECTION, TRIGGER3_PIN, LOGIC_HIGH);
-		_delay_us(10);
-		/* Set the trigger pin back to low */
-		GPIO_writePin(TRIGGERS_PORT_CONNECTION, TRIGGER3_PIN, LOGIC_LOW);
-		break;
+	uint8 i;
+	uint8 l_sreg;
+	uint8 l_triggers = 0;	/* Trigger pins of the round */
 
+	g_round = round;
+	g_pendingMask = 0;
+	for(i = 0; i < ULTRASONIC_SENSORS_NUM; i++)
+	{
+		if(ULTRASONIC_IN_ROUND(i, round))
+		{
+			g_channels[ULTRASONIC_CHANNEL(i)].sensor = i;
+			g_channels[ULTRASONIC_CHANNEL(i)].state = ECHO_WAIT_RISING;
+			g_pendingMask |= (1 << i);
+			l_triggers |= (1 << g_sensors[i].triggerPin);
+		}
 	}
 
+	/* The triggers of the round rise together in one store, also called from Ultrasonic_init */
+	l_sreg = SREG;
+	cli();
+	GPIO_WRITE_PORT_MASKED(TRIGGERS_PORT_CONNECTION, l_triggers, l_triggers);
+	g_triggers = l_triggers;
+	Timer_setCompareValue(TIMER1_ID, Timebase_getTicks() + ULTRASONIC_TRIGGER_TICKS);
+	SREG = l_sreg;
 }
 
-uint16 Ultrasonic_readDistance (Ultrasonic ultrasonic)
+/*
+ * Description :
+ * 	- Start the round after the current one, a full cycle is counted after the last round.
+ */
+static void Ultrasonic_nextRound(void)
 {
-	switch(ultrasonic)
+	uint8 l_round = g_round + 1;
+
+	if(l_round >= ULTRASONIC_ROUNDS_NUM)
 	{
-	case U_right:
-		/* Send the trigger pulse to start the measurement */
-		Ultrasonic_Trigger(U_right);
+		l_round = 0;
+		g_cycleCount++;
+	}
+	Ultrasonic_startRound(l_round);
+}
 
-		/* Calculate the distance in centimeters using the high time */
-		return (g_highTime_INT0 * 1.088) + 1;
-		break;
+/*
+ * Description :
+ * 	- Publish the result of a sensor into its slot and release its echo channel.
+ */
+static void Ultrasonic_completeMeasurement(uint8 channel, uint16 width, uint8 valid)
+{
+	uint8 l_sensor = g_channels[channel].sensor;
+	uint16 l_distanceMM;
 
-	case U_forward:
-		/* Send the trigger pulse to start the measurement */
-		Ultrasonic_Trigger(U_forward);
+	if(TRUE == valid)
+	{
+		/* Outliers are rejected and the distance smoothed before anyone sees it */
+		l_distanceMM = ((uint32)width * 10u) / ULTRASONIC_TICKS_PER_CM;
+		l_distanceMM = UltrasonicFilter_update(&g_filters[l_sensor], l_distanceMM);
+		g_samples[l_sensor].distance = (l_distanceMM / 10u) + 1;
+		g_samples[l_sensor].distanceMM = l_distanceMM;
+	}
+	else
+	{
+		UltrasonicFilter_reset(&g_filters[l_sensor]);
+		g_samples[l_sensor].distance = ULTRASONIC_MAX_DISTANCE;
+		g_samples[l_sensor].distanceMM = ULTRASONIC_MAX_DISTANCE * 10u;
+	}
+	g_samples[l_sensor].timestamp = Timebase_micros();
+	g_samples[l_sensor].valid = valid;
+	g_freshMask |= (1 << l_sensor);
 
-		/* Calculate the distance in centimeters using the high time */
-		return (g_highTime_INT1 * 1.088) + 1;
-		break;
+	g_channels[channel].sensor = ULTRASONIC_NO_SENSOR;
+	g_pendingMask &= ~(1 << l_sensor);
+}
 
-	case U_backward:
-		/* Send the trigger pulse to start the measurement */
-		Ultrasonic_Trigger(U_backward);
+#if (ULTRASONIC_ECHO_CAPTURE == ULTRASONIC_CAPTURE_EXT_INT)
+/*
+ * Description :
+ * 	- Select the edge an echo input waits for (INT2 has its own sense values).
+ */
+static void Ultrasonic_setEchoEdge(EXT_INT_Type source, uint8 rising)
+{
+	EXT_INT_ConfigType EXT_INT_Configrations = {source, RISING_EDGE};
 
-		/* Calculate the distance in centimeters using the high time */
-		return (g_highTime_INT0 * 1.088) + 1;
-		break;
+	if(INT_2 == source)
+	{
+		EXT_INT_Configrations.INT_Sense = (TRUE == rising) ? RISING_EDGE_INT2 : FALLING_EDGE_INT2;
+	}
+	else
+	{
+		EXT_INT_Configrations.INT_Sense = (TRUE == rising) ? RISING_EDGE : FALLING_EDGE;
 	}
+	external_interrupt_init(&EXT_INT_Configrations);
 }
 
-static void Ultrasonic_edgeProcessing_INT0(void)
+static void Ultrasonic_edgeProcessing(EXT_INT_Type source)
 {
-	g_edgeTime_INT0++; 	// Increment edge count
-
-	if (1 == g_edgeTime_INT0) {
-		/* Rising edge detected */
-		Timer_deInit(TIMER1_ID); // De-initialize Timer1
+	uint16 l_now = Timebase_getTicks();
 
-		external_interrupt_deinit(INT_0); // De-initialize INT2
-		EXT_INT_ConfigType EXT_INT0_Configrations = {INT_0, FALLING_EDGE}; // Configure INT2 for falling edge detection
-		external_interrupt_init(&EXT_INT0_Configrations); // Reinitialize INT2 with the new configuration
+	if(ULTRASONIC_NO_SENSOR == g_channels[source].sensor)
+	{
+		/* Late echo of a sensor that is not being measured any more */
+		return;
+	}
 
-		Timer_ConfigType Timer_Configrations = {0, 0, TIMER1_ID, F_CPU_1024, NORMAL_MODE}; // Configure Timer1
-		Timer_init(&Timer_Configrations); // Initialize Timer1
+	if (ECHO_WAIT_RISING == g_channels[source].state) {
+		/* Rising edge detected */
+		g_channels[source].echoStart = l_now;
+		g_channels[source].state = ECHO_WAIT_FALLING;
+		Ultrasonic_setEchoEdge(source, FALSE);	/* Wait for the end of the echo */
 
-	} else if (2 == g_edgeTime_INT0) {
+	} else {
 		/* Falling edge detected */
-		g_highTime_INT0 = Timer_getTimerValue(TIMER1_ID); // Calculate pulse width
+		Ultrasonic_setEchoEdge(source, TRUE);	/* Back to rising edge for the next round */
+		Ultrasonic_completeMeasurement(source, l_now - g_channels[source].echoStart, TRUE);
+		if(0 == g_pendingMask)
+		{
+			Ultrasonic_nextRound();		/* All the echoes of the round are back */
+		}
+	}
+}
+
+static void Ultrasonic_edgeProcessing_INT0(void)
+{
+	Ultrasonic_edgeProcessing(INT_0);
+}
 
-		Timer_deInit(TIMER1_ID);	/* De-initialize Timer1 */
+static void Ultrasonic_edgeProcessing_INT1(void)
+{
+	Ultrasonic_edgeProcessing(INT_1);
+}
 
-		external_interrupt_deinit(INT_0);	/* De-initialize INT2 */
-		EXT_INT_ConfigType EXT_INT0_Configrations = {INT_0, RISING_EDGE};	/* Configure INT2 for rising edge detection */
-		external_interrupt_init(&EXT_INT0_Configrations);	/* Reinitialize INT2 with the new configuration */
+static void Ultrasonic_edgeProcessing_INT2(void)
+{
+	Ultrasonic_edgeProcessing(INT_2);
+}
+#else
+static void Ultrasonic_edgeProcessing_ICU(void)
+{
+	if(ULTRASONIC_NO_SENSOR == g_channels[0].sensor)
+	{
+		return;
+	}
 
-		g_edgeTime_INT0 = 0;		/* Reset edge count */
+	/* Both edges are time stamped by hardware in ICR1, only the edge has to be flipped */
+	if (ECHO_WAIT_RISING == g_channels[0].state) {
+		g_channels[0].echoStart = ICU_getInputCaptureValue();
+		g_channels[0].state = ECHO_WAIT_FALLING;
+		ICU_setEdgeDetectionType(FALLING);
+	} else {
+		ICU_setEdgeDetectionType(RAISING);
+		Ultrasonic_completeMeasurement(0, ICU_getInputCaptureValue() - g_channels[0].echoStart, TRUE);
+		Ultrasonic_nextRound();
 	}
 }
+#endif
 
-static void Ultrasonic_edgeProcessing_INT2(void)
+static void Ultrasonic_compareMatch(void)
 {
-	g_edgeTime_INT1++; 	// Increment edge count
+	uint8 i;
 
-	if (1 == g_edgeTime_INT1) {
-		/* Rising edge detected */
-		Timer_deInit(TIMER1_ID); // De-initialize Timer1
+	if(0 != g_triggers)
+	{
+		/* End of the trigger pulse, the echoes of the round get their time from now */
+		GPIO_WRITE_PORT_MASKED(TRIGGERS_PORT_CONNECTION, g_triggers, 0);
+		g_triggers = 0;
+		Timer_setCompareValue(TIMER1_ID, Timebase_getTicks() + ULTRASONIC_ECHO_TIMEOUT_TICKS);
+		return;
+	}
 
-		external_interrupt_deinit(INT_1); // De-initialize INT2
-		EXT_INT_ConfigType EXT_INT2_Configrations = {INT_1, FALLING_EDGE}; // Configure INT2 for falling edge detection
-		external_interrupt_init(&EXT_INT2_Configrations); // Reinitialize INT2 with the new configuration
+	/* Echoes still missing: nothing in range (or sensor missing), publish them as invalid */
+	for(i = 0; i < ULTRASONIC_CHANNELS_NUM; i++)
+	{
+		if(ULTRASONIC_NO_SENSOR != g_channels[i].sensor)
+		{
+#if (ULTRASONIC_ECHO_CAPTURE == ULTRASONIC_CAPTURE_EXT_INT)
+			Ultrasonic_setEchoEdge((EXT_INT_Type)i, TRUE);
+#else
+			ICU_setEdgeDetectionType(RAISING);
+#endif
+			Ultrasonic_completeMeasurement(i, 0, FALSE);
+		}
+	}
+	Ultrasonic_nextRound();
+}
 
-		Timer_ConfigType Timer_Configrations = {0, 0, TIMER1_ID, F_CPU_1024, NORMAL_MODE}; // Configure Timer1
-		Timer_init(&Timer_Configrations); // Initialize Timer1
+uint16 Ultrasonic_readDistance (Ultrasonic ultrasonic)
+{
+	return g_samples[ultrasonic].distance;
+}
 
-	} else if (2 == g_edgeTime_INT1) {
-		/* Falling edge detected */
-		g_highTime_INT1 = Timer_getTimerValue(TIMER1_ID); // Calculate pulse width
+uint8 Ultrasonic_getSample(Ultrasonic ultrasonic, Ultrasonic_SampleType * sample_Ptr)
+{
+	uint8 l_sreg = SREG;
+	uint8 l_fresh;
+
+	cli();		/* The sample is written from interrupts, copy it atomically */
+	sample_Ptr->distance = g_samples[ultrasonic].distance;
+	sample_Ptr->distanceMM = g_samples[ultrasonic].distanceMM;
+	sample_Ptr->timestamp = g_samples[ultrasonic].timestamp;
+	sample_Ptr->valid = g_samples[ultrasonic].valid;
+	l_fresh = BIT_IS_SET(g_freshMask, ultrasonic) ? TRUE : FALSE;
+	g_freshMask &= ~(1 << ultrasonic);
+	SREG = l_sreg;
+
+	return l_fresh;
+}
 
-		Timer_deInit(TIMER1_ID);	/* De-initialize Timer1 */
+uint16 Ultrasonic_getCycleCount(void)
+{
+	uint8 l_sreg = SREG;
+	uint16 l_count;
 
-		external_interrupt_deinit(INT_1);	/* De-initialize INT2 */
-		EXT_INT_ConfigType EXT_INT2_Configrations = {INT_1, RISING_EDGE};	/* Configure INT2 for rising edge detection */
-		external_interrupt_init(&EXT_INT2_Configrations);	/* Reinitialize INT2 with the new configuration */
+	cli();
+	l_count = g_cycleCount;
+	SREG = l_sreg;
 
-		g_edgeTime_INT1 = 0;		/* Reset edge count */
-	}
+	return l_count;
 }
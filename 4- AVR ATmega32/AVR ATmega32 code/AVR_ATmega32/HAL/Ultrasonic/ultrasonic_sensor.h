@@ -9,46 +9,112 @@
 #define HAL_ULTRASONIC_SENSOR_H_
 
 #include "../../MCAL/EXT_INT/EXT_INT.h"
+#include "../../MCAL/ICU/icu.h"
 #include "../../MCAL/TIMER/timer.h"
 #include "../../MCAL/GPIO/gpio.h"  	/* Include GPIO driver for trigger pin control */
+#include "../../SERVICE/TIMEBASE/timebase.h"	/* Shared free running Timer1 */
+#include "ultrasonic_filter.h"					/* Median and smoothing of the samples */
 #include "../../LIB/std_types.h"  	/* Include standard types */
-#include <util/delay.h>  			/* Include delay utility for timing */
 
 /*******************************************************************************
  *                                Configurations                               *
  *******************************************************************************/
-/* Define the port and pin for the ultrasonic sensor's trigger pin */
+/* Define the port and pin for the ultrasonic sensor's trigger pin, all triggers share the port */
 #define TRIGGERS_PORT_CONNECTION   	PORTB_ID  /* Port connected to the trigger pin */
-#define TRIGGER1_PIN            	PIN5_ID   /* Pin connected to the trigger pin */
-#define TRIGGER2_PIN               	PIN6_ID   /* Pin connected to the trigger pin */
-#define TRIGGER3_PIN               	PIN7_ID   /* Pin connected to the trigger pin */
+#define TRIGGER1_PIN            	PIN5_ID   /* Right sensor trigger pin */
+#define TRIGGER2_PIN               	PIN6_ID   /* Forward sensor trigger pin */
+#define TRIGGER3_PIN               	PIN7_ID   /* Backward sensor trigger pin */
+
+/*
+ * Echo capture mode:
+ * 	- ULTRASONIC_CAPTURE_EXT_INT: the echo pins go to external interrupts (right INT0/PD2, forward and
+ * 	  backward OR-ed into INT1/PD3, see the sensors table in the source file) and the edge time is
+ * 	  read from TCNT1 in software. Sensors on different echo inputs can be fired together, sensors
+ * 	  sharing an input are in different groups. INT2/PB2 is left to the left wheel encoder, see the
+ * 	  echo wiring and its trade-off in README.md (next to AVR_ATmega32/).
+ * 	- ULTRASONIC_CAPTURE_ICU: the echo pins are OR-ed (diodes or an OR gate) into ICP1/PD6 and the
+ * 	  edge time is latched by hardware into ICR1. Only one sensor is fired at a time, so the
+ * 	  capture always belongs to the sensor in flight. Not available with the wheel encoders, the
+ * 	  right wheel encoder uses ICP1.
+ */
+#define ULTRASONIC_CAPTURE_EXT_INT	(0u)
+#define ULTRASONIC_CAPTURE_ICU		(1u)
+#define ULTRASONIC_ECHO_CAPTURE		ULTRASONIC_CAPTURE_EXT_INT
+
+/*
+ * Acquisition engine timing:
+ * Edges are time stamped on the shared timebase (Timer1 at 0.5us per tick = 0.086mm), which is never reset.
+ * The sensors are fired in rounds: all the sensors of a group together (EXT_INT capture), or one
+ * sensor per round (ICU capture). A round gets at most ULTRASONIC_ECHO_TIMEOUT_US for its echoes
+ * and ends as soon as all of them are back, so a full cycle is bounded by
+ * 3 groups * 20ms = 60ms (>= 16Hz refresh), the same with the ICU.
+ * Only sensors facing opposite ways may share a group, the echo of one must not reach the other.
+ * Forward and backward do, but share INT1, and right is mounted at 90 degrees to both (a corner
+ * would return its burst to the other sensor): every sensor is fired alone.
+ */
+#define ULTRASONIC_SENSORS_NUM		(3u)
+#define ULTRASONIC_GROUPS_NUM		(3u)		/* One sensor per group, see above */
+#define ULTRASONIC_TRIGGER_US		(10u)		/* Trigger pulse width, ended by the compare match A */
+#define ULTRASONIC_ECHO_TIMEOUT_US	(20000u)	/* Echo wait limit per sensor (~340cm), must fit 16 bits of ticks */
+#define ULTRASONIC_US_PER_CM		(58u)		/* Echo round trip time per centimetre */
+#define ULTRASONIC_MAX_DISTANCE		(ULTRASONIC_ECHO_TIMEOUT_US / ULTRASONIC_US_PER_CM)	/* Reported on timeout */
 
 typedef enum {
 	U_forward, U_right, U_backward
 }Ultrasonic;
 
+/* Descriptor of one sensor, the table in the source file is indexed by Ultrasonic */
+typedef struct
+{
+	uint8 triggerPin;			/* Trigger pin, on TRIGGERS_PORT_CONNECTION */
+	EXT_INT_Type echoSource;	/* External interrupt the echo pin is wired to (EXT_INT capture) */
+	uint8 group;				/* Sensors of the same group are fired together, their echo sources must differ */
+} Ultrasonic_ConfigType;
+
+/* Structure holding the latest published measurement of one sensor */
+typedef struct
+{
+	uint16 distance;	/* Distance in centimetres (ULTRASONIC_MAX_DISTANCE when no echo) */
+	uint16 distanceMM;	/* Filtered distance in millimetres */
+	uint32 timestamp;	/* Time of the echo completion in microseconds */
+	uint8 valid;		/* FALSE when the echo timed out */
+} Ultrasonic_SampleType;
+
 /*******************************************************************************
  *                       Functions Prototypes                                  *
  *******************************************************************************/
 
 /*
  * Description :
- * 	- Initialize the ultrasonic sensor:
- * 		1. Set up ICU configuration for echo pulse measurement.
- * 		2. Initialize the ICU driver.
- * 		3. Set the callback function for the ICU.
+ * 	- Initialize the ultrasonic sensors and start the acquisition engine:
+ * 		1. Set up the echo capture (external interrupts or ICU) and the trigger pins.
+ * 		2. Start the timebase and use its compare match A for the end of the trigger pulses and
+ * 		   the echo timeout.
+ * 		3. Fire the first round, the next ones are chained from the interrupts.
  */
 void Ultrasonic_init(void);
 
 /*
  * Description :
- * 	- Measure the distance using the ultrasonic sensor:
- * 		1. Send the trigger pulse to start the measurement.
- * 		2. Use the ICU driver to measure the echo pulse duration.
- * 		3. Calculate and return the distance in centimeters.
+ * 	- Return the latest distance measured by the required sensor.
+ * 	- Non-blocking, the measurement itself runs in the background.
  * Returns     :
  * 	- The measured distance in centimeters.
  */
 uint16 Ultrasonic_readDistance(Ultrasonic ultrasonic);
 
+/*
+ * Description :
+ * 	- Copy the latest sample of the required sensor.
+ * Returns     :
+ * 	- TRUE if the sample was published after the previous call for this sensor.
+ */
+uint8 Ultrasonic_getSample(Ultrasonic ultrasonic, Ultrasonic_SampleType * sample_Ptr);
+
+/*
+ * Description :
+ * 	- Return the number of completed full cycles (all sensors measured once).
+ */
+uint16 Ultrasonic_getCycleCount(void);
+
 #endif /* HAL_ULTRASONIC_SENSOR_H_ */
@@ -9,6 +9,7 @@
 #include <avr/io.h>  /* Include AVR I/O header file */
 #include <avr/interrupt.h>  /* Include AVR interrupt header file */
 #include "EXT_INT.h"  /* Include External Interrupts header file */
+#include "../../SERVICE/TRACE/trace.h"  /* Include the event trace */
 
 /*******************************************************************************
  *                           Global Variables                                  *
@@ -30,11 +31,13 @@ static volatile void (*g_callBackPtr_INT2)(void) = NULL_PTR;  /* Callback for IN
  */
 ISR(INT0_vect)
 {
+    TRACE(TRACE_ID_INT0);
     if (g_callBackPtr_INT0 != NULL_PTR)
     {
         /* Call the callback function in the application after the edge is detected */
         (*g_callBackPtr_INT0)();
     }
+    TRACE(TRACE_ID_INT0 | TRACE_EXIT);
 }
 
 /*
@@ -44,11 +47,13 @@ ISR(INT0_vect)
  */
 ISR(INT1_vect)
 {
+    TRACE(TRACE_ID_INT1);
     if (g_callBackPtr_INT1 != NULL_PTR)
     {
         /* Call the callback function in the application after the edge is detected */
         (*g_callBackPtr_INT1)();
     }
+    TRACE(TRACE_ID_INT1 | TRACE_EXIT);
 }
 
 /*
@@ -58,11 +63,13 @@ ISR(INT1_vect)
  */
 ISR(INT2_vect)
 {
+    TRACE(TRACE_ID_INT2);
     if (g_callBackPtr_INT2 != NULL_PTR)
     {
         /* Call the callback function in the application after the edge is detected */
         (*g_callBackPtr_INT2)();
     }
+    TRACE(TRACE_ID_INT2 | TRACE_EXIT);
 }
 
 /*******************************************************************************
@@ -8,6 +8,7 @@
 
 #include "gpio.h"  /* Include GPIO header file */
 #include <avr/io.h>  /* Include AVR I/O header file */
+#include <avr/interrupt.h>  /* For cli() */
 #include "../../LIB/common_macros.h"  /* Include common macros header file */
 
 /*******************************************************************************
@@ -349,3 +350,39 @@ uint8 GPIO_readPort(uint8 port_num)
 
     return value;
 }
+
+/*
+ * Description :
+ * Write the pins selected by mask on the required port in one store, the other pins keep their value.
+ * The read-modify-write runs with the interrupts disabled, so an ISR writing other pins of the same
+ * port is never undone and all the masked pins change at the same time.
+ * If the input port number is invalid, the function will not handle the request.
+ * Parameters  :
+ * - port_num: The port number (PORTA_ID, PORTB_ID, PORTC_ID, PORTD_ID).
+ * - mask: The pins to write, one bit per pin.
+ * - value: The new values of the masked pins, the other bits are ignored.
+ */
+void GPIO_writePortMasked(uint8 port_num, uint8 mask, uint8 value)
+{
+    uint8 l_sreg = SREG;
+
+    cli();  /* No interrupt between the read and the write of the port */
+    switch (port_num)
+    {
+    case PORTA_ID:
+        GPIO_WRITE_PORT_MASKED(PORTA_ID, mask, value);
+        break;
+    case PORTB_ID:
+        GPIO_WRITE_PORT_MASKED(PORTB_ID, mask, value);
+        break;
+    case PORTC_ID:
+        GPIO_WRITE_PORT_MASKED(PORTC_ID, mask, value);
+        break;
+    case PORTD_ID:
+        GPIO_WRITE_PORT_MASKED(PORTD_ID, mask, value);
+        break;
+    default:
+        break;  /* Invalid port, do nothing */
+    }
+    SREG = l_sreg;
+}
@@ -7,6 +7,7 @@
  *******************************************************************************/
 
 #include "icu.h"  /* Include ICU header file */
+#include "../../SERVICE/TRACE/trace.h"  /* Include the event trace */
 
 /*******************************************************************************
  *                           Global Variables                                  *
@@ -26,11 +27,13 @@ static volatile void (*g_callBackPtr)(void) = NULL_PTR;
  */
 ISR(TIMER1_CAPT_vect)
 {
+    TRACE(TRACE_ID_TIMER1_CAPT);
     if (g_callBackPtr != NULL_PTR)
     {
         /* Call the callback function in the application after the edge is detected */
         (*g_callBackPtr)();  /* Another method: g_callBackPtr(); */
     }
+    TRACE(TRACE_ID_TIMER1_CAPT | TRACE_EXIT);
 }
 
 /*******************************************************************************
@@ -81,6 +84,26 @@ void ICU_init(const ICU_ConfigType * Config_Ptr)
     SREG |= (1<<7);
 }
 
+/*
+ * Description :
+ * Function to enable the input capture on an already running Timer1.
+ * Unlike ICU_init, the Timer1 clock, mode and counter are left untouched so a
+ * shared free running timebase keeps its time.
+ * Parameters  :
+ * - a_edgeType: The first edge to capture (FALLING or RAISING).
+ */
+void ICU_enable(const ICU_EdgeType a_edgeType)
+{
+    /* Configure ICP1/PD6 as an input pin */
+    DDRD &= ~(1<<PD6);
+
+    /* Select the edge and drop any capture flagged before */
+    ICU_setEdgeDetectionType(a_edgeType);
+
+    /* Enable the Input Capture interrupt */
+    TIMSK |= (1<<TICIE1);
+}
+
 /*
  * Description :
  * Function to set the callback function address.
@@ -107,6 +130,9 @@ void ICU_setEdgeDetectionType(const ICU_EdgeType a_edgeType)
      * ICES1 = 1: Rising edge detection.
      */
     TCCR1B = (TCCR1B & 0xBF) | (a_edgeType<<6);
+
+    /* Changing the edge may set ICF1, clear it so no false capture is reported */
+    TIFR = (1<<ICF1);
 }
 
 /*
@@ -48,6 +48,15 @@ typedef struct
  */
 void ICU_init(const ICU_ConfigType * Config_Ptr);
 
+/*
+ * Description :
+ * Function to enable the input capture on an already running Timer1
+ * without changing its clock, mode or counter.
+ * Parameters  :
+ * - a_edgeType: The first edge to capture (FALLING or RAISING).
+ */
+void ICU_enable(const ICU_EdgeType a_edgeType);
+
 /*
  * Description :
  * Function to set the Call Back function address.
@@ -73,3 +73,48 @@ void PWM_Timer2_Start(const Timer_Configuration * Config_Ptr)
      */
     TCCR2 = (1<<WGM20) | (1<<WGM21) | ((Config_Ptr->mode)<<COM20) | ((Config_Ptr->timer_clock)<<CS20);
 }
+
+/*
+ * Description :
+ * Function to start Fast PWM on the required channel once.
+ * Parameters  :
+ * - channel: The PWM output channel.
+ * - Config_Ptr: Pointer to the Timer configuration structure.
+ */
+void PWM_init(PWM_ChannelType channel, const Timer_Configuration * Config_Ptr)
+{
+    switch (channel)
+    {
+    case PWM_CHANNEL_OC0:
+        PWM_Timer0_Start(Config_Ptr);
+        break;
+
+    case PWM_CHANNEL_OC2:
+        PWM_Timer2_Start(Config_Ptr);
+        break;
+    }
+}
+
+/*
+ * Description :
+ * Function to change the duty cycle of a running PWM channel.
+ * Parameters  :
+ * - channel: The PWM output channel.
+ * - duty: Duty cycle percentage (0% to 100%).
+ */
+void PWM_setDuty(PWM_ChannelType channel, uint8 duty)
+{
+    /* OCR = (duty_cycle * 255) / 100, written once so the buffered update is atomic */
+    uint8 l_compare = ((uint16)duty * 255) / 100;
+
+    switch (channel)
+    {
+    case PWM_CHANNEL_OC0:
+        OCR0 = l_compare;
+        break;
+
+    case PWM_CHANNEL_OC2:
+        OCR2 = l_compare;
+        break;
+    }
+}
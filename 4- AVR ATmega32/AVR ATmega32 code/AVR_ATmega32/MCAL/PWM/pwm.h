@@ -21,6 +21,13 @@ typedef enum
     INVERTING           /* Inverting PWM mode (set OC0/OC2 on compare match) */
 } PWM_Mode;
 
+/* Enum to select the PWM output channel */
+typedef enum
+{
+    PWM_CHANNEL_OC0,    /* Timer0 output on PB3/OC0 */
+    PWM_CHANNEL_OC2     /* Timer2 output on PD7/OC2 */
+} PWM_ChannelType;
+
 /* Structure to hold Timer configuration parameters */
 typedef struct
 {
@@ -49,4 +56,25 @@ void PWM_Timer0_Start(const Timer_Configuration * Config_Ptr);
  */
 void PWM_Timer2_Start(const Timer_Configuration * Config_Ptr);
 
+/*
+ * Description :
+ * Function to start Fast PWM on the required channel once.
+ * The timer is not touched again afterwards, only the duty cycle is changed by PWM_setDuty.
+ * Parameters  :
+ * - channel: The PWM output channel.
+ * - Config_Ptr: Pointer to the Timer configuration structure.
+ */
+void PWM_init(PWM_ChannelType channel, const Timer_Configuration * Config_Ptr);
+
+/*
+ * Description :
+ * Function to change the duty cycle of a running PWM channel.
+ * Only the compare register is written. In Fast PWM mode OCR0/OCR2 are double buffered and
+ * the new value is taken at the end of the current period, so the output never glitches.
+ * Parameters  :
+ * - channel: The PWM output channel.
+ * - duty: Duty cycle percentage (0% to 100%).
+ */
+void PWM_setDuty(PWM_ChannelType channel, uint8 duty);
+
 #endif /* MCAL_PWM_H_ */
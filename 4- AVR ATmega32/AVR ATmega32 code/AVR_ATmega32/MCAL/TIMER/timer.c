@@ -6,6 +6,7 @@
  * Description	: Source file for the TIMER AVR Driver
  *******************************************************************************/
 #include "timer.h"
+#include "../../SERVICE/TRACE/trace.h"
 
 /*******************************************************************************
  *                           Global Variables                                  *
@@ -15,6 +16,14 @@ static volatile void (*g_callBackPtr_timer0)(void) = NULL_PTR;
 static volatile void (*g_callBackPtr_timer1)(void) = NULL_PTR;
 static volatile void (*g_callBackPtr_timer2)(void) = NULL_PTR;
 
+/* Optional dedicated compare match call backs, used when overflow and compare interrupts run together */
+static void (*volatile g_compareCallBackPtr_timer0)(void) = NULL_PTR;
+static void (*volatile g_compareCallBackPtr_timer1)(void) = NULL_PTR;
+static void (*volatile g_compareCallBackPtr_timer2)(void) = NULL_PTR;
+
+/* Call back of the Timer1 compare unit B */
+static void (*volatile g_compareBCallBackPtr_timer1)(void) = NULL_PTR;
+
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
  *******************************************************************************/
@@ -23,11 +32,13 @@ static volatile void (*g_callBackPtr_timer2)(void) = NULL_PTR;
  */
 ISR(TIMER0_OVF_vect)
 {
+	TRACE(TRACE_ID_TIMER0_OVF);
 	if(g_callBackPtr_timer0 != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the overflow interrupt */
 		(*g_callBackPtr_timer0)();
 	}
+	TRACE(TRACE_ID_TIMER0_OVF | TRACE_EXIT);
 }
 
 /*
@@ -35,11 +46,18 @@ ISR(TIMER0_OVF_vect)
  */
 ISR(TIMER0_COMP_vect)
 {
-	if(g_callBackPtr_timer0 != NULL_PTR)
+	TRACE(TRACE_ID_TIMER0_COMP);
+	if(g_compareCallBackPtr_timer0 != NULL_PTR)
+	{
+		/* Call the dedicated compare match Call Back function if one is registered */
+		(*g_compareCallBackPtr_timer0)();
+	}
+	else if(g_callBackPtr_timer0 != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the compare match interrupt */
 		(*g_callBackPtr_timer0)();
 	}
+	TRACE(TRACE_ID_TIMER0_COMP | TRACE_EXIT);
 }
 
 /*
@@ -47,11 +65,13 @@ ISR(TIMER0_COMP_vect)
  */
 ISR(TIMER1_OVF_vect)
 {
+	TRACE(TRACE_ID_TIMER1_OVF);
 	if(g_callBackPtr_timer1 != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the overflow interrupt */
 		(*g_callBackPtr_timer1)();
 	}
+	TRACE(TRACE_ID_TIMER1_OVF | TRACE_EXIT);
 }
 
 /*
@@ -59,11 +79,32 @@ ISR(TIMER1_OVF_vect)
  */
 ISR(TIMER1_COMPA_vect)
 {
-	if(g_callBackPtr_timer1 != NULL_PTR)
+	TRACE(TRACE_ID_TIMER1_COMPA);
+	if(g_compareCallBackPtr_timer1 != NULL_PTR)
+	{
+		/* Call the dedicated compare match Call Back function if one is registered */
+		(*g_compareCallBackPtr_timer1)();
+	}
+	else if(g_callBackPtr_timer1 != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the compare match interrupt */
 		(*g_callBackPtr_timer1)();
 	}
+	TRACE(TRACE_ID_TIMER1_COMPA | TRACE_EXIT);
+}
+
+/*
+ * ISR For Timer1 Compare Match B
+ */
+ISR(TIMER1_COMPB_vect)
+{
+	TRACE(TRACE_ID_TIMER1_COMPB);
+	if(g_compareBCallBackPtr_timer1 != NULL_PTR)
+	{
+		/* Call the Call Back function in the application after the compare match interrupt */
+		(*g_compareBCallBackPtr_timer1)();
+	}
+	TRACE(TRACE_ID_TIMER1_COMPB | TRACE_EXIT);
 }
 
 /*
@@ -71,11 +112,13 @@ ISR(TIMER1_COMPA_vect)
  */
 ISR(TIMER2_OVF_vect)
 {
+	TRACE(TRACE_ID_TIMER2_OVF);
 	if(g_callBackPtr_timer2 != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the overflow interrupt */
 		(*g_callBackPtr_timer2)();
 	}
+	TRACE(TRACE_ID_TIMER2_OVF | TRACE_EXIT);
 }
 
 /*
@@ -83,11 +126,18 @@ ISR(TIMER2_OVF_vect)
  */
 ISR(TIMER2_COMP_vect)
 {
-	if(g_callBackPtr_timer2 != NULL_PTR)
+	TRACE(TRACE_ID_TIMER2_COMP);
+	if(g_compareCallBackPtr_timer2 != NULL_PTR)
+	{
+		/* Call the dedicated compare match Call Back function if one is registered */
+		(*g_compareCallBackPtr_timer2)();
+	}
+	else if(g_callBackPtr_timer2 != NULL_PTR)
 	{
 		/* Call the Call Back function in the application after the compare match interrupt */
 		(*g_callBackPtr_timer2)();
 	}
+	TRACE(TRACE_ID_TIMER2_COMP | TRACE_EXIT);
 }
 
 /*******************************************************************************
@@ -316,3 +366,76 @@ void Timer_setCallBack(void(*a_ptr)(void), Timer_ID_Type timer_type)
 		break;
 	}
 }
+
+/*
+ * Function to set the compare match value of the required Timer and enable its compare interrupt.
+ * The timer mode is not changed, so in normal mode the timer keeps free running and the
+ * compare interrupt fires once each time the counter passes the programmed value.
+ * timer_type: The ID of the timer (Timer1 uses compare unit A).
+ * value: The compare match value.
+ */
+void Timer_setCompareValue(Timer_ID_Type timer_type, uint16 value)
+{
+	switch(timer_type)
+	{
+	case TIMER0_ID:
+		OCR0 = value;
+		TIFR = (1<<OCF0);		/* Clear any stale compare flag before enabling the interrupt */
+		TIMSK |= (1<<OCIE0);
+		break;
+	case TIMER1_ID:
+		OCR1A = value;
+		TIFR = (1<<OCF1A);		/* Clear any stale compare flag before enabling the interrupt */
+		TIMSK |= (1<<OCIE1A);
+		break;
+	case TIMER2_ID:
+		OCR2 = value;
+		TIFR = (1<<OCF2);		/* Clear any stale compare flag before enabling the interrupt */
+		TIMSK |= (1<<OCIE2);
+		break;
+	}
+}
+
+/*
+ * Function to set a dedicated Call Back function for the compare match interrupt of the required Timer.
+ * When set, it is called instead of the common Call Back on compare match, while the overflow
+ * interrupt keeps calling the common one.
+ * a_ptr: Pointer to the callback function.
+ * timer_type: The ID of the timer to set the callback for.
+ */
+void Timer_setCompareCallBack(void(*a_ptr)(void), Timer_ID_Type timer_type)
+{
+	switch(timer_type)
+	{
+	case TIMER0_ID:
+		g_compareCallBackPtr_timer0 = a_ptr;
+		break;
+	case TIMER1_ID:
+		g_compareCallBackPtr_timer1 = a_ptr;
+		break;
+	case TIMER2_ID:
+		g_compareCallBackPtr_timer2 = a_ptr;
+		break;
+	}
+}
+
+/*
+ * Function to set the Timer1 compare unit B match value and enable its interrupt.
+ * Unit B has no effect on the timer mode, so it can run periodic events on a free running Timer1.
+ * value: The compare match value.
+ */
+void Timer1_setCompareBValue(uint16 value)
+{
+	OCR1B = value;
+	TIFR = (1<<OCF1B);		/* Clear any stale compare flag before enabling the interrupt */
+	TIMSK |= (1<<OCIE1B);
+}
+
+/*
+ * Function to set the Call Back function of the Timer1 compare unit B.
+ * a_ptr: Pointer to the callback function.
+ */
+void Timer1_setCompareBCallBack(void(*a_ptr)(void))
+{
+	g_compareBCallBackPtr_timer1 = a_ptr;
+}
@@ -70,4 +70,31 @@ uint16 Timer_getTimerValue(Timer_ID_Type timer_type);
  */
 void Timer_setCallBack(void(*a_ptr)(void), Timer_ID_Type a_timer_ID);
 
+/*
+ * Function to set the compare match value of the required Timer and enable its compare interrupt.
+ * The timer mode is not changed (Timer1 uses compare unit A).
+ * timer_type: The ID of the timer.
+ * value: The compare match value.
+ */
+void Timer_setCompareValue(Timer_ID_Type timer_type, uint16 value);
+
+/*
+ * Function to set a dedicated Call Back function for the compare match interrupt of the required Timer.
+ * a_ptr: Pointer to the callback function.
+ * timer_type: The ID of the timer to set the callback for.
+ */
+void Timer_setCompareCallBack(void(*a_ptr)(void), Timer_ID_Type timer_type);
+
+/*
+ * Function to set the Timer1 compare unit B match value and enable its interrupt.
+ * value: The compare match value.
+ */
+void Timer1_setCompareBValue(uint16 value);
+
+/*
+ * Function to set the Call Back function of the Timer1 compare unit B.
+ * a_ptr: Pointer to the callback function.
+ */
+void Timer1_setCompareBCallBack(void(*a_ptr)(void));
+
 #endif /* MCAL_TIMER_H_ */
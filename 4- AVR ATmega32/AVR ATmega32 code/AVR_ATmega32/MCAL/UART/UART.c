@@ -6,11 +6,26 @@
  * Description	: Source file for the TIMER AVR Driver
  *******************************************************************************/
 #include "../UART/UART.h"
+#include "../../SERVICE/TRACE/trace.h"
 
 /* Callbacks */
 static void (*RxCallback)(uint8) = 0;
 static void (*TxCallback)(void) = 0;
 
+/* Transmit ring buffer, head is written by the producers and tail by the UDRE interrupt */
+#define UART_TX_BUFFER_MASK     (UART_TX_BUFFER_SIZE - 1)
+static uint8 g_txBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint8 g_txHead = 0;
+static volatile uint8 g_txTail = 0;
+static volatile uint16 g_txOverflowCount = 0;
+
+/* Receive ring buffer, single producer (RX interrupt) writes head, single consumer (main loop) writes tail */
+#define UART_RX_BUFFER_MASK     (UART_RX_BUFFER_SIZE - 1)
+static volatile uint8 g_rxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_rxHead = 0;
+static volatile uint8 g_rxTail = 0;
+static volatile uint16 g_rxOverflowCount = 0;
+
 void UART_Init(UART_ConfigType *config)
 {
     /* Set baud rate */
@@ -19,7 +34,7 @@ void UART_Init(UART_ConfigType *config)
     UBRRL = (uint8)ubrr;
 
     /* Set frame format */
-    uint8 ucsrb = (1 << RXEN) | (1 << TXEN);  /* Enable RX and TX */
+    uint8 ucsrb = (1 << RXEN) | (1 << TXEN) | (1 << RXCIE);  /* Enable RX, TX and the RX interrupt feeding the ring buffer */
     uint8 ucsrc = (1 << URSEL);	/* URSEL must be 1 when writing to UCSRC */
 
     /* Data bits */
@@ -44,25 +59,73 @@ void UART_Init(UART_ConfigType *config)
     sei();		/* Enable Global Interrupts */
 }
 
-/* Transmit data */
+/* Transmit data, queued for the UDRE interrupt */
 void UART_Transmit (uint8 data)
 {
-    while (!(UCSRA & (1 << UDRE)));  // Wait for empty transmit buffer
-    UDR = data;
+    UART_write(&data, 1);
 }
 
-/* Receive data */
+uint8 UART_write(const uint8 *buf, uint8 len)
+{
+    uint8 l_sreg = SREG;
+    uint8 l_head;
+    uint8 l_free;
+
+    cli();		/* Producers may run in interrupts too, keep each frame contiguous */
+    l_head = g_txHead;
+    l_free = (g_txTail - l_head - 1) & UART_TX_BUFFER_MASK;
+
+    if (len > l_free)
+    {
+        g_txOverflowCount++;
+        SREG = l_sreg;
+        return FALSE;
+    }
+
+    while (len--)
+    {
+        g_txBuffer[l_head] = *buf++;
+        l_head = (l_head + 1) & UART_TX_BUFFER_MASK;
+    }
+    g_txHead = l_head;
+
+    UCSRB |= (1 << UDRIE);		/* Start (or keep) the UDRE interrupt draining the buffer */
+    SREG = l_sreg;
+
+    return TRUE;
+}
+
+uint8 UART_getTxFree(void)
+{
+    /* Only the UDRE interrupt changes the tail, the room can only grow meanwhile */
+    return (g_txTail - g_txHead - 1) & UART_TX_BUFFER_MASK;
+}
+
+uint16 UART_getTxOverflowCount(void)
+{
+    uint8 l_sreg = SREG;
+    uint16 l_count;
+
+    cli();
+    l_count = g_txOverflowCount;
+    SREG = l_sreg;
+
+    return l_count;
+}
+
+/* Receive data, waits for the RX interrupt to push a byte into the ring buffer */
 uint8 UART_Receive (void)
 {
-    while (!(UCSRA & (1 << RXC)));  // Wait for data to be received
-    return UDR;
+    uint8 l_data;
+
+    while (FALSE == UART_readByte(&l_data));  // Wait for data to be received
+    return l_data;
 }
 
-/* Set RX callback */
+/* Set RX callback, the RX interrupt is already enabled by UART_Init */
 void UART_SetRxCallback(void (*callback)(uint8))
 {
     RxCallback = callback;
-    UCSRB |= (1 << RXCIE);		/* Enable RX interrupt */
 }
 
 /* Set TX callback */
@@ -74,51 +137,123 @@ void UART_SetTxCallback(void (*callback)(void))
 
 ISR (USART_RXC_vect)		/* ISR for RX complete */
 {
+    uint8 l_data;
+    uint8 l_head;
+
+    TRACE(TRACE_ID_USART_RXC);
+    l_data = UDR;
     if (RxCallback)
     {
-        RxCallback(UDR);
+        RxCallback(l_data);
+    }
+    else
+    {
+        l_head = (g_rxHead + 1) & UART_RX_BUFFER_MASK;
+        if (l_head == g_rxTail)
+        {
+            g_rxOverflowCount++;		/* Full, drop the new byte */
+        }
+        else
+        {
+            g_rxBuffer[g_rxHead] = l_data;
+            g_rxHead = l_head;
+        }
+    }
+
+    TRACE(TRACE_ID_USART_RXC | TRACE_EXIT);
+}
+
+uint8 UART_readByte(uint8 *data)
+{
+    uint8 l_tail = g_rxTail;
+
+    if (l_tail == g_rxHead)
+    {
+        return FALSE;
     }
+
+    *data = g_rxBuffer[l_tail];
+    g_rxTail = (l_tail + 1) & UART_RX_BUFFER_MASK;	/* Single byte store, no lock needed */
+
+    return TRUE;
+}
+
+uint16 UART_getRxOverflowCount(void)
+{
+    uint8 l_sreg = SREG;
+    uint16 l_count;
+
+    cli();
+    l_count = g_rxOverflowCount;
+    SREG = l_sreg;
+
+    return l_count;
+}
+
+ISR (USART_UDRE_vect)		/* ISR for TX data register empty */
+{
+    uint8 l_tail = g_txTail;
+
+    TRACE(TRACE_ID_USART_UDRE);
+    if (l_tail == g_txHead)
+    {
+        UCSRB &= ~(1 << UDRIE);		/* Buffer empty, stop until the next UART_write */
+    }
+    else
+    {
+        UDR = g_txBuffer[l_tail];
+        g_txTail = (l_tail + 1) & UART_TX_BUFFER_MASK;
+    }
+    TRACE(TRACE_ID_USART_UDRE | TRACE_EXIT);
 }
 
 ISR (USART_TXC_vect)		/* ISR for TX complete */
 {
+    TRACE(TRACE_ID_USART_TXC);
     if (TxCallback)
     {
         TxCallback();
     }
+    TRACE(TRACE_ID_USART_TXC | TRACE_EXIT);
 }
 
 void UART_SendNumbersWithDelimiter(const uint16* numbers, uint8 count, char delimiter)
 {
+    uint8 frame[UART_TX_BUFFER_SIZE];
+    uint8 length = 0;
     char buffer[10];
     for (uint8 i = 0; i < count; i++)
     {
         itoa(numbers[i], buffer, 10);  /* From integer to string */
         for (uint8 j = 0; buffer[j] != '\0'; j++)
         {
-            UART_Transmit(buffer[j]);
+            frame[length++] = buffer[j];
         }
 
         if (i < count - 1)
         {
-            UART_Transmit(delimiter);
+            frame[length++] = delimiter;
+        }
+
+        if (length > (UART_TX_BUFFER_SIZE - sizeof(buffer)))
+        {
+            break;		/* Keep room for the next number and the new line */
         }
     }
-    UART_Transmit('\n'); 	/* If i want */
+    frame[length++] = '\n'; 	/* If i want */
+
+    UART_write(frame, length);	/* Queue the whole line at once */
 }
 
 void UART_sendByte(uint8 data)
 {
-	while (!( UCSRA & (1<<UDRE)));  // wait until UDR is empty
-	UDR = data;                     // send the data
+	UART_write(&data, 1);  // queue the data, sent by the UDRE interrupt
 }
 
-
 void UART_sendString(const uint8 *str)
 {
-	while(*str != '\0')  // loop until end of string
-	{
-		UART_sendByte(*str);  // send each character
-		str++;  // move to next character
-	}
+	size_t l_length = strlen((const char *)str);
+
+	/* Queued whole or dropped whole (and counted), a line is never cut in the middle */
+	UART_write(str, (l_length > 0xFFu) ? 0xFFu : (uint8)l_length);
 }
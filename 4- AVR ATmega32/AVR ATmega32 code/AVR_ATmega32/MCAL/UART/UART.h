@@ -10,9 +10,16 @@
 
 #include <avr/io.h>
 #include <stdlib.h>  			/* For itoa */
+#include <string.h>  			/* For strlen */
 #include <avr/interrupt.h>
 #include "../../LIB/std_types.h"
 
+/* Transmit ring buffer size, must be a power of 2 (one slot is kept free) */
+#define UART_TX_BUFFER_SIZE     (64u)
+
+/* Receive ring buffer size, must be a power of 2 (one slot is kept free) */
+#define UART_RX_BUFFER_SIZE     (16u)
+
 /* Configuration structure */
 typedef struct
 {
@@ -25,6 +32,7 @@ typedef struct
 /* Function prototypes */
 void UART_Init(UART_ConfigType *config);
 void UART_Transmit(uint8 data);
+/* Wait for the next byte of the receive ring buffer (never returns while a RX callback is set) */
 uint8 UART_Receive(void);
 
 /* Optional: Callbacks for RX and TX interrupts */
@@ -35,6 +43,35 @@ void UART_SendNumbersWithDelimiter(const uint16* numbers, uint8 count, char deli
 
 void UART_sendByte(uint8 data);
 
+/*
+ * Queue a null terminated string as one UART_write frame: a string that does not fit in the
+ * free room of the transmit buffer is dropped whole and counted as an overflow.
+ */
 void UART_sendString(const uint8 *str);
 
+/*
+ * Queue len bytes for interrupt driven transmission and return immediately.
+ * The frame is queued completely or not at all, a dropped frame is counted as an overflow.
+ * Returns TRUE if the frame was queued.
+ */
+uint8 UART_write(const uint8 *buf, uint8 len);
+
+/* Number of frames dropped because the transmit buffer was full */
+uint16 UART_getTxOverflowCount(void);
+
+/* Room left in the transmit buffer, a frame of up to this many bytes is queued by UART_write */
+uint8 UART_getTxFree(void);
+
+/*
+ * Take the oldest received byte, the RX interrupt only pushes bytes into a ring buffer
+ * (unless a RX callback is set). Meant to be drained from the main loop.
+ * The RX interrupt duration shows in the event trace (TRACE_ID_USART_RXC, SERVICE/TRACE)
+ * and in the per vector durations of isvms_bench_simavr.
+ * Returns TRUE if a byte was read into data.
+ */
+uint8 UART_readByte(uint8 *data);
+
+/* Number of bytes dropped because the receive buffer was full */
+uint16 UART_getRxOverflowCount(void);
+
 #endif /* MCAL_UART6_UART_H_ */
@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Module       : Motion
+ * File Name    : motion.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the differential drive motion commands
+ *******************************************************************************/
+#include "motion.h"
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Duty of a wheel speed, rounded to the nearest percent.
+ */
+static sint8 Motion_dutyOf(sint32 speedMM_S)
+{
+	sint32 l_scaled = speedMM_S * 100;
+
+	l_scaled += (l_scaled < 0) ? -(MOTION_FULL_SPEED_MM_S / 2) : (MOTION_FULL_SPEED_MM_S / 2);
+	return (sint8)(l_scaled / MOTION_FULL_SPEED_MM_S);
+}
+
+void Motion_set(sint16 linearMM_S, sint16 angularMRAD_S)
+{
+	/* Half the speed difference between the wheels, mrad/s * mm / 1000 = mm/s */
+	sint32 l_half = ((sint32)angularMRAD_S * MOTION_TRACK_MM) / 2000;
+	sint32 l_right = (sint32)linearMM_S + l_half;
+	sint32 l_left = (sint32)linearMM_S - l_half;
+	sint32 l_peak = (l_right < 0) ? -l_right : l_right;
+	sint32 l_leftAbs = (l_left < 0) ? -l_left : l_left;
+
+	if(l_leftAbs > l_peak)
+	{
+		l_peak = l_leftAbs;
+	}
+
+	/* Saturate: both wheels slow down by the same factor, the curvature is kept */
+	if(l_peak > MOTION_FULL_SPEED_MM_S)
+	{
+		l_right = (l_right * MOTION_FULL_SPEED_MM_S) / l_peak;
+		l_left = (l_left * MOTION_FULL_SPEED_MM_S) / l_peak;
+	}
+
+	DcMotor_setTarget(Motion_dutyOf(l_right), Motion_dutyOf(l_left));
+}
@@ -0,0 +1,42 @@
+/******************************************************************************
+ * Module       : Motion
+ * File Name    : motion.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the differential drive motion commands
+ *******************************************************************************/
+#ifndef SERVICE_MOTION_H_
+#define SERVICE_MOTION_H_
+
+#include "../../HAL/MOTOR/motor.h"
+#include "../../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * The car is commanded by its linear speed v (mm/s, positive forward) and its angular speed w
+ * (mrad/s, positive counter-clockwise, to the left). Each wheel runs at v +/- w * MOTION_TRACK_MM / 2:
+ * 	- right wheel (motor 1): v + w * track / 2
+ * 	- left wheel (motor 2):  v - w * track / 2
+ * A wheel faster than MOTION_FULL_SPEED_MM_S scales both wheels down by the same factor, so the
+ * car keeps the commanded curvature and only goes slower. The wheel speeds become the signed
+ * duties of DcMotor_setTarget, the ramp takes them from the current duties.
+ */
+#define MOTION_TRACK_MM				(140)		/* Distance between the wheels */
+#define MOTION_FULL_SPEED_MM_S		(1000)		/* Wheel speed at 100% duty: SPEED_PI_FULL_DUTY_RPM on 65mm wheels */
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Set the car linear and angular speeds, non-blocking.
+ * 	- linearMM_S: -MOTION_FULL_SPEED_MM_S to MOTION_FULL_SPEED_MM_S, negative is backward.
+ * 	- angularMRAD_S: positive turns left, negative turns right. 1000 * 2 * MOTION_FULL_SPEED_MM_S
+ * 	  / MOTION_TRACK_MM spins the car in place at full speed.
+ */
+void Motion_set(sint16 linearMM_S, sint16 angularMRAD_S);
+
+#endif /* SERVICE_MOTION_H_ */
@@ -0,0 +1,268 @@
+/******************************************************************************
+ * Module       : Parking
+ * File Name    : parking.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the closed loop parallel parking planner
+ *******************************************************************************/
+#include "parking.h"
+
+/*******************************************************************************
+ *                           Definitions                                       *
+ *******************************************************************************/
+/*
+ * Motor 1 drives the right wheel and motor 2 the left one (a right turn runs motor 2 only).
+ * Right wheel forward and left wheel backward pivots the car to the left, the rear to the right.
+ */
+#define PARKING_CENTER_DUTY		(PARKING_DUTY / 2)
+#define PARKING_MM_TO_MS(mm)	(((uint32)(mm) * 1000u) / PARKING_SPEED_MM_S)
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static volatile Parking_StateType g_state = PARKING_IDLE;
+static uint32 g_phaseStart = 0;		/* Entry time of the current phase in ms */
+static Slot_EstimatorType g_estimator;	/* Right side gaps during the search */
+static Slot_GapType g_slot;			/* Last measured slot */
+static sint16 g_alignMM = 0;			/* Planned drive before pivoting, negative is backward */
+static uint32 g_reverseMs = 0;		/* Planned reverse at 45 degrees */
+static uint32 g_pivotMs = 0;			/* Time the first pivot actually ran, the second one mirrors it */
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+/*
+ * Description :
+ * 	- Latest distance of a sensor in mm, the maximum range when it saw no echo.
+ */
+static uint16 Parking_distance(Ultrasonic ultrasonic)
+{
+	Ultrasonic_SampleType l_sample;
+
+	Ultrasonic_getSample(ultrasonic, &l_sample);
+
+	return (TRUE == l_sample.valid) ? l_sample.distanceMM : (ULTRASONIC_MAX_DISTANCE * 10u);
+}
+
+/*
+ * Description :
+ * 	- Switch to a new phase and set its wheel targets.
+ */
+static void Parking_enter(Parking_StateType state)
+{
+	g_state = state;
+	g_phaseStart = Timebase_millis();
+
+	switch(state)
+	{
+	case PARKING_SEARCH:
+		DcMotor_setTarget(PARKING_DUTY, PARKING_DUTY);
+		break;
+	case PARKING_ALIGN:
+		if(g_alignMM >= 0)
+		{
+			DcMotor_setTarget(PARKING_DUTY, PARKING_DUTY);
+		}
+		else
+		{
+			DcMotor_setTarget(-PARKING_DUTY, -PARKING_DUTY);
+		}
+		break;
+	case PARKING_PIVOT_IN:
+		DcMotor_setTarget(PARKING_PIVOT_DUTY, -PARKING_PIVOT_DUTY);
+		break;
+	case PARKING_REVERSE:
+		DcMotor_setTarget(-PARKING_DUTY, -PARKING_DUTY);
+		break;
+	case PARKING_PIVOT_OUT:
+		DcMotor_setTarget(-PARKING_PIVOT_DUTY, PARKING_PIVOT_DUTY);
+		break;
+	case PARKING_CENTER:
+		DcMotor_setTarget(MOTOR_STOP, MOTOR_STOP);
+		break;
+	default:
+		Stop();		/* Finished, one way or another */
+		break;
+	}
+}
+
+void Parking_start(void)
+{
+	SlotEstimator_reset(&g_estimator);
+	g_slot.lengthMM = 0;
+	Parking_enter(PARKING_SEARCH);
+}
+
+void Parking_abort(void)
+{
+	if(TRUE == Parking_isActive())
+	{
+		Parking_enter(PARKING_ABORTED);
+	}
+}
+
+/*
+ * Description :
+ * 	- Plan the entry into a measured slot.
+ * 	- Sideways move: up to the far side of the parked cars line, less if the curb is closer.
+ * 	- Reversing at 45 degrees moves back as much as sideways, the car starts that far ahead
+ * 	  of the middle of the slot. The right sensor (middle of the car) is at the slot end now.
+ */
+static void Parking_plan(void)
+{
+	uint16 l_lateral = g_slot.sideMM + PARKING_CAR_WIDTH_MM;
+
+	if((g_slot.depthMM > PARKING_CURB_MARGIN_MM) && ((g_slot.depthMM - PARKING_CURB_MARGIN_MM) < l_lateral))
+	{
+		l_lateral = g_slot.depthMM - PARKING_CURB_MARGIN_MM;
+	}
+
+	g_alignMM = (sint16)l_lateral - (sint16)(g_slot.lengthMM / 2u) - PARKING_DRIFT_MM;
+	g_reverseMs = PARKING_MM_TO_MS(((uint32)l_lateral * 181u) >> 7);	/* lateral * sqrt(2) */
+}
+
+/*
+ * Description :
+ * 	- Car speed estimated from the wheel duties, PARKING_SPEED_MM_S at PARKING_DUTY.
+ */
+static sint16 Parking_speed(void)
+{
+	sint16 l_duty = (sint16)DcMotor_getDuty(0) + DcMotor_getDuty(1);
+
+	return (sint16)(((sint32)l_duty * (sint32)PARKING_SPEED_MM_S) / (2 * PARKING_DUTY));
+}
+
+/*
+ * Description :
+ * 	- Search phase: measure the right side gaps and plan the entry into the first one that fits.
+ */
+static void Parking_search(uint32 now)
+{
+	Ultrasonic_SampleType l_sample;
+
+	Ultrasonic_getSample(U_right, &l_sample);	/* The estimator skips a sample it already has */
+
+	if(TRUE == SlotEstimator_update(&g_estimator, l_sample.timestamp, l_sample.distanceMM, l_sample.valid,
+			Parking_speed(), &g_slot))
+	{
+		if((g_slot.lengthMM >= PARKING_MIN_SLOT_MM) && (g_slot.confidence >= PARKING_MIN_CONFIDENCE))
+		{
+			Parking_plan();
+			Parking_enter(PARKING_ALIGN);
+			return;
+		}
+	}
+
+	if((now - g_phaseStart) >= PARKING_SEARCH_MAX_MS)
+	{
+		Parking_enter(PARKING_NO_SPACE);
+	}
+}
+
+/*
+ * Description :
+ * 	- Center phase: creep towards the larger gap until both gaps match.
+ */
+static void Parking_center(void)
+{
+	uint16 l_front = Parking_distance(U_forward);
+	uint16 l_rear = Parking_distance(U_backward);
+
+	if((l_front > (l_rear + PARKING_CENTER_TOLERANCE_MM)) && (l_front > PARKING_MARGIN_MM))
+	{
+		DcMotor_setTarget(PARKING_CENTER_DUTY, PARKING_CENTER_DUTY);
+	}
+	else if((l_rear > (l_front + PARKING_CENTER_TOLERANCE_MM)) && (l_rear > PARKING_MARGIN_MM))
+	{
+		DcMotor_setTarget(-PARKING_CENTER_DUTY, -PARKING_CENTER_DUTY);
+	}
+	else
+	{
+		Parking_enter(PARKING_DONE);
+	}
+}
+
+void Parking_task(void)
+{
+	uint32 l_now = Timebase_millis();
+	uint32 l_elapsed = l_now - g_phaseStart;
+	uint8 l_rearBlocked = (Parking_distance(U_backward) <= PARKING_MARGIN_MM) ? TRUE : FALSE;
+
+	if((PARKING_ALIGN <= g_state) && (PARKING_CENTER >= g_state) && (l_elapsed >= PARKING_PHASE_MAX_MS))
+	{
+		/* A phase that never reached its end condition, stop where we are (in the slot once centering) */
+		Parking_enter((PARKING_CENTER == g_state) ? PARKING_UNCENTERED : PARKING_FAILED);
+		return;
+	}
+
+	switch(g_state)
+	{
+	case PARKING_SEARCH:
+		Parking_search(l_now);
+		break;
+
+	case PARKING_ALIGN:
+		if(g_alignMM >= 0)
+		{
+			if((l_elapsed >= PARKING_MM_TO_MS(g_alignMM)) || (Parking_distance(U_forward) <= PARKING_MARGIN_MM))
+			{
+				Parking_enter(PARKING_PIVOT_IN);
+			}
+		}
+		else if((l_elapsed >= PARKING_MM_TO_MS(-g_alignMM)) || (TRUE == l_rearBlocked))
+		{
+			Parking_enter(PARKING_PIVOT_IN);
+		}
+		break;
+
+	case PARKING_PIVOT_IN:
+		if(l_elapsed >= PARKING_PIVOT_MS)
+		{
+			g_pivotMs = l_elapsed;
+			Parking_enter(PARKING_REVERSE);
+		}
+		break;
+
+	case PARKING_REVERSE:
+		if((l_elapsed >= g_reverseMs) || (TRUE == l_rearBlocked))
+		{
+			Parking_enter(PARKING_PIVOT_OUT);
+		}
+		break;
+
+	case PARKING_PIVOT_OUT:
+		if(l_elapsed >= g_pivotMs)
+		{
+			Parking_enter(PARKING_CENTER);
+		}
+		break;
+
+	case PARKING_CENTER:
+		Parking_center();
+		break;
+
+	default:
+		/* Idle or finished */
+		break;
+	}
+}
+
+Parking_StateType Parking_getState(void)
+{
+	return g_state;
+}
+
+uint8 Parking_isActive(void)
+{
+	return ((PARKING_SEARCH <= g_state) && (PARKING_CENTER >= g_state)) ? TRUE : FALSE;
+}
+
+uint16 Parking_getSlotLength(void)
+{
+	return g_slot.lengthMM;
+}
+
+uint8 Parking_getSlotConfidence(void)
+{
+	return g_slot.confidence;
+}
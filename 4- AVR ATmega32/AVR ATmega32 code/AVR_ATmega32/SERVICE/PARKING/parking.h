@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Module       : Parking
+ * File Name    : parking.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the closed loop parallel parking planner
+ *******************************************************************************/
+#ifndef SERVICE_PARKING_H_
+#define SERVICE_PARKING_H_
+
+#include "slot_estimator.h"
+#include "../TIMEBASE/timebase.h"
+#include "../../HAL/MOTOR/motor.h"
+#include "../../HAL/Ultrasonic/ultrasonic_sensor.h"
+#include "../../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * Parallel parking into a slot on the right side with pivot turns (the wheels turn in opposite
+ * directions, the car rotates around its axle), in phases:
+ * 	1. SEARCH:    drive along the parked cars and measure the right side gaps (slot_estimator.h),
+ * 	              the speed is estimated from the wheel duties. Too short or unsure gaps are skipped.
+ * 	2. PLAN:      the car has to move sideways by the distance to the parked cars line plus the car
+ * 	              width (less if the curb is closer). It does so reversing at 45 degrees, which also
+ * 	              moves it back by the same distance, so it first drives to where that ends in the
+ * 	              middle of the slot (ALIGN, forward or backward).
+ * 	3. PIVOT_IN:  turn 45 degrees, rear to the right.
+ * 	4. REVERSE:   reverse the planned distance, or until the rear gap reaches PARKING_MARGIN_MM.
+ * 	5. PIVOT_OUT: turn back for the time PIVOT_IN took, the car is straight again.
+ * 	6. CENTER:    move forward or backward until the front and rear gaps are equal.
+ * Every phase has a time limit. The maneuver runs from Parking_task and can be aborted at any time.
+ * Running out of time in CENTER leaves the car in the slot but not centered: PARKING_UNCENTERED,
+ * not PARKING_DONE. The other phases end in PARKING_FAILED.
+ */
+#define PARKING_TASK_PERIOD_MS		(10u)
+
+#define PARKING_DUTY				(40)		/* Wheel duty when driving */
+#define PARKING_SPEED_MM_S			(400u)		/* Car speed at PARKING_DUTY, calibrated on the car */
+#define PARKING_PIVOT_DUTY			(20)		/* Wheel duty when pivoting */
+#define PARKING_PIVOT_MS			(280u)		/* Time of a 45 degrees pivot, calibrated on the car */
+#define PARKING_DRIFT_MM			(65)		/* Extra forward travel of the pivots and the wheel ramps, calibrated on the car */
+
+#define PARKING_CAR_WIDTH_MM		(160u)
+#define PARKING_MIN_SLOT_MM			(380u)		/* Shortest measured slot to park in, the car length and both margins are 370 */
+#define PARKING_MIN_CONFIDENCE		(50u)		/* Lowest slot measurement confidence, in % */
+#define PARKING_CURB_MARGIN_MM		(30u)		/* Gap left to the curb */
+#define PARKING_MARGIN_MM			(60u)		/* Closest allowed obstacle in front or behind */
+#define PARKING_CENTER_TOLERANCE_MM	(30u)
+
+#define PARKING_SEARCH_MAX_MS		(15000u)	/* Give up when no slot is found */
+#define PARKING_PHASE_MAX_MS		(3000u)		/* Limit of the other phases */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* Planner states, the finished ones follow PARKING_CENTER */
+typedef enum
+{
+	PARKING_IDLE, PARKING_SEARCH, PARKING_ALIGN, PARKING_PIVOT_IN, PARKING_REVERSE, PARKING_PIVOT_OUT,
+	PARKING_CENTER, PARKING_DONE, PARKING_NO_SPACE, PARKING_FAILED, PARKING_ABORTED, PARKING_UNCENTERED
+} Parking_StateType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Start a new maneuver from the search phase, the car has to drive along the parked cars.
+ */
+void Parking_start(void);
+
+/*
+ * Description :
+ * 	- Stop the car and end the maneuver in PARKING_ABORTED, used when a new command arrives.
+ */
+void Parking_abort(void);
+
+/*
+ * Description :
+ * 	- Planner task, called every PARKING_TASK_PERIOD_MS. Does nothing while idle or finished.
+ */
+void Parking_task(void);
+
+/*
+ * Description :
+ * 	- Return the planner state.
+ */
+Parking_StateType Parking_getState(void);
+
+/*
+ * Description :
+ * 	- Return TRUE while a maneuver is running (the motors are driven by the planner).
+ */
+uint8 Parking_isActive(void);
+
+/*
+ * Description :
+ * 	- Return the length in millimetres of the last measured slot (0 before the first one).
+ */
+uint16 Parking_getSlotLength(void);
+
+/*
+ * Description :
+ * 	- Return the confidence (0..100) of the last measured slot.
+ */
+uint8 Parking_getSlotConfidence(void);
+
+#endif /* SERVICE_PARKING_H_ */
@@ -0,0 +1,192 @@
+/******************************************************************************
+ * Module       : Slot Estimator
+ * File Name    : slot_estimator.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the parking slot measurement from the right sensor samples
+ *******************************************************************************/
+#include "slot_estimator.h"
+
+/*******************************************************************************
+ *                           Definitions                                       *
+ *******************************************************************************/
+#define SLOT_MAX_INTERVAL_MS	(60000u)	/* Keeps speed * interval inside 32 bits */
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+void SlotEstimator_reset(Slot_EstimatorType * estimator_Ptr)
+{
+	estimator_Ptr->positionUM = 0;
+	estimator_Ptr->lastSpeed = 0;
+	estimator_Ptr->started = FALSE;
+	estimator_Ptr->inGap = FALSE;
+	estimator_Ptr->run = 0;
+	estimator_Ptr->spikes = 0;
+	estimator_Ptr->sideSeen = FALSE;
+	estimator_Ptr->sideMM = 0;
+	estimator_Ptr->depthMM = 0;
+	estimator_Ptr->runDepthMM = 0;
+}
+
+/*
+ * Description :
+ * 	- Advance the travelled distance to a new sample, mm/s * us = nm, kept in um.
+ */
+static void SlotEstimator_integrate(Slot_EstimatorType * estimator_Ptr, uint32 timestampUs, sint16 speedMM_S)
+{
+	uint32 l_interval = timestampUs - estimator_Ptr->lastTimestamp;	/* Wraps correctly */
+	uint32 l_ms = l_interval / 1000u;
+	sint32 l_speed = ((sint32)estimator_Ptr->lastSpeed + speedMM_S) / 2;
+
+	if(l_ms > SLOT_MAX_INTERVAL_MS)
+	{
+		l_ms = SLOT_MAX_INTERVAL_MS;
+	}
+
+	estimator_Ptr->positionUM += (l_speed * (sint32)l_ms) + ((l_speed * (sint32)(l_interval % 1000u)) / 1000);
+}
+
+/*
+ * Description :
+ * 	- Half the distance between the two samples around the pending edge.
+ */
+static uint32 SlotEstimator_edgeUncertainty(const Slot_EstimatorType * estimator_Ptr)
+{
+	sint32 l_span = estimator_Ptr->edgeAfterUM - estimator_Ptr->edgeBeforeUM;
+
+	return (uint32)((l_span < 0) ? -l_span : l_span) / 2u;
+}
+
+/*
+ * Description :
+ * 	- Fill the gap between the open start edge and the pending end edge.
+ */
+static void SlotEstimator_close(Slot_EstimatorType * estimator_Ptr, Slot_GapType * gap_Ptr)
+{
+	sint32 l_endUM = (estimator_Ptr->edgeBeforeUM + estimator_Ptr->edgeAfterUM) / 2;
+	uint32 l_uncertaintyUM = estimator_Ptr->startUncUM + SlotEstimator_edgeUncertainty(estimator_Ptr);
+	sint32 l_lengthUM = l_endUM - estimator_Ptr->startUM;
+	uint32 l_lengthMM;
+	uint32 l_penalty;
+
+	if(l_lengthUM < 0)
+	{
+		l_lengthUM = -l_lengthUM;	/* Measured while reversing */
+	}
+
+	gap_Ptr->startMM = estimator_Ptr->startUM / 1000;
+	gap_Ptr->endMM = l_endUM / 1000;
+	l_lengthMM = ((uint32)l_lengthUM / 1000u) + SLOT_BEAM_MM;
+	gap_Ptr->lengthMM = (l_lengthMM > 0xFFFFu) ? 0xFFFFu : (uint16)l_lengthMM;
+	gap_Ptr->sideMM = estimator_Ptr->sideMM;
+	gap_Ptr->depthMM = estimator_Ptr->depthMM;
+
+	/* Share of the length the edges are unsure about, then the spikes */
+	l_penalty = (l_uncertaintyUM >= (uint32)l_lengthUM) ? 100u : ((l_uncertaintyUM * 100u) / (uint32)l_lengthUM);
+	l_penalty += (uint32)estimator_Ptr->spikes * SLOT_SPIKE_PENALTY;
+	gap_Ptr->confidence = (l_penalty >= 100u) ? 0u : (uint8)(100u - l_penalty);
+}
+
+uint8 SlotEstimator_update(Slot_EstimatorType * estimator_Ptr, uint32 timestampUs, uint16 distanceMM, uint8 valid,
+		sint16 speedMM_S, Slot_GapType * gap_Ptr)
+{
+	uint8 l_free = ((FALSE == valid) || (distanceMM >= SLOT_FREE_SIDE_MM)) ? TRUE : FALSE;
+	uint16 l_depth = (TRUE == valid) ? distanceMM : 0u;
+	uint8 l_closed = FALSE;
+
+	if(TRUE == estimator_Ptr->started)
+	{
+		if(timestampUs == estimator_Ptr->lastTimestamp)
+		{
+			return FALSE;		/* Same sample polled again */
+		}
+		SlotEstimator_integrate(estimator_Ptr, timestampUs, speedMM_S);
+	}
+	estimator_Ptr->started = TRUE;
+	estimator_Ptr->lastTimestamp = timestampUs;
+	estimator_Ptr->lastSpeed = speedMM_S;
+
+	if(l_free == estimator_Ptr->inGap)
+	{
+		/* Agrees with the current side, a shorter contradicting run was a spike */
+		if((estimator_Ptr->run > 0u) && (TRUE == estimator_Ptr->inGap) && (estimator_Ptr->spikes < 0xFFu))
+		{
+			estimator_Ptr->spikes++;
+		}
+		estimator_Ptr->run = 0;
+		estimator_Ptr->lastUM = estimator_Ptr->positionUM;
+
+		if(TRUE == estimator_Ptr->inGap)
+		{
+			if(l_depth > estimator_Ptr->depthMM)
+			{
+				estimator_Ptr->depthMM = l_depth;
+			}
+		}
+		else if(FALSE == estimator_Ptr->sideSeen)
+		{
+			estimator_Ptr->sideMM = distanceMM;
+			estimator_Ptr->sideSeen = TRUE;
+		}
+		else
+		{
+			/* Smoothed over about 4 samples, a single close spike barely moves it */
+			estimator_Ptr->sideMM = estimator_Ptr->sideMM - (estimator_Ptr->sideMM >> 2) + (distanceMM >> 2);
+		}
+		return FALSE;
+	}
+
+	if((FALSE == estimator_Ptr->inGap) && (FALSE == estimator_Ptr->sideSeen))
+	{
+		return FALSE;		/* Started beside a gap, its start is unknown */
+	}
+
+	if(0u == estimator_Ptr->run)
+	{
+		/* First sample past a possible edge */
+		estimator_Ptr->edgeBeforeUM = estimator_Ptr->lastUM;
+		estimator_Ptr->edgeAfterUM = estimator_Ptr->positionUM;
+		estimator_Ptr->runDepthMM = 0;
+	}
+	if(l_depth > estimator_Ptr->runDepthMM)
+	{
+		estimator_Ptr->runDepthMM = l_depth;
+	}
+	estimator_Ptr->run++;
+
+	if(estimator_Ptr->run >= SLOT_CONFIRM_SAMPLES)
+	{
+		if(FALSE == estimator_Ptr->inGap)
+		{
+			/* Gap opened */
+			estimator_Ptr->startUM = (estimator_Ptr->edgeBeforeUM + estimator_Ptr->edgeAfterUM) / 2;
+			estimator_Ptr->startUncUM = SlotEstimator_edgeUncertainty(estimator_Ptr);
+			estimator_Ptr->depthMM = estimator_Ptr->runDepthMM;
+			estimator_Ptr->spikes = 0;
+			estimator_Ptr->inGap = TRUE;
+		}
+		else
+		{
+			/* Gap closed, the run distance is the side of the next parked car */
+			SlotEstimator_close(estimator_Ptr, gap_Ptr);
+			estimator_Ptr->sideMM = distanceMM;
+			estimator_Ptr->inGap = FALSE;
+			l_closed = TRUE;
+		}
+		estimator_Ptr->run = 0;
+		estimator_Ptr->lastUM = estimator_Ptr->positionUM;
+	}
+
+	return l_closed;
+}
+
+uint8 SlotEstimator_inGap(const Slot_EstimatorType * estimator_Ptr)
+{
+	return estimator_Ptr->inGap;
+}
+
+sint32 SlotEstimator_position(const Slot_EstimatorType * estimator_Ptr)
+{
+	return estimator_Ptr->positionUM / 1000;
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * Module       : Slot Estimator
+ * File Name    : slot_estimator.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the parking slot measurement from the right sensor samples
+ *******************************************************************************/
+#ifndef SERVICE_SLOT_ESTIMATOR_H_
+#define SERVICE_SLOT_ESTIMATOR_H_
+
+#include "../../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * The car drives along the parked cars and every right sensor sample is pushed with its timestamp
+ * and the estimated car speed. The travelled distance is the speed integrated over the sample
+ * intervals, so the slot is measured in millimetres whatever the speed profile.
+ * 	- A sample is free when it saw no echo or reads at least SLOT_FREE_SIDE_MM.
+ * 	- SLOT_CONFIRM_SAMPLES samples in a row are needed to open or close a gap, shorter runs are
+ * 	  spikes: ignored, but counted against the confidence when inside a gap.
+ * 	- An edge lies between the last sample on one side and the first one on the other side, it is
+ * 	  taken in the middle and half that interval is its uncertainty.
+ * 	- The sensor beam sees the parked cars before and after the real edges, SLOT_BEAM_MM is added
+ * 	  back to the measured length.
+ */
+#define SLOT_FREE_SIDE_MM		(200u)
+#define SLOT_CONFIRM_SAMPLES	(2u)
+#define SLOT_BEAM_MM			(50u)
+#define SLOT_SPIKE_PENALTY		(10u)		/* Confidence lost per spike inside the gap */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* A measured gap, positions are the travelled distance since the last reset */
+typedef struct
+{
+	sint32 startMM;			/* Gap start */
+	sint32 endMM;			/* Gap end */
+	uint16 lengthMM;		/* End - start + SLOT_BEAM_MM */
+	uint16 sideMM;			/* Right distance to the parked cars before the gap, smoothed */
+	uint16 depthMM;			/* Farthest right distance inside the gap (the curb), 0 when nothing echoed */
+	uint8 confidence;		/* 0..100, lowered by the edge uncertainties and by spikes */
+} Slot_GapType;
+
+/* Estimator state, one per measured side */
+typedef struct
+{
+	sint32 positionUM;		/* Travelled distance in micrometres */
+	uint32 lastTimestamp;	/* Timestamp of the previous sample in microseconds */
+	sint16 lastSpeed;		/* Speed pushed with the previous sample in mm/s */
+	uint8 started;			/* A sample was pushed since the reset */
+	uint8 inGap;
+	uint8 run;				/* Samples in a row contradicting inGap */
+	uint8 spikes;
+	uint8 sideSeen;			/* An occupied sample was seen, a gap can only start after one */
+	sint32 edgeBeforeUM;	/* Last sample before the pending edge */
+	sint32 edgeAfterUM;		/* First sample after the pending edge */
+	sint32 lastUM;			/* Last sample agreeing with inGap */
+	sint32 startUM;			/* Start of the open gap */
+	uint32 startUncUM;		/* Its uncertainty */
+	uint16 sideMM;
+	uint16 depthMM;
+	uint16 runDepthMM;		/* Depth seen by the pending run */
+} Slot_EstimatorType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Restart the measurement, the travelled distance starts from 0.
+ */
+void SlotEstimator_reset(Slot_EstimatorType * estimator_Ptr);
+
+/*
+ * Description :
+ * 	- Push one right sensor sample. A sample with the same timestamp as the previous one is ignored,
+ * 	  so the caller can poll the latest sample faster than the sensor cycle.
+ * 	- speedMM_S is the car speed when the sample was taken (negative backward), the interval since
+ * 	  the previous sample is integrated with the mean of both speeds.
+ * Returns     :
+ * 	- TRUE when the sample closed a gap, which is then copied to gap_Ptr.
+ */
+uint8 SlotEstimator_update(Slot_EstimatorType * estimator_Ptr, uint32 timestampUs, uint16 distanceMM, uint8 valid,
+		sint16 speedMM_S, Slot_GapType * gap_Ptr);
+
+/*
+ * Description :
+ * 	- Return TRUE while the samples are inside a gap.
+ */
+uint8 SlotEstimator_inGap(const Slot_EstimatorType * estimator_Ptr);
+
+/*
+ * Description :
+ * 	- Return the travelled distance in millimetres since the reset.
+ */
+sint32 SlotEstimator_position(const Slot_EstimatorType * estimator_Ptr);
+
+#endif /* SERVICE_SLOT_ESTIMATOR_H_ */
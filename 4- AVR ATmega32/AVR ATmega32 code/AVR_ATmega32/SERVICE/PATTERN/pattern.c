@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Module       : Pattern
+ * File Name    : pattern.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the non-blocking beep and blink pattern engine
+ *******************************************************************************/
+#include "pattern.h"
+
+/*******************************************************************************
+ *                           Definitions                                       *
+ *******************************************************************************/
+#define PATTERN_CADENCE_STEPS		(2u)
+
+/* Playing state of one channel */
+typedef struct
+{
+	const uint8 * steps;		/* NULL when the channel is off */
+	uint8 length;
+	uint8 loop;
+	uint8 index;				/* Playing step */
+	uint8 remaining;			/* Ticks left in the playing step */
+	uint8 output;				/* Level written to the output */
+	uint8 cadence[PATTERN_CADENCE_STEPS];	/* On and off ticks of Pattern_cadence */
+} Pattern_StateType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static Pattern_StateType g_channels[PATTERN_CHANNELS_NUM];
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Write a channel output, only when its level changes.
+ */
+static void Pattern_write(Pattern_Channel channel, uint8 level)
+{
+	if(level == g_channels[channel].output)
+	{
+		return;
+	}
+	g_channels[channel].output = level;
+
+	if(PATTERN_BUZZER == channel)
+	{
+		if(TRUE == level)
+		{
+			Buzzer_on();
+		}
+		else
+		{
+			Buzzer_off();
+		}
+	}
+	else if(TRUE == level)
+	{
+		LED_on((LED_ID)(channel - PATTERN_RED));	/* Same order as LED_ID */
+	}
+	else
+	{
+		LED_off((LED_ID)(channel - PATTERN_RED));
+	}
+}
+
+/*
+ * Description :
+ * 	- Enter the next step with a duration from index, skipping the 0 steps.
+ * 	- A sequence that ends without looping turns the channel off.
+ */
+static void Pattern_enter(Pattern_Channel channel, uint8 index)
+{
+	Pattern_StateType * l_channel = &g_channels[channel];
+	uint8 l_skipped = 0;
+
+	while(l_skipped <= l_channel->length)
+	{
+		if(index >= l_channel->length)
+		{
+			if(FALSE == l_channel->loop)
+			{
+				break;
+			}
+			index = 0;
+		}
+		if(l_channel->steps[index] != 0)
+		{
+			l_channel->index = index;
+			l_channel->remaining = l_channel->steps[index];
+			Pattern_write(channel, ((index & 1u) == 0) ? TRUE : FALSE);
+			return;
+		}
+		index++;
+		l_skipped++;
+	}
+
+	/* Ended, or only 0 steps */
+	Pattern_stop(channel);
+}
+
+void Pattern_init(void)
+{
+	uint8 i;
+
+	Buzzer_init();
+	LEDS_init();
+	for(i = 0; i < PATTERN_CHANNELS_NUM; i++)
+	{
+		g_channels[i].steps = NULL_PTR;
+		g_channels[i].output = FALSE;
+	}
+}
+
+void Pattern_play(Pattern_Channel channel, const Pattern_Type * pattern_Ptr)
+{
+	g_channels[channel].steps = pattern_Ptr->steps;
+	g_channels[channel].length = pattern_Ptr->length;
+	g_channels[channel].loop = pattern_Ptr->loop;
+	Pattern_enter(channel, 0);
+}
+
+void Pattern_cadence(Pattern_Channel channel, uint8 onTicks, uint8 periodTicks)
+{
+	Pattern_StateType * l_channel = &g_channels[channel];
+
+	if(0 == onTicks)
+	{
+		Pattern_stop(channel);
+		return;
+	}
+
+	l_channel->cadence[0] = onTicks;
+	l_channel->cadence[1] = (periodTicks > onTicks) ? (periodTicks - onTicks) : 0;
+	if(l_channel->steps != l_channel->cadence)
+	{
+		l_channel->steps = l_channel->cadence;
+		l_channel->length = PATTERN_CADENCE_STEPS;
+		l_channel->loop = TRUE;
+		Pattern_enter(channel, 0);
+	}
+	else if(l_channel->remaining > l_channel->cadence[l_channel->index])
+	{
+		/* Shorter now, do not wait for the rest of the old step */
+		l_channel->remaining = l_channel->cadence[l_channel->index];
+		if(0 == l_channel->remaining)
+		{
+			Pattern_enter(channel, l_channel->index + 1);
+		}
+	}
+}
+
+void Pattern_stop(Pattern_Channel channel)
+{
+	g_channels[channel].steps = NULL_PTR;
+	Pattern_write(channel, FALSE);
+}
+
+void Pattern_task(void)
+{
+	uint8 i;
+
+	for(i = 0; i < PATTERN_CHANNELS_NUM; i++)
+	{
+		if(NULL_PTR == g_channels[i].steps)
+		{
+			continue;
+		}
+		if(--g_channels[i].remaining == 0)
+		{
+			Pattern_enter((Pattern_Channel)i, g_channels[i].index + 1);
+		}
+	}
+}
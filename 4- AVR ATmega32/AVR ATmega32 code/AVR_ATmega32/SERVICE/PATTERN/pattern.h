@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Module       : Pattern
+ * File Name    : pattern.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the non-blocking beep and blink pattern engine
+ *******************************************************************************/
+#ifndef SERVICE_PATTERN_H_
+#define SERVICE_PATTERN_H_
+
+#include "../../HAL/BUZZER/buzzer.h"
+#include "../../HAL/3 Leds/leds.h"
+#include "../../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * Every output (the buzzer and the three LEDs) is a channel playing its own pattern, advanced by
+ * Pattern_task every PATTERN_TICK_MS. A pattern is a list of step durations in ticks, the output
+ * is on during the even steps and off during the odd ones, a 0 step is skipped.
+ * 	- A sequence (Pattern_play) plays once or loops, a new one replaces the playing one.
+ * 	- A cadence (Pattern_cadence) loops on for onTicks every periodTicks. Changing it does not
+ * 	  restart it, the new timing is taken at the next step, so it can follow a distance smoothly.
+ * The outputs are only written when they change.
+ */
+#define PATTERN_TICK_MS				(10u)	/* Period the application calls Pattern_task with */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+typedef enum
+{
+	PATTERN_BUZZER, PATTERN_RED, PATTERN_GREEN, PATTERN_BLUE, PATTERN_CHANNELS_NUM
+} Pattern_Channel;
+
+/* A sequence of steps, usually a constant */
+typedef struct
+{
+	const uint8 * steps;	/* Step durations in ticks, starting with an on step */
+	uint8 length;			/* Number of steps */
+	uint8 loop;				/* TRUE: start again after the last step, FALSE: stay off */
+} Pattern_Type;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Set up the buzzer and the LEDs, all channels off.
+ */
+void Pattern_init(void);
+
+/*
+ * Description :
+ * 	- Play a sequence on a channel from its first step. The pattern must stay valid while it plays.
+ */
+void Pattern_play(Pattern_Channel channel, const Pattern_Type * pattern_Ptr);
+
+/*
+ * Description :
+ * 	- Loop on for onTicks every periodTicks on a channel, keeping the current step if it already loops.
+ * 	- onTicks >= periodTicks keeps the output on, onTicks 0 turns the channel off.
+ */
+void Pattern_cadence(Pattern_Channel channel, uint8 onTicks, uint8 periodTicks);
+
+/*
+ * Description :
+ * 	- Turn a channel off.
+ */
+void Pattern_stop(Pattern_Channel channel);
+
+/*
+ * Description :
+ * 	- Advance every channel by one tick, called every PATTERN_TICK_MS.
+ */
+void Pattern_task(void);
+
+#endif /* SERVICE_PATTERN_H_ */
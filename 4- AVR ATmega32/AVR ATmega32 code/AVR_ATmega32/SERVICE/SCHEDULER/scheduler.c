@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Module       : Scheduler
+ * File Name    : scheduler.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the cooperative time triggered scheduler
+ *******************************************************************************/
+#include "scheduler.h"
+#include "../TRACE/trace.h"		/* Task runs on the event trace */
+#if (SCHEDULER_IDLE_SLEEP == TRUE)
+#include <avr/sleep.h>
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static Scheduler_TaskType * g_tasks = NULL_PTR;	/* Application task table */
+static uint8 g_tasksNum = 0;
+static volatile uint16 g_tick = 0;				/* Ticks since Scheduler_init */
+static uint16 g_nextCompare = 0;				/* Timer1 value of the next tick */
+static volatile uint16 g_lateTicks = 0;			/* Ticks whose compare match passed before it was set */
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Tick interrupt: move compare unit B one period ahead and count the tick.
+ * 	- When the interrupt was held off past the next compare point, that match would only come after
+ * 	  a full wrap of Timer1 (32ms): the ticks already due are counted at once and the compare point
+ * 	  moved past the timer.
+ */
+static void Scheduler_tick(void)
+{
+	g_nextCompare += SCHEDULER_TICK_TIMER_TICKS;
+	g_tick++;
+	while((sint16)(g_nextCompare - Timebase_getTicks()) <= 0)
+	{
+		g_nextCompare += SCHEDULER_TICK_TIMER_TICKS;
+		g_tick++;
+		g_lateTicks++;
+	}
+	Timer1_setCompareBValue(g_nextCompare);
+}
+
+void Scheduler_init(Scheduler_TaskType * tasks_Ptr, uint8 tasksNum)
+{
+#if (SCHEDULER_IDLE_SLEEP == TRUE)
+	uint8 l_sreg;
+#endif
+	uint8 i;
+
+	g_tasks = tasks_Ptr;
+	g_tasksNum = tasksNum;
+
+	for(i = 0; i < tasksNum; i++)
+	{
+		g_tasks[i].nextRelease = g_tasks[i].offset;
+	}
+
+	Timebase_init();
+	Timer1_setCompareBCallBack(Scheduler_tick);
+	g_nextCompare = Timebase_getTicks() + SCHEDULER_TICK_TIMER_TICKS;
+	Timer1_setCompareBValue(g_nextCompare);
+
+#if (SCHEDULER_IDLE_SLEEP == TRUE)
+	/* Enabled once, MCUCR is also written by the external interrupts driver */
+	l_sreg = SREG;
+	cli();
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	sleep_enable();
+	SREG = l_sreg;
+#endif
+}
+
+#if (SCHEDULER_IDLE_SLEEP == TRUE)
+/*
+ * Description :
+ * 	- Sleep until the next interrupt, unless a task was released since the dispatch pass.
+ * 	- The interrupts are disabled from the check to the sleep instruction. The instruction after sei
+ * 	  is always executed first, so a tick that came after the check wakes the CPU at once.
+ */
+static void Scheduler_sleep(void)
+{
+	uint8 i;
+
+	cli();
+	for(i = 0; i < g_tasksNum; i++)
+	{
+		if((sint16)(g_tick - g_tasks[i].nextRelease) >= 0)
+		{
+			sei();
+			return;
+		}
+	}
+	sei();
+	sleep_cpu();
+}
+#endif
+
+uint16 Scheduler_getLateTicks(void)
+{
+	uint8 l_sreg = SREG;
+	uint16 l_late;
+
+	cli();
+	l_late = g_lateTicks;
+	SREG = l_sreg;
+
+	return l_late;
+}
+
+uint16 Scheduler_getTick(void)
+{
+	uint8 l_sreg = SREG;
+	uint16 l_tick;
+
+	cli();
+	l_tick = g_tick;
+	SREG = l_sreg;
+
+	return l_tick;
+}
+
+void Scheduler_dispatch(void)
+{
+	Scheduler_TaskType * l_task;
+	uint32 l_start;
+	uint32 l_execution;
+	uint16 l_now;
+	uint8 l_ran = FALSE;
+	uint8 i;
+
+	for(i = 0; i < g_tasksNum; i++)
+	{
+		l_task = &g_tasks[i];
+		l_now = Scheduler_getTick();
+
+		if((sint16)(l_now - l_task->nextRelease) < 0)
+		{
+			/* Not released yet */
+			continue;
+		}
+
+		l_ran = TRUE;
+		TRACE(TRACE_ID_TASK(i));
+		l_start = Timebase_micros();
+		l_task->task();
+		l_execution = Timebase_micros() - l_start;
+		TRACE(TRACE_ID_TASK(i) | TRACE_EXIT);
+
+		if(l_execution > l_task->wcet)
+		{
+			l_task->wcet = (l_execution > 0xFFFFu) ? 0xFFFFu : (uint16)l_execution;
+		}
+
+		l_now = Scheduler_getTick();
+		if((uint16)(l_now - l_task->nextRelease) > l_task->deadline)
+		{
+			l_task->deadlineMisses++;
+		}
+
+		/* Keep the release grid, but do not replay releases missed while late */
+		l_task->nextRelease += l_task->period;
+		while((sint16)(l_now - l_task->nextRelease) >= 0)
+		{
+			l_task->nextRelease += l_task->period;
+			l_task->skippedReleases++;
+		}
+	}
+
+#if (SCHEDULER_IDLE_SLEEP == TRUE)
+	if(FALSE == l_ran)
+	{
+		Scheduler_sleep();
+	}
+#endif
+}
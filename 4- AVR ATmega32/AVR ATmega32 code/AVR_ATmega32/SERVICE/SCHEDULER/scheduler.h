@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Module       : Scheduler
+ * File Name    : scheduler.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the cooperative time triggered scheduler
+ *******************************************************************************/
+#ifndef SERVICE_SCHEDULER_H_
+#define SERVICE_SCHEDULER_H_
+
+#include "../TIMEBASE/timebase.h"
+#include "../../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/* Tick period, generated by Timer1 compare unit B on the free running timebase */
+#define SCHEDULER_TICK_MS			(1u)
+#define SCHEDULER_TICK_TIMER_TICKS	(SCHEDULER_TICK_MS * 1000u * TIMEBASE_TICKS_PER_US)
+
+/*
+ * Idle sleep: when a dispatch pass finds no released task, the CPU sleeps in idle mode until the
+ * next interrupt (the tick at the latest, or the USART, an echo or an encoder edge) and the main
+ * loop checks the tasks again. The timers (PWM and timebase), the USART and the external
+ * interrupts keep running in idle mode.
+ */
+#define SCHEDULER_IDLE_SLEEP		(TRUE)
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/*
+ * Entry of the static task table owned by the application.
+ * Only the first four members are configuration, the rest is run time data
+ * maintained by the scheduler: initialise the table with designated initialisers
+ * (.task, .period, .offset, .deadline) and leave the rest out.
+ */
+typedef struct
+{
+	void (*task)(void);		/* Task function, must run to completion without blocking */
+	uint16 period;			/* Release period in ticks */
+	uint16 offset;			/* First release in ticks after Scheduler_init */
+	uint16 deadline;		/* Allowed ticks from release to completion */
+	uint16 nextRelease;		/* Tick of the next release */
+	uint16 wcet;			/* Worst case execution time seen, in microseconds */
+	uint16 deadlineMisses;	/* Runs that completed after their deadline */
+	uint16 skippedReleases;	/* Releases dropped because the task was still late */
+} Scheduler_TaskType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Start the tick interrupt and schedule the first release of every task.
+ * Parameters  :
+ * 	- tasks_Ptr: The application task table, ordered by priority (first runs first).
+ * 	- tasksNum: The number of tasks in the table.
+ */
+void Scheduler_init(Scheduler_TaskType * tasks_Ptr, uint8 tasksNum);
+
+/*
+ * Description :
+ * 	- Run every released task once, in table order.
+ * 	- With SCHEDULER_IDLE_SLEEP, sleep until the next interrupt when no task was released.
+ * 	- Called repeatedly from the main loop.
+ */
+void Scheduler_dispatch(void);
+
+/*
+ * Description :
+ * 	- Return the number of ticks since Scheduler_init.
+ */
+uint16 Scheduler_getTick(void);
+
+/*
+ * Description :
+ * 	- Return the number of ticks counted late, their compare match had passed when the tick
+ * 	  interrupt ran (held off by other interrupts for over a tick period).
+ */
+uint16 Scheduler_getLateTicks(void);
+
+#endif /* SERVICE_SCHEDULER_H_ */
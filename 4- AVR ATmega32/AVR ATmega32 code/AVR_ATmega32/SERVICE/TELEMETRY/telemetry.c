@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Module       : Telemetry
+ * File Name    : telemetry.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the binary telemetry framing (COBS + CRC-16)
+ *******************************************************************************/
+#include "telemetry.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 g_sequence = 0;			/* Sequence number of the next frame */
+static uint16 g_lastOverflowCount = 0;	/* UART overflow count seen by the previous frame */
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+uint16 Telemetry_crc16(const uint8 * data_Ptr, uint8 length)
+{
+	uint16 l_crc = 0xFFFF;
+	uint8 i;
+
+	while(length--)
+	{
+		l_crc ^= (uint16)(*data_Ptr++) << 8;
+		for(i = 0; i < 8; i++)
+		{
+			l_crc = (l_crc & 0x8000) ? ((l_crc << 1) ^ 0x1021) : (l_crc << 1);
+		}
+	}
+
+	return l_crc;
+}
+
+uint8 Telemetry_cobsEncode(const uint8 * data_Ptr, uint8 length, uint8 * encoded_Ptr)
+{
+	uint8 l_codeIndex = 0;	/* Where the length code of the current block goes */
+	uint8 l_out = 1;
+	uint8 l_code = 1;
+
+	while(length--)
+	{
+		if(0 == *data_Ptr)
+		{
+			/* Close the block, the zero is replaced by the code */
+			encoded_Ptr[l_codeIndex] = l_code;
+			l_codeIndex = l_out++;
+			l_code = 1;
+		}
+		else
+		{
+			encoded_Ptr[l_out++] = *data_Ptr;
+			l_code++;
+		}
+		data_Ptr++;
+	}
+	encoded_Ptr[l_codeIndex] = l_code;
+
+	return l_out;
+}
+
+/*
+ * Description :
+ * 	- Store a 16 bits value little endian.
+ */
+static void Telemetry_put16(uint8 * buffer_Ptr, uint16 value)
+{
+	buffer_Ptr[0] = (uint8)value;
+	buffer_Ptr[1] = (uint8)(value >> 8);
+}
+
+uint8 Telemetry_send(const Telemetry_SampleType * sample_Ptr)
+{
+	uint8 l_frame[TELEMETRY_FRAME_SIZE];
+	uint8 l_encoded[TELEMETRY_ENCODED_SIZE];
+	uint8 l_length;
+	uint16 l_overflowCount = UART_getTxOverflowCount();
+	uint16 l_crc;
+
+	l_frame[0] = g_sequence;
+	Telemetry_put16(&l_frame[1], (uint16)Timebase_millis());
+	Telemetry_put16(&l_frame[3], sample_Ptr->distanceRightMM);
+	Telemetry_put16(&l_frame[5], sample_Ptr->distanceForwardMM);
+	Telemetry_put16(&l_frame[7], sample_Ptr->distanceBackwardMM);
+	l_frame[9] = (uint8)sample_Ptr->motor1Duty;
+	l_frame[10] = (uint8)sample_Ptr->motor2Duty;
+	l_frame[11] = sample_Ptr->flags;
+	if(l_overflowCount != g_lastOverflowCount)
+	{
+		l_frame[11] |= TELEMETRY_FLAG_TX_OVERFLOW;
+		g_lastOverflowCount = l_overflowCount;
+	}
+
+	l_crc = Telemetry_crc16(l_frame, TELEMETRY_PAYLOAD_SIZE);
+	Telemetry_put16(&l_frame[TELEMETRY_PAYLOAD_SIZE], l_crc);
+
+	l_length = Telemetry_cobsEncode(l_frame, TELEMETRY_FRAME_SIZE, l_encoded);
+	l_encoded[l_length++] = 0x00;		/* Frame delimiter */
+
+	g_sequence++;		/* Also on a dropped frame, so the host sees the gap */
+
+	return UART_write(l_encoded, l_length);
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Module       : Telemetry
+ * File Name    : telemetry.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the binary telemetry framing (COBS + CRC-16)
+ *******************************************************************************/
+#ifndef SERVICE_TELEMETRY_H_
+#define SERVICE_TELEMETRY_H_
+
+#include "../TIMEBASE/timebase.h"
+#include "../../MCAL/UART/UART.h"
+#include "../../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * Telemetry mode:
+ * 	- TELEMETRY_MODE_CSV: the ASCII "r,f,b\n" line in centimetres clamped to 99 (mobile application).
+ * 	- TELEMETRY_MODE_BINARY: COBS framed binary sample, see the frame layout below.
+ * Set here or from the compiler command line.
+ */
+#define TELEMETRY_MODE_CSV			(0u)
+#define TELEMETRY_MODE_BINARY		(1u)
+#ifndef TELEMETRY_MODE
+#define TELEMETRY_MODE				TELEMETRY_MODE_CSV
+#endif
+
+/*
+ * Binary frame, all fields little endian:
+ * 	[0]      sequence (uint8, +1 per frame, gaps show lost frames)
+ * 	[1..2]   timestamp in milliseconds (low 16 bits of Timebase_millis)
+ * 	[3..8]   right, forward, backward distances in millimetres (uint16 each)
+ * 	[9..10]  motor 1, motor 2 signed duty (sint8 each)
+ * 	[11]     flags (TELEMETRY_FLAG_x)
+ * 	[12..13] CRC-16/CCITT-FALSE of bytes 0..11
+ * The 14 bytes are COBS encoded (15 bytes) and terminated by a 0x00 delimiter: 16 bytes per frame.
+ */
+#define TELEMETRY_PAYLOAD_SIZE		(12u)
+#define TELEMETRY_FRAME_SIZE		(TELEMETRY_PAYLOAD_SIZE + 2u)		/* Payload + CRC */
+#define TELEMETRY_ENCODED_SIZE		(TELEMETRY_FRAME_SIZE + 2u)		/* COBS overhead + delimiter */
+
+/* Flags byte */
+#define TELEMETRY_FLAG_RIGHT_VALID		(1u << 0)	/* Right sensor saw an echo */
+#define TELEMETRY_FLAG_FORWARD_VALID	(1u << 1)	/* Forward sensor saw an echo */
+#define TELEMETRY_FLAG_BACKWARD_VALID	(1u << 2)	/* Backward sensor saw an echo */
+#define TELEMETRY_FLAG_WARNING			(1u << 3)	/* Obstacle inside the warning zone */
+#define TELEMETRY_FLAG_TX_OVERFLOW		(1u << 4)	/* A previous frame was dropped by the UART */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/* Content of one binary frame, the sequence and timestamp are added by Telemetry_send */
+typedef struct
+{
+	uint16 distanceRightMM;
+	uint16 distanceForwardMM;
+	uint16 distanceBackwardMM;
+	sint8 motor1Duty;
+	sint8 motor2Duty;
+	uint8 flags;
+} Telemetry_SampleType;
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Build, encode and queue one binary frame on the UART.
+ * Returns     :
+ * 	- TRUE if the frame was queued, FALSE if the UART transmit buffer was full.
+ */
+uint8 Telemetry_send(const Telemetry_SampleType * sample_Ptr);
+
+/*
+ * Description :
+ * 	- CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of a buffer.
+ */
+uint16 Telemetry_crc16(const uint8 * data_Ptr, uint8 length);
+
+/*
+ * Description :
+ * 	- COBS encode length bytes, the output has no 0x00 byte and is at most length + 1 bytes
+ * 	  (for length below 254).
+ * Returns     :
+ * 	- The encoded length.
+ */
+uint8 Telemetry_cobsEncode(const uint8 * data_Ptr, uint8 length, uint8 * encoded_Ptr);
+
+#endif /* SERVICE_TELEMETRY_H_ */
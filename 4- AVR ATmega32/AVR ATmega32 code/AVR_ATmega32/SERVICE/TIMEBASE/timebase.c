@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Module       : Timebase
+ * File Name    : timebase.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the free running system timebase (Timer1)
+ *******************************************************************************/
+#include "timebase.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static volatile uint32 g_overflows = 0;		/* Timer1 overflows, upper bits of the tick count */
+static volatile uint32 g_millis = 0;		/* Whole milliseconds at the last overflow */
+static volatile uint16 g_microsRemainder = 0;	/* Microseconds past g_millis at the last overflow (< 1000) */
+static uint8 g_initialized = FALSE;
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Timer1 overflow: advance the extended counters by one overflow period.
+ */
+static void Timebase_overflow(void)
+{
+	g_overflows++;
+	g_millis += TIMEBASE_US_PER_OVERFLOW / 1000u;
+	g_microsRemainder += TIMEBASE_US_PER_OVERFLOW % 1000u;
+	if(g_microsRemainder >= 1000u)
+	{
+		g_microsRemainder -= 1000u;
+		g_millis++;
+	}
+}
+
+/*
+ * Description :
+ * 	- Read the timer and report if an overflow is pending but not yet serviced.
+ * 	- Must be called with interrupts disabled.
+ */
+static uint8 Timebase_readTimer(uint16 * ticks_Ptr)
+{
+	*ticks_Ptr = Timer_getTimerValue(TIMER1_ID);
+
+	/* A wrap that happened while interrupts are disabled shows up as a small count with TOV1 set */
+	return ((TIFR & (1<<TOV1)) && (*ticks_Ptr < 0x8000u)) ? TRUE : FALSE;
+}
+
+void Timebase_init(void)
+{
+	if(TRUE == g_initialized)
+	{
+		return;
+	}
+	g_initialized = TRUE;
+
+	Timer_ConfigType Timer_Configrations = {0, 0, TIMER1_ID, TIMEBASE_TIMER_CLOCK, NORMAL_MODE};
+	Timer_setCallBack(Timebase_overflow, TIMER1_ID);
+	Timer_init(&Timer_Configrations);
+}
+
+uint32 Timebase_micros(void)
+{
+	uint8 l_sreg = SREG;
+	uint16 l_ticks;
+	uint32 l_overflows;
+
+	cli();
+	l_overflows = g_overflows + Timebase_readTimer(&l_ticks);
+	SREG = l_sreg;
+
+	return (l_overflows << (16u - TIMEBASE_TICK_SHIFT)) | (l_ticks >> TIMEBASE_TICK_SHIFT);
+}
+
+uint32 Timebase_millis(void)
+{
+	uint8 l_sreg = SREG;
+	uint16 l_ticks;
+	uint32 l_millis;
+	uint16 l_micros;
+
+	cli();
+	l_millis = g_millis;
+	l_micros = g_microsRemainder;
+	if(TRUE == Timebase_readTimer(&l_ticks))
+	{
+		/* Account the pending overflow the same way the interrupt would */
+		l_millis += TIMEBASE_US_PER_OVERFLOW / 1000u;
+		l_micros += TIMEBASE_US_PER_OVERFLOW % 1000u;
+	}
+	SREG = l_sreg;
+
+	/* l_micros < 2000 and the timer adds < 32768us, so this stays within 16 bits */
+	return l_millis + ((l_micros + (l_ticks >> TIMEBASE_TICK_SHIFT)) / 1000u);
+}
+
+uint16 Timebase_getTicks(void)
+{
+	uint8 l_sreg = SREG;
+	uint16 l_ticks;
+
+	cli();		/* 16 bits timer reads go through the shared TEMP register */
+	l_ticks = Timer_getTimerValue(TIMER1_ID);
+	SREG = l_sreg;
+
+	return l_ticks;
+}
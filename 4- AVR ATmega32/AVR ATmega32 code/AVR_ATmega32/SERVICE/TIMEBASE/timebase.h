@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Module       : Timebase
+ * File Name    : timebase.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the free running system timebase (Timer1)
+ *******************************************************************************/
+#ifndef SERVICE_TIMEBASE_H_
+#define SERVICE_TIMEBASE_H_
+
+#include "../../MCAL/TIMER/timer.h"
+#include "../../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * Timer1 free runs at F_CPU/8 and is never stopped or reset once started:
+ * 	- 0.5us per tick, 16 bits overflow every 32.768ms.
+ * 	- The overflow interrupt extends the counter, micros and millis wrap cleanly at 32 bits.
+ * Drivers share it by reading Timer1 (TCNT1/ICR1) differences and must not reconfigure it,
+ * the compare units and the input capture unit stay free for them.
+ */
+#define TIMEBASE_TIMER_CLOCK		F_CPU_8
+#define TIMEBASE_TICKS_PER_US		(2u)
+#define TIMEBASE_TICK_SHIFT			(1u)		/* log2(TIMEBASE_TICKS_PER_US) */
+#define TIMEBASE_US_PER_OVERFLOW	(32768u)	/* 65536 ticks */
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 	- Start Timer1 free running with the overflow extension.
+ * 	- Safe to call from every driver that needs it, only the first call configures the timer.
+ */
+void Timebase_init(void);
+
+/*
+ * Description :
+ * 	- Return the time since Timebase_init in microseconds (wraps after ~71 minutes).
+ * 	- Safe to call from interrupts and from the main loop.
+ */
+uint32 Timebase_micros(void);
+
+/*
+ * Description :
+ * 	- Return the time since Timebase_init in milliseconds (wraps after ~49 days).
+ * 	- Safe to call from interrupts and from the main loop.
+ */
+uint32 Timebase_millis(void);
+
+/*
+ * Description :
+ * 	- Return the raw 16 bits Timer1 value, for short deltas of less than 32ms.
+ */
+uint16 Timebase_getTicks(void);
+
+#endif /* SERVICE_TIMEBASE_H_ */
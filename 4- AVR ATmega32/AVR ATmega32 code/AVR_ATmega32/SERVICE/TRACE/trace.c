@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Module       : Trace
+ * File Name    : trace.c
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the event trace buffer (ISRs and tasks timeline)
+ *******************************************************************************/
+#include "trace.h"
+
+#if (TRACE_ENABLE == TRUE)
+
+#include "../TELEMETRY/telemetry.h"		/* COBS and CRC-16 of the frames */
+#include "../../MCAL/UART/UART.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ *                           Definitions                                       *
+ *******************************************************************************/
+#define TRACE_BUFFER_MASK			(TRACE_BUFFER_SIZE - 1u)
+#define TRACE_FRAME_MAX_SIZE		(TRACE_HEADER_SIZE + (4u * TRACE_FRAME_EVENTS) + 2u)
+#define TRACE_SEND_MAX_SIZE			(TRACE_FRAME_MAX_SIZE + 3u)		/* COBS overhead + two delimiters */
+
+/* One recorded event */
+typedef struct
+{
+	uint16 id;
+	uint16 ticks;			/* Timer1 count */
+} Trace_EventType;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static Trace_EventType g_events[TRACE_BUFFER_SIZE];
+static volatile uint8 g_head = 0;			/* Where the next event goes */
+static volatile uint8 g_count = 0;			/* Events in the buffer, up to TRACE_BUFFER_SIZE */
+static volatile uint16 g_lost = 0;			/* Events overwritten since the last dump */
+static volatile uint8 g_dumping = FALSE;	/* Recording stopped, the buffer is being sent */
+static uint8 g_dumpNumber = 0;
+static uint8 g_frame = 0;					/* Next frame of the dump */
+
+/*******************************************************************************
+ *                      	Functions Definitions                              *
+ *******************************************************************************/
+void Trace_record(uint16 id)
+{
+	uint8 l_sreg = SREG;
+	uint8 l_head;
+
+	cli();		/* Interrupts record too, keep the events in time order */
+	if(FALSE == g_dumping)
+	{
+		l_head = g_head;
+		g_events[l_head].id = id;
+		g_events[l_head].ticks = TCNT1;
+		g_head = (l_head + 1) & TRACE_BUFFER_MASK;
+		if(g_count < TRACE_BUFFER_SIZE)
+		{
+			g_count++;
+		}
+		else if(g_lost < 0xFFFFu)
+		{
+			g_lost++;
+		}
+	}
+	SREG = l_sreg;
+}
+
+void Trace_dump(void)
+{
+	if(FALSE == g_dumping)
+	{
+		g_frame = 0;
+		g_dumping = TRUE;		/* Single byte store, the buffer is not written from now on */
+	}
+}
+
+/*
+ * Description :
+ * 	- Store a 16 bits value little endian.
+ */
+static void Trace_put16(uint8 * buffer_Ptr, uint16 value)
+{
+	buffer_Ptr[0] = (uint8)value;
+	buffer_Ptr[1] = (uint8)(value >> 8);
+}
+
+void Trace_task(void)
+{
+	uint8 l_frame[TRACE_FRAME_MAX_SIZE];
+	uint8 l_encoded[TRACE_SEND_MAX_SIZE];
+	uint8 l_frames;
+	uint8 l_first;
+	uint8 l_events;
+	uint8 l_left;
+	uint8 l_length;
+	uint8 l_index;
+	uint8 i;
+
+	if((FALSE == g_dumping) || (UART_getTxFree() < TRACE_SEND_MAX_SIZE))
+	{
+		return;
+	}
+
+	/* An empty buffer is still sent as one frame, the host sees the dump */
+	l_frames = (g_count == 0) ? 1 : (uint8)((g_count + TRACE_FRAME_EVENTS - 1) / TRACE_FRAME_EVENTS);
+	l_first = g_frame * TRACE_FRAME_EVENTS;
+	l_left = g_count - l_first;
+	l_events = (l_left < TRACE_FRAME_EVENTS) ? l_left : TRACE_FRAME_EVENTS;
+
+	l_frame[0] = g_dumpNumber;
+	l_frame[1] = g_frame;
+	l_frame[2] = l_frames;
+	Trace_put16(&l_frame[3], g_lost);
+	l_length = TRACE_HEADER_SIZE;
+	for(i = 0; i < l_events; i++)
+	{
+		/* Oldest event first */
+		l_index = (g_head - g_count + l_first + i) & TRACE_BUFFER_MASK;
+		Trace_put16(&l_frame[l_length], g_events[l_index].id);
+		Trace_put16(&l_frame[l_length + 2], g_events[l_index].ticks);
+		l_length += 4;
+	}
+	Trace_put16(&l_frame[l_length], Telemetry_crc16(l_frame, l_length));
+	l_length += 2;
+
+	l_encoded[0] = 0x00;		/* Ends whatever was sent before */
+	l_length = Telemetry_cobsEncode(l_frame, l_length, &l_encoded[1]) + 1;
+	l_encoded[l_length++] = 0x00;
+	UART_write(l_encoded, l_length);
+
+	g_frame++;
+	if(g_frame == l_frames)
+	{
+		/* Done, record again from an empty buffer */
+		g_count = 0;
+		g_lost = 0;
+		g_dumpNumber++;
+		g_dumping = FALSE;
+	}
+}
+
+#endif
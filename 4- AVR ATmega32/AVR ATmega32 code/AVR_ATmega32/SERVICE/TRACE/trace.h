@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Module       : Trace
+ * File Name    : trace.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the event trace buffer (ISRs and tasks timeline)
+ *******************************************************************************/
+#ifndef SERVICE_TRACE_H_
+#define SERVICE_TRACE_H_
+
+#include "../../LIB/std_types.h"
+
+/*******************************************************************************
+ *                                Configurations                               *
+ *******************************************************************************/
+/*
+ * TRACE(id) records a 16 bits event id and the Timer1 count (0.5us ticks of the timebase) into a
+ * RAM ring buffer, the oldest events are overwritten. The interrupts trace their entry and exit,
+ * the scheduler every task run, so the buffer holds the last milliseconds of the CPU timeline.
+ * The Timer1 compare B tick is traced every 1ms, well inside the 32.768ms wrap of the count.
+ * Off by default: the buffer takes a quarter of the 2KB SRAM and every interrupt pays for two
+ * records. Set TRACE_ENABLE to TRUE (here or from the compiler command line) to trace a build.
+ */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE				(FALSE)
+#endif
+#define TRACE_BUFFER_SIZE			(128u)		/* Events, a power of 2 up to 128 (4 bytes each) */
+
+/* Event ids: the exit of an interrupt or a task is its entry id with TRACE_EXIT set */
+#define TRACE_EXIT					(0x8000u)
+
+#define TRACE_ID_INT0				(0x01u)
+#define TRACE_ID_INT1				(0x02u)
+#define TRACE_ID_INT2				(0x03u)
+#define TRACE_ID_TIMER0_OVF			(0x04u)
+#define TRACE_ID_TIMER0_COMP		(0x05u)
+#define TRACE_ID_TIMER1_OVF			(0x06u)
+#define TRACE_ID_TIMER1_COMPA		(0x07u)
+#define TRACE_ID_TIMER1_COMPB		(0x08u)
+#define TRACE_ID_TIMER2_OVF			(0x09u)
+#define TRACE_ID_TIMER2_COMP		(0x0Au)
+#define TRACE_ID_USART_RXC			(0x0Bu)
+#define TRACE_ID_USART_UDRE			(0x0Cu)
+#define TRACE_ID_USART_TXC			(0x0Du)
+#define TRACE_ID_TIMER1_CAPT		(0x0Eu)
+#define TRACE_ID_TASK(index)		(0x100u + (index))	/* Index in the scheduler task table */
+
+/*
+ * Dump, started by Trace_dump and sent by Trace_task: the recording stops and the buffer is sent
+ * oldest event first in frames of up to TRACE_FRAME_EVENTS events, then cleared and restarted.
+ * Frame, all fields little endian:
+ * 	[0]      dump number (uint8, +1 per dump)
+ * 	[1]      frame index in the dump
+ * 	[2]      frames in the dump
+ * 	[3..4]   events overwritten since the previous dump (uint16, saturates)
+ * 	[5..]    events: id (uint16) then Timer1 count (uint16)
+ * 	[last 2] CRC-16/CCITT-FALSE of the bytes before it
+ * It is COBS encoded like the telemetry frames, with a 0x00 delimiter before and after it so it
+ * stands out of the CSV lines. The length (7 + 4 * events) is odd and never that of a telemetry frame.
+ */
+#define TRACE_FRAME_EVENTS			(8u)
+#define TRACE_HEADER_SIZE			(5u)
+#define TRACE_TASK_PERIOD_MS		(10u)
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+#if (TRACE_ENABLE == TRUE)
+
+#define TRACE(id)					Trace_record(id)
+
+/*
+ * Description :
+ * 	- Record one event with the current Timer1 count, nothing while a dump is sent.
+ * 	- Safe to call from interrupts and from the main loop, use the TRACE macro.
+ */
+void Trace_record(uint16 id);
+
+/*
+ * Description :
+ * 	- Stop the recording and start sending the buffer, nothing if a dump is already being sent.
+ */
+void Trace_dump(void);
+
+/*
+ * Description :
+ * 	- Trace task, sends the next frame of a dump when the UART has room for it.
+ * 	- Called every TRACE_TASK_PERIOD_MS.
+ */
+void Trace_task(void);
+
+#else
+
+#define TRACE(id)					((void)0)
+
+#endif
+
+#endif /* SERVICE_TRACE_H_ */
@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Module       : ELF Symbols (host)
+ * File Name    : elf_symbols.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Minimal ELF32 little endian reader for the function symbols
+ *******************************************************************************/
+#include "elf_symbols.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace isvms {
+
+namespace {
+
+constexpr std::uint32_t kSectionSymtab = 2;
+constexpr std::uint8_t kSymbolFunction = 2;
+
+std::uint16_t get16(const std::vector<std::uint8_t> &image, std::size_t offset)
+{
+    return static_cast<std::uint16_t>(image[offset] | (image[offset + 1] << 8));
+}
+
+std::uint32_t get32(const std::vector<std::uint8_t> &image, std::size_t offset)
+{
+    return static_cast<std::uint32_t>(image[offset]) | (static_cast<std::uint32_t>(image[offset + 1]) << 8)
+         | (static_cast<std::uint32_t>(image[offset + 2]) << 16) | (static_cast<std::uint32_t>(image[offset + 3]) << 24);
+}
+
+} // namespace
+
+bool readFunctionSymbols(const std::string &path, std::vector<FunctionSymbol> &functions)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<std::uint8_t> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    functions.clear();
+    /* ELF magic, ELFCLASS32, ELFDATA2LSB */
+    if (image.size() < 52 || image[0] != 0x7F || image[1] != 'E' || image[2] != 'L' || image[3] != 'F'
+        || image[4] != 1 || image[5] != 1)
+    {
+        return false;
+    }
+
+    std::uint32_t sectionOffset = get32(image, 32);
+    std::uint16_t sectionSize = get16(image, 46);
+    std::uint16_t sectionCount = get16(image, 48);
+    if (static_cast<std::size_t>(sectionOffset) + static_cast<std::size_t>(sectionSize) * sectionCount > image.size())
+    {
+        return false;
+    }
+
+    for (std::uint16_t i = 0; i < sectionCount; i++)
+    {
+        std::size_t header = sectionOffset + static_cast<std::size_t>(i) * sectionSize;
+        if (get32(image, header + 4) != kSectionSymtab)
+        {
+            continue;
+        }
+
+        std::uint32_t symbolsOffset = get32(image, header + 16);
+        std::uint32_t symbolsSize = get32(image, header + 20);
+        std::uint32_t stringsSection = get32(image, header + 24);
+        std::uint32_t entrySize = get32(image, header + 36);
+        std::size_t stringsHeader = sectionOffset + static_cast<std::size_t>(stringsSection) * sectionSize;
+        if (entrySize < 16 || stringsSection >= sectionCount
+            || static_cast<std::size_t>(symbolsOffset) + symbolsSize > image.size())
+        {
+            return false;
+        }
+        std::uint32_t stringsOffset = get32(image, stringsHeader + 16);
+        std::uint32_t stringsSize = get32(image, stringsHeader + 20);
+        if (static_cast<std::size_t>(stringsOffset) + stringsSize > image.size())
+        {
+            return false;
+        }
+
+        for (std::uint32_t entry = 0; entry + entrySize <= symbolsSize; entry += entrySize)
+        {
+            std::size_t symbol = symbolsOffset + entry;
+            std::uint32_t nameOffset = get32(image, symbol);
+            if ((image[symbol + 12] & 0x0F) != kSymbolFunction || nameOffset >= stringsSize
+                || get32(image, symbol + 8) == 0)
+            {
+                continue;
+            }
+            FunctionSymbol function;
+            const char *name = reinterpret_cast<const char *>(&image[stringsOffset + nameOffset]);
+            function.name.assign(name, strnlen(name, stringsSize - nameOffset));
+            function.address = get32(image, symbol + 4);
+            function.size = get32(image, symbol + 8);
+            functions.push_back(function);
+        }
+    }
+
+    std::sort(functions.begin(), functions.end(),
+              [](const FunctionSymbol &a, const FunctionSymbol &b) { return a.address < b.address; });
+    return true;
+}
+
+const FunctionSymbol *findFunction(const std::vector<FunctionSymbol> &functions, std::uint32_t address)
+{
+    auto it = std::upper_bound(functions.begin(), functions.end(), address,
+                               [](std::uint32_t value, const FunctionSymbol &f) { return value < f.address; });
+    if (it == functions.begin())
+    {
+        return nullptr;
+    }
+    --it;
+    return (address < it->address + it->size) ? &*it : nullptr;
+}
+
+} // namespace isvms
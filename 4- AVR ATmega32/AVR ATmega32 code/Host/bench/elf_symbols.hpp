@@ -0,0 +1,36 @@
+/******************************************************************************
+ * Module       : ELF Symbols (host)
+ * File Name    : elf_symbols.hpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Minimal ELF32 little endian reader for the function symbols of
+ *                the firmware image (address ranges of every function)
+ *******************************************************************************/
+#ifndef HOST_ELF_SYMBOLS_HPP_
+#define HOST_ELF_SYMBOLS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace isvms {
+
+struct FunctionSymbol
+{
+    std::string name;
+    std::uint32_t address = 0;      /* Byte address in flash */
+    std::uint32_t size = 0;         /* Bytes */
+};
+
+/*
+ * Read the STT_FUNC symbols with a size of an ELF32 file, sorted by address.
+ * Returns false if the file cannot be read or is not a little endian ELF32 file.
+ */
+bool readFunctionSymbols(const std::string &path, std::vector<FunctionSymbol> &functions);
+
+/* Function containing address, nullptr if none (functions must be sorted) */
+const FunctionSymbol *findFunction(const std::vector<FunctionSymbol> &functions, std::uint32_t address);
+
+} // namespace isvms
+
+#endif /* HOST_ELF_SYMBOLS_HPP_ */
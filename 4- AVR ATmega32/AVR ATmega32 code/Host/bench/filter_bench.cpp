@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Module       : Ultrasonic Filter Benchmark (host)
+ * File Name    : filter_bench.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Cost of UltrasonicFilter_update (HAL/Ultrasonic/ultrasonic_filter.c, compiled
+ *                unmodified) on the host: the steady state path (primed, median + EWMA) timed
+ *                over a noisy distance stream, best of several runs, in ns and TSC cycles per
+ *                call. This is a host number, not an AVR cycle count: the AVR estimate in
+ *                ultrasonic_filter.h comes from an operation count. Not a ctest, the time
+ *                depends on the machine.
+ *
+ * Usage        : isvms_filter_bench [calls]
+ *                calls         : updates per run (default 1000000)
+ *******************************************************************************/
+extern "C" {
+#include "ultrasonic_filter.h"
+}
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr int kRuns = 7;
+constexpr std::size_t kSamples = 4096;			/* Power of two, indexed with a mask */
+
+uint64_t cycleCounter()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	unsigned long calls = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000ul;
+	std::vector<uint16> samples(kSamples);
+	std::mt19937 rng(1);
+	std::normal_distribution<double> noise(0.0, 15.0);
+	Ultrasonic_FilterType filter;
+	double bestNs = 1e30;
+	double bestCycles = 1e30;
+	volatile uint16 sink = 0;
+
+	/* A wall at 1 m with noise and a spike every 50 samples, so the median swaps both ways */
+	for (std::size_t i = 0; i < kSamples; i++)
+	{
+		double distance = 1000.0 + noise(rng) + (((i % 50) == 0) ? 1500.0 : 0.0);
+		samples[i] = static_cast<uint16>(distance);
+	}
+
+	UltrasonicFilter_reset(&filter);
+	UltrasonicFilter_update(&filter, samples[0]);
+	for (int run = 0; run < kRuns; run++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		uint64_t startCycles = cycleCounter();
+		for (unsigned long i = 0; i < calls; i++)
+		{
+			sink = UltrasonicFilter_update(&filter, samples[i & (kSamples - 1)]);
+		}
+		uint64_t cycles = cycleCounter() - startCycles;
+		double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		bestNs = (ns / calls < bestNs) ? ns / calls : bestNs;
+		bestCycles = (static_cast<double>(cycles) / calls < bestCycles) ? static_cast<double>(cycles) / calls : bestCycles;
+	}
+
+	std::printf("UltrasonicFilter_update, median %u, EWMA shift %u, host, best of %d x %lu calls\n",
+				ULTRASONIC_FILTER_MEDIAN_N, ULTRASONIC_FILTER_EWMA_SHIFT, kRuns, calls);
+	std::printf("  %6.1f ns per call  %6.1f TSC cycles per call  (last %u mm)\n", bestNs, bestCycles, static_cast<unsigned>(sink));
+	return 0;
+}
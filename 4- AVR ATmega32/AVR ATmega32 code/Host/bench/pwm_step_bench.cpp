@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Module       : PWM Ramp Step Benchmark (host)
+ * File Name    : pwm_step_bench.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : I/O register accesses of the duty update of one ramp step (both wheels) on
+ *                the emulated ATmega32, the restart of the timer done before the update was
+ *                split (PWM_Timer0_Start + PWM_Timer2_Start) against PWM_setDuty on both
+ *                channels. Every access costs AVR_EMU_ACCESS_CYCLES of virtual time, so the
+ *                count is the cycles spent divided by it. The other instructions are not
+ *                counted: this stands in for an instruction count of both paths, which needs the
+ *                avr-gcc image on isvms_bench_simavr (not built, no AVR toolchain or simavr here).
+ *                The exit code is 1 if the update is not cheaper than the restart.
+ *
+ * Usage        : isvms_pwm_step_bench
+ *******************************************************************************/
+#include "avr_emu.h"
+
+#include <cstdio>
+
+namespace {
+
+/* Timer_Configuration with -fshort-enums: mode, timer_clock and duty_cycle are one byte each */
+struct TimerConfiguration
+{
+	uint8_t mode;
+	uint8_t timerClock;
+	uint8_t dutyCycle;
+};
+
+} // namespace
+
+extern "C" void PWM_Timer0_Start(const TimerConfiguration *Config_Ptr);
+extern "C" void PWM_Timer2_Start(const TimerConfiguration *Config_Ptr);
+extern "C" void PWM_init(uint8_t channel, const TimerConfiguration *Config_Ptr);
+extern "C" void PWM_setDuty(uint8_t channel, uint8_t duty);
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr uint8_t kNonInverting = 2;		/* NON_INVERTING */
+constexpr uint8_t kCpuClock = 1;			/* F_CPU_CLOCK */
+constexpr uint8_t kChannelOc0 = 0;			/* PWM_CHANNEL_OC0 */
+constexpr uint8_t kChannelOc2 = 1;			/* PWM_CHANNEL_OC2 */
+constexpr unsigned kSteps = 20;				/* 0 to 100% in MOTOR_RAMP_STEP of 5 */
+
+/* Register accesses per step of the given duty update, both wheels */
+template <typename Update>
+double accessesPerStep(Update update)
+{
+	uint64_t start = avr_emu_cycles();
+
+	for (unsigned step = 1; step <= kSteps; step++)
+	{
+		update(static_cast<uint8_t>(step * 5));
+	}
+	return static_cast<double>(avr_emu_cycles() - start) / AVR_EMU_ACCESS_CYCLES / kSteps;
+}
+
+} // namespace
+
+int main()
+{
+	const TimerConfiguration stopped = {kNonInverting, kCpuClock, 0};
+	double restart;
+	double update;
+
+	/* The functions run from the host, outside of any time slice: only the virtual time advances */
+	avr_emu_reset();
+	PWM_init(kChannelOc0, &stopped);
+	PWM_init(kChannelOc2, &stopped);
+
+	restart = accessesPerStep([](uint8_t duty) {
+		const TimerConfiguration config = {kNonInverting, kCpuClock, duty};
+		PWM_Timer0_Start(&config);
+		PWM_Timer2_Start(&config);
+	});
+	update = accessesPerStep([](uint8_t duty) {
+		PWM_setDuty(kChannelOc0, duty);
+		PWM_setDuty(kChannelOc2, duty);
+	});
+
+	std::printf("I/O register accesses per ramp step (both wheels), not instructions\n");
+	std::printf("  timer restart (before)  %5.1f\n", restart);
+	std::printf("  PWM_setDuty (after)     %5.1f\n", update);
+	std::printf("OCR0 0x%02X OCR2 0x%02X\n", avr_emu_peek(0x3C), avr_emu_peek(0x23));
+	return (update < restart) ? 0 : 1;
+}
@@ -0,0 +1,459 @@
+/******************************************************************************
+ * Module       : simavr Benchmark (host)
+ * File Name    : simavr_bench.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Cycle accurate benchmark of the firmware image (AVR_ATmega32.elf)
+ *                on simavr. Echo pulses are answered on the ultrasonic trigger pins,
+ *                UART commands can be injected, and the results are printed as JSON:
+ *                  - self cycles of every function (from the ELF symbols)
+ *                  - inclusive cycles per call of the watched functions
+ *                  - entry count and duration of every interrupt vector, entry latency
+ *                    of the injected echo edges
+ *                  - period of the main loop (entries of the loop function)
+ *
+ * Status       : never built or run so far: the machines it was written on had neither simavr
+ *                nor avr-gcc, there is no baseline bench.json. The numbers above are not
+ *                available until it is run on a fresh Debug/AVR_ATmega32.elf.
+ *
+ * Usage        : isvms_bench_simavr <AVR_ATmega32.elf> [options]
+ *                  --seconds S          virtual time to run (default 2)
+ *                  --distances R,F,B    right, forward, backward distances in cm (default 80,120,60)
+ *                  --commands STR       bytes sent on the UART (e.g. "F")
+ *                  --command-at MS      when the commands are sent (default 500)
+ *                  --icu                echoes OR-ed into ICP1/PD6 (ULTRASONIC_CAPTURE_ICU build)
+ *                  --loop NAME          loop function (default Scheduler_dispatch)
+ *                  --watch NAME         add a watched function (repeatable)
+ *******************************************************************************/
+#include "elf_symbols.hpp"
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "sim_irq.h"
+#include "sim_cycle_timers.h"
+#include "avr_ioport.h"
+#include "avr_uart.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr std::uint32_t kVectorsNum = 21;           /* ATmega32: reset + 20 vectors, 4 bytes each */
+constexpr std::uint32_t kEchoDelayUs = 200;         /* Trigger end to echo start (8 cycles burst) */
+constexpr std::uint32_t kUsPerCm = 58;
+
+const char *const kVectorNames[kVectorsNum] = {
+    "RESET", "INT0", "INT1", "INT2", "TIMER2_COMP", "TIMER2_OVF", "TIMER1_CAPT", "TIMER1_COMPA",
+    "TIMER1_COMPB", "TIMER1_OVF", "TIMER0_COMP", "TIMER0_OVF", "SPI_STC", "USART_RXC", "USART_UDRE",
+    "USART_TXC", "ADC", "EE_RDY", "ANA_COMP", "TWI", "SPM_RDY"
+};
+
+/* Functions watched by default, the ones on the control path */
+const char *const kDefaultWatch[] = {
+    "Scheduler_dispatch", "readDistance", "collisionAvoidance", "DcMotor_rampTick", "DcMotor_speedTick",
+    "App_commandTask", "App_telemetryTask", "App_lcdTask", "LCD_task", "App_feedbackTask",
+    "Pattern_task", "UltrasonicFilter_update"
+};
+
+struct Stats
+{
+    std::vector<std::uint64_t> samples;
+
+    void add(std::uint64_t value) { samples.push_back(value); }
+
+    void print(FILE *out) const
+    {
+        std::vector<std::uint64_t> sorted(samples);
+        std::sort(sorted.begin(), sorted.end());
+        std::uint64_t sum = 0;
+        for (std::uint64_t v : sorted)
+        {
+            sum += v;
+        }
+        auto at = [&](double q) {
+            return sorted.empty() ? 0 : sorted[static_cast<std::size_t>(q * (sorted.size() - 1))];
+        };
+        std::fprintf(out, "{\"count\": %zu, \"min\": %llu, \"mean\": %.1f, \"p50\": %llu, \"p90\": %llu, "
+                     "\"p99\": %llu, \"max\": %llu}",
+                     sorted.size(), static_cast<unsigned long long>(at(0.0)),
+                     sorted.empty() ? 0.0 : static_cast<double>(sum) / sorted.size(),
+                     static_cast<unsigned long long>(at(0.5)), static_cast<unsigned long long>(at(0.9)),
+                     static_cast<unsigned long long>(at(0.99)), static_cast<unsigned long long>(at(1.0)));
+    }
+};
+
+/* Call in progress of a watched function or an interrupt, ends when pc and sp are back */
+struct Frame
+{
+    std::uint32_t returnAddress;
+    std::uint16_t returnSp;
+    avr_cycle_count_t start;
+};
+
+struct Watch
+{
+    std::string name;
+    std::uint32_t address = 0;
+    std::vector<Frame> active;
+    Stats inclusive;
+};
+
+struct Vector
+{
+    std::uint64_t count = 0;
+    Stats duration;
+    Stats latency;
+};
+
+struct Edge
+{
+    avr_irq_t *irq;         /* Echo input pin */
+    std::uint32_t level;
+    int vector;             /* Vector expected to serve the edge, for the latency */
+};
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+avr_t *g_avr = nullptr;
+avr_irq_t *g_echoIrq[4] = {};                   /* Echo inputs: INT0/PD2, INT1/PD3, INT2/PB2, ICP1/PD6 */
+avr_irq_t *g_uartInput = nullptr;
+std::uint32_t g_distanceCm[3] = {80, 120, 60};  /* Right, forward, backward */
+bool g_icu = false;
+std::string g_commands;
+std::uint64_t g_uartTxBytes = 0;
+avr_cycle_count_t g_injected[kVectorsNum] = {};
+bool g_pending[kVectorsNum] = {};
+Vector g_vectors[kVectorsNum];
+std::vector<Frame> g_isrFrames;                 /* Nested interrupts in progress */
+std::vector<std::uint32_t> g_isrVector;         /* Vector of each frame */
+
+/*******************************************************************************
+ *                              simavr hooks                                   *
+ *******************************************************************************/
+std::uint16_t stackPointer()
+{
+    return static_cast<std::uint16_t>(g_avr->data[R_SPL] | (g_avr->data[R_SPH] << 8));
+}
+
+/* Return address pushed by a call or an interrupt (big endian word address on the stack) */
+std::uint32_t pushedReturnAddress(std::uint16_t sp)
+{
+    return static_cast<std::uint32_t>((g_avr->data[sp + 1] << 8) | g_avr->data[sp + 2]) * 2;
+}
+
+avr_cycle_count_t edgeTimer(avr_t *avr, avr_cycle_count_t, void *param)
+{
+    Edge *edge = static_cast<Edge *>(param);
+
+    avr_raise_irq(edge->irq, edge->level);
+    if (edge->vector > 0 && !g_pending[edge->vector])
+    {
+        g_pending[edge->vector] = true;
+        g_injected[edge->vector] = avr->cycle;
+    }
+    delete edge;
+    return 0;
+}
+
+/* Trigger pin falling edge: answer with an echo of the configured distance */
+void triggerHook(avr_irq_t *irq, std::uint32_t value, void *param)
+{
+    int sensor = static_cast<int>(reinterpret_cast<std::intptr_t>(param));   /* 0 right, 1 forward, 2 backward */
+    std::uint32_t width;
+    int line;
+    int vector;
+
+    if (value != 0 || irq->value == 0 || g_distanceCm[sensor] == 0 || g_distanceCm[sensor] > 400)
+    {
+        return;     /* Not a falling edge, or nothing in range (the firmware times out) */
+    }
+
+    width = g_distanceCm[sensor] * kUsPerCm;
+    if (g_icu)
+    {
+        line = 3;
+        vector = 6;
+    }
+    else
+    {
+        line = (sensor == 2) ? 1 : sensor;    /* Right on INT0, forward and backward on INT1 */
+        vector = line + 1;
+    }
+    avr_cycle_timer_register_usec(g_avr, kEchoDelayUs, edgeTimer, new Edge{g_echoIrq[line], 1, vector});
+    avr_cycle_timer_register_usec(g_avr, kEchoDelayUs + width, edgeTimer, new Edge{g_echoIrq[line], 0, vector});
+}
+
+void uartOutputHook(avr_irq_t *, std::uint32_t, void *)
+{
+    g_uartTxBytes++;
+}
+
+avr_cycle_count_t commandsTimer(avr_t *, avr_cycle_count_t, void *)
+{
+    for (char c : g_commands)
+    {
+        avr_raise_irq(g_uartInput, static_cast<std::uint8_t>(c));
+    }
+    return 0;
+}
+
+void printJsonString(FILE *out, const std::string &text)
+{
+    std::fputc('"', out);
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            std::fputc('\\', out);
+        }
+        std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    double seconds = 2.0;
+    double commandAtMs = 500.0;
+    std::string loopName = "Scheduler_dispatch";
+    std::vector<std::string> watchNames(std::begin(kDefaultWatch), std::end(kDefaultWatch));
+    std::vector<isvms::FunctionSymbol> functions;
+    elf_firmware_t firmware;
+
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <AVR_ATmega32.elf> [--seconds S] [--distances R,F,B] [--commands STR]"
+                     " [--command-at MS] [--icu] [--loop NAME] [--watch NAME]\n", argv[0]);
+        return 2;
+    }
+    for (int i = 2; i < argc; i++)
+    {
+        std::string option = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (option == "--seconds" && hasValue) seconds = std::atof(argv[++i]);
+        else if (option == "--distances" && hasValue)
+            std::sscanf(argv[++i], "%u,%u,%u", &g_distanceCm[0], &g_distanceCm[1], &g_distanceCm[2]);
+        else if (option == "--commands" && hasValue) g_commands = argv[++i];
+        else if (option == "--command-at" && hasValue) commandAtMs = std::atof(argv[++i]);
+        else if (option == "--icu") g_icu = true;
+        else if (option == "--loop" && hasValue) loopName = argv[++i];
+        else if (option == "--watch" && hasValue) watchNames.push_back(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", option.c_str());
+            return 2;
+        }
+    }
+
+    /* Firmware image and symbols */
+    std::memset(&firmware, 0, sizeof(firmware));
+    if (elf_read_firmware(argv[1], &firmware) != 0 || !isvms::readFunctionSymbols(argv[1], functions))
+    {
+        std::fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+    g_avr = avr_make_mcu_by_name(firmware.mmcu[0] ? firmware.mmcu : "atmega32");
+    if (g_avr == nullptr)
+    {
+        std::fprintf(stderr, "unknown mcu\n");
+        return 1;
+    }
+    avr_init(g_avr);
+    avr_load_firmware(g_avr, &firmware);
+    g_avr->frequency = firmware.frequency ? firmware.frequency : 16000000;
+
+    /* Stimuli: echoes on the trigger pins, commands on the UART */
+    for (int sensor = 0; sensor < 3; sensor++)
+    {
+        avr_irq_register_notify(avr_io_getirq(g_avr, AVR_IOCTL_IOPORT_GETIRQ('B'), 5 + sensor), triggerHook,
+                                reinterpret_cast<void *>(static_cast<std::intptr_t>(sensor)));
+    }
+    g_echoIrq[0] = avr_io_getirq(g_avr, AVR_IOCTL_IOPORT_GETIRQ('D'), 2);
+    g_echoIrq[1] = avr_io_getirq(g_avr, AVR_IOCTL_IOPORT_GETIRQ('D'), 3);
+    g_echoIrq[2] = avr_io_getirq(g_avr, AVR_IOCTL_IOPORT_GETIRQ('B'), 2);
+    g_echoIrq[3] = avr_io_getirq(g_avr, AVR_IOCTL_IOPORT_GETIRQ('D'), 6);
+    g_uartInput = avr_io_getirq(g_avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+    avr_irq_register_notify(avr_io_getirq(g_avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), uartOutputHook,
+                            nullptr);
+#ifdef AVR_UART_FLAG_STDIO
+    {
+        std::uint32_t flags = 0;
+        avr_ioctl(g_avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+        flags &= ~AVR_UART_FLAG_STDIO;      /* Keep stdout for the JSON */
+        avr_ioctl(g_avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+    }
+#endif
+    if (!g_commands.empty())
+    {
+        avr_cycle_timer_register_usec(g_avr, static_cast<std::uint32_t>(commandAtMs * 1000.0), commandsTimer,
+                                      nullptr);
+    }
+
+    /* Watched functions */
+    std::vector<Watch> watches;
+    Watch *loopWatch = nullptr;
+    std::vector<std::uint64_t> selfCycles(functions.size() + 1, 0);     /* Last slot: outside any function */
+    std::uint64_t sleepCycles = 0;
+    for (const std::string &name : watchNames)
+    {
+        for (const isvms::FunctionSymbol &f : functions)
+        {
+            if (f.name == name)
+            {
+                Watch w;
+                w.name = name;
+                w.address = f.address;
+                watches.push_back(w);
+                break;
+            }
+        }
+    }
+    for (Watch &w : watches)
+    {
+        if (w.name == loopName)
+        {
+            loopWatch = &w;
+        }
+    }
+    Stats loopPeriod;
+    avr_cycle_count_t lastLoop = 0;
+
+    /* Run, one instruction per step */
+    const avr_cycle_count_t end = static_cast<avr_cycle_count_t>(seconds * g_avr->frequency);
+    while (g_avr->cycle < end)
+    {
+        std::uint32_t pcBefore = g_avr->pc;
+        avr_cycle_count_t cycleBefore = g_avr->cycle;
+        bool sleeping = (g_avr->state == cpu_Sleeping);
+        int state = avr_run(g_avr);
+        if (state == cpu_Done || state == cpu_Crashed)
+        {
+            break;
+        }
+
+        std::uint64_t spent = g_avr->cycle - cycleBefore;
+        if (sleeping)
+        {
+            sleepCycles += spent;
+        }
+        else
+        {
+            const isvms::FunctionSymbol *f = isvms::findFunction(functions, pcBefore);
+            selfCycles[f ? static_cast<std::size_t>(f - functions.data()) : functions.size()] += spent;
+        }
+
+        std::uint32_t pc = g_avr->pc;
+        std::uint16_t sp = stackPointer();
+
+        /* Interrupt entry: execution lands on a vector slot */
+        if (pc != pcBefore && pc > 0 && pc < kVectorsNum * 4 && (pc % 4) == 0 && pcBefore >= kVectorsNum * 4)
+        {
+            std::uint32_t vector = pc / 4;
+            g_vectors[vector].count++;
+            g_isrFrames.push_back(Frame{pushedReturnAddress(sp), static_cast<std::uint16_t>(sp + 2), g_avr->cycle});
+            g_isrVector.push_back(vector);
+            if (g_pending[vector])
+            {
+                g_vectors[vector].latency.add(g_avr->cycle - g_injected[vector]);
+                g_pending[vector] = false;
+            }
+        }
+        else if (!g_isrFrames.empty() && pc == g_isrFrames.back().returnAddress && sp == g_isrFrames.back().returnSp)
+        {
+            /* Interrupt return (reti), the duration includes the vector jump and the prologue */
+            g_vectors[g_isrVector.back()].duration.add(g_avr->cycle - g_isrFrames.back().start);
+            g_isrFrames.pop_back();
+            g_isrVector.pop_back();
+        }
+
+        /* Watched functions: entry on the first instruction, exit when the return address is reached */
+        for (Watch &w : watches)
+        {
+            if (pc == w.address && pcBefore != w.address)
+            {
+                w.active.push_back(Frame{pushedReturnAddress(sp), static_cast<std::uint16_t>(sp + 2), cycleBefore});
+                if (&w == loopWatch)
+                {
+                    if (lastLoop != 0)
+                    {
+                        loopPeriod.add(cycleBefore - lastLoop);
+                    }
+                    lastLoop = cycleBefore;
+                }
+            }
+            else if (!w.active.empty() && pc == w.active.back().returnAddress && sp == w.active.back().returnSp)
+            {
+                w.inclusive.add(g_avr->cycle - w.active.back().start);
+                w.active.pop_back();
+            }
+        }
+    }
+
+    /* Report */
+    FILE *out = stdout;
+    std::fprintf(out, "{\n  \"firmware\": ");
+    printJsonString(out, argv[1]);
+    std::fprintf(out, ",\n  \"frequency\": %u,\n  \"cycles\": %llu,\n  \"sleep_cycles\": %llu,\n"
+                 "  \"uart_tx_bytes\": %llu,\n",
+                 static_cast<unsigned>(g_avr->frequency), static_cast<unsigned long long>(g_avr->cycle),
+                 static_cast<unsigned long long>(sleepCycles), static_cast<unsigned long long>(g_uartTxBytes));
+
+    std::fprintf(out, "  \"loop\": {\"function\": ");
+    printJsonString(out, loopName);
+    std::fprintf(out, ", \"period_cycles\": ");
+    loopPeriod.print(out);
+    std::fprintf(out, "},\n  \"calls\": {");
+    for (std::size_t i = 0; i < watches.size(); i++)
+    {
+        std::fprintf(out, "%s\n    ", i ? "," : "");
+        printJsonString(out, watches[i].name);
+        std::fprintf(out, ": ");
+        watches[i].inclusive.print(out);
+    }
+    std::fprintf(out, "\n  },\n  \"interrupts\": {");
+    bool first = true;
+    for (std::uint32_t v = 1; v < kVectorsNum; v++)
+    {
+        if (g_vectors[v].count == 0)
+        {
+            continue;
+        }
+        std::fprintf(out, "%s\n    \"%s\": {\"count\": %llu, \"duration_cycles\": ", first ? "" : ",", kVectorNames[v],
+                     static_cast<unsigned long long>(g_vectors[v].count));
+        g_vectors[v].duration.print(out);
+        std::fprintf(out, ", \"latency_cycles\": ");
+        g_vectors[v].latency.print(out);
+        std::fprintf(out, "}");
+        first = false;
+    }
+    std::fprintf(out, "\n  },\n  \"self_cycles\": {");
+    first = true;
+    for (std::size_t i = 0; i < functions.size(); i++)
+    {
+        if (selfCycles[i] == 0)
+        {
+            continue;
+        }
+        std::fprintf(out, "%s\n    ", first ? "" : ",");
+        printJsonString(out, functions[i].name);
+        std::fprintf(out, ": %llu", static_cast<unsigned long long>(selfCycles[i]));
+        first = false;
+    }
+    std::fprintf(out, "%s\n    \"<unknown>\": %llu\n  }\n}\n", first ? "" : ",",
+                 static_cast<unsigned long long>(selfCycles[functions.size()]));
+
+    return 0;
+}
@@ -0,0 +1,829 @@
+/******************************************************************************
+ * Module       : AVR Emulator (host)
+ * File Name    : avr_emu.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Emulated ATmega32 register file, peripherals and interrupt
+ *                controller used to run the firmware unmodified on a host
+ *******************************************************************************/
+#include "avr_emu.h"
+
+#include <ucontext.h>
+
+#include <cstring>
+#include <map>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include <avr/io.h>		/* Bit names only, the register macros are not used here */
+
+/*******************************************************************************
+ *                            Interrupt vectors                                *
+ *******************************************************************************/
+/* Unused vectors, the firmware ISR definitions take precedence */
+extern "C" {
+#define AVR_EMU_DEFAULT_VECTOR(n) __attribute__((weak)) void __vector_##n(void) {}
+AVR_EMU_DEFAULT_VECTOR(1) AVR_EMU_DEFAULT_VECTOR(2) AVR_EMU_DEFAULT_VECTOR(3) AVR_EMU_DEFAULT_VECTOR(4)
+AVR_EMU_DEFAULT_VECTOR(5) AVR_EMU_DEFAULT_VECTOR(6) AVR_EMU_DEFAULT_VECTOR(7) AVR_EMU_DEFAULT_VECTOR(8)
+AVR_EMU_DEFAULT_VECTOR(9) AVR_EMU_DEFAULT_VECTOR(10) AVR_EMU_DEFAULT_VECTOR(11) AVR_EMU_DEFAULT_VECTOR(12)
+AVR_EMU_DEFAULT_VECTOR(13) AVR_EMU_DEFAULT_VECTOR(14) AVR_EMU_DEFAULT_VECTOR(15) AVR_EMU_DEFAULT_VECTOR(16)
+AVR_EMU_DEFAULT_VECTOR(17) AVR_EMU_DEFAULT_VECTOR(18) AVR_EMU_DEFAULT_VECTOR(19) AVR_EMU_DEFAULT_VECTOR(20)
+#undef AVR_EMU_DEFAULT_VECTOR
+}
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/*
+ * Register accesses are lazy: an accessor first brings the emulator up to date (it also
+ * handles the write done by the previous access, found by comparing the I/O space with a
+ * shadow copy), then returns the address of the register for the firmware to read or write.
+ * A write that is an action on its own (UDR, write one to clear flags) cannot be found that
+ * way, those registers are kept in 16 bits slots holding 0x100 | value: a firmware write
+ * clears the marker bit, an access that leaves the marker set is a read.
+ */
+namespace {
+
+enum : uint8_t
+{
+	A_UBRRL = 0x09, A_UCSRB = 0x0A, A_UCSRA = 0x0B, A_UDR = 0x0C,
+	A_PIND = 0x10, A_PINC = 0x13, A_PINB = 0x16, A_PINA = 0x19,
+	A_UBRRH = 0x20, A_OCR2 = 0x23, A_TCNT2 = 0x24, A_TCCR2 = 0x25,
+	A_ICR1 = 0x26, A_OCR1B = 0x28, A_OCR1A = 0x2A, A_TCNT1 = 0x2C,
+	A_TCCR1B = 0x2E, A_TCCR1A = 0x2F, A_TCNT0 = 0x32, A_TCCR0 = 0x33,
+	A_MCUCSR = 0x34, A_MCUCR = 0x35, A_TIFR = 0x38, A_TIMSK = 0x39,
+	A_GIFR = 0x3A, A_GICR = 0x3B, A_OCR0 = 0x3C, A_SREG = 0x3F
+};
+
+/* PINx address of each port, DDRx and PORTx follow it */
+const uint8_t kPinAddress[4] = {A_PINA, A_PINB, A_PINC, A_PIND};
+
+const uint32_t kTimer01Prescaler[8] = {0, 1, 8, 64, 256, 1024, 0, 0};	/* 6, 7: external clock, not emulated */
+const uint32_t kTimer2Prescaler[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+
+struct Strobe
+{
+	uint16_t slot;
+	bool accessed;
+};
+
+/* Up counting timer, the PWM modes are emulated with their period only */
+struct Timer
+{
+	uint32_t count = 0;
+	uint64_t last = 0;				/* Cycle the timer was last brought up to date */
+	uint32_t ocrA = 0;				/* Active compare values (the registers hold the buffers) */
+	uint32_t ocrB = 0;
+};
+
+struct Uart
+{
+	bool shiftBusy = false;
+	uint8_t shiftData = 0;
+	uint64_t shiftDone = 0;
+	bool bufferFull = false;
+	uint8_t bufferData = 0;
+	bool txc = false;
+	bool rxFull = false;
+	uint8_t rxData = 0;
+	uint64_t lastArrival = 0;
+	std::deque<std::pair<uint64_t, uint8_t>> rxQueue;
+	uint8_t ubrrh = 0;
+	uint8_t ucsrc = 0x86;
+};
+
+struct Event
+{
+	AvrEmu_Event event;
+	void *context;
+};
+
+alignas(2) uint8_t g_io[64];
+uint8_t g_shadow[64];
+Strobe g_udr, g_tifrSlot, g_gifrSlot;
+uint8_t g_tifr = 0;
+uint8_t g_gifr = 0;
+
+uint64_t g_now = 0;					/* CPU time */
+uint64_t g_sleepCycles = 0;			/* Part of g_now spent sleeping */
+uint64_t g_vectorsRun = 0;			/* Interrupts executed, a sleep ends on the next one */
+uint64_t g_periphTime = 0;			/* Time the peripherals are up to date with */
+bool g_inIsr = false;
+
+Timer g_timer0, g_timer1, g_timer2;
+Uart g_uart;
+uint8_t g_inputs[4] = {0xFF, 0xFF, 0xFF, 0xFF};		/* Floating inputs read high (pull ups) */
+uint8_t g_levels[4] = {0, 0, 0, 0};
+std::multimap<uint64_t, Event> g_events;
+
+AvrEmu_PinHook g_pinHook = nullptr;
+void *g_pinHookContext = nullptr;
+AvrEmu_UartHook g_uartHook = nullptr;
+void *g_uartHookContext = nullptr;
+
+/* Firmware context */
+ucontext_t g_hostContext;
+ucontext_t g_firmwareContext;
+std::vector<char> g_firmwareStack;
+void (*g_entry)(void) = nullptr;
+bool g_running = false;
+bool g_finished = false;
+uint64_t g_sliceEnd = 0;
+
+/*******************************************************************************
+ *                               Helpers                                       *
+ *******************************************************************************/
+uint16_t io16(uint8_t address)
+{
+	return static_cast<uint16_t>(g_io[address] | (g_io[address + 1] << 8));
+}
+
+void setIo16(uint8_t address, uint16_t value)
+{
+	g_io[address] = static_cast<uint8_t>(value);
+	g_io[address + 1] = static_cast<uint8_t>(value >> 8);
+}
+
+bool changed(uint8_t address)
+{
+	return g_io[address] != g_shadow[address];
+}
+
+bool changed16(uint8_t address)
+{
+	return changed(address) || changed(address + 1);
+}
+
+/* TRUE if the counter passes position pos while moving n steps from c in a period */
+bool crosses(uint32_t c, uint64_t n, uint32_t pos, uint32_t period)
+{
+	if (pos >= period || n == 0)
+	{
+		return false;
+	}
+	if (n >= period)
+	{
+		return true;
+	}
+	return ((pos + period - c - 1) % period) < n;
+}
+
+uint64_t ticksSince(uint64_t from, uint64_t to, uint32_t prescaler)
+{
+	return (prescaler == 0) ? 0 : (to / prescaler - from / prescaler);
+}
+
+/*******************************************************************************
+ *                               Timers                                        *
+ *******************************************************************************/
+/* Timer0 and Timer2 share the layout: WGMx0 bit 6, WGMx1 bit 3, CS bits 2:0 */
+void advanceTimer8(Timer &t, uint8_t tccr, uint8_t ocrAddress, const uint32_t *prescalers,
+		uint8_t tovBit, uint8_t ocfBit, uint64_t to)
+{
+	uint64_t n = ticksSince(t.last, to, prescalers[tccr & 0x07]);
+	uint8_t mode = static_cast<uint8_t>(((tccr >> 6) & 1) | (((tccr >> 3) & 1) << 1));
+	bool pwm = (mode == 1) || (mode == 3);
+	uint32_t top = (mode == 2) ? t.ocrA : 0xFF;
+	uint32_t period = top + 1;
+
+	t.last = to;
+	if (n == 0)
+	{
+		return;
+	}
+	if (crosses(t.count, n, t.ocrA, period))
+	{
+		g_tifr |= static_cast<uint8_t>(1 << ocfBit);
+	}
+	bool wrap = crosses(t.count, n, 0, period);
+	if (wrap && (top == 0xFF))
+	{
+		g_tifr |= static_cast<uint8_t>(1 << tovBit);
+	}
+	if (wrap && pwm)
+	{
+		t.ocrA = g_io[ocrAddress];		/* Double buffered compare in the PWM modes */
+	}
+	t.count = static_cast<uint32_t>((t.count + n) % period);
+}
+
+uint8_t timer1Mode()
+{
+	return static_cast<uint8_t>((g_io[A_TCCR1A] & 0x03) | (((g_io[A_TCCR1B] >> 3) & 0x03) << 2));
+}
+
+uint32_t timer1Top(uint8_t mode)
+{
+	switch (mode)
+	{
+	case 1: case 5: return 0xFF;
+	case 2: case 6: return 0x1FF;
+	case 3: case 7: return 0x3FF;
+	case 4: case 9: case 11: case 15: return g_timer1.ocrA;
+	case 8: case 10: case 12: case 14: return io16(A_ICR1);
+	default: return 0xFFFF;
+	}
+}
+
+bool timer1Buffered(uint8_t mode)
+{
+	return (mode != 0) && (mode != 4) && (mode != 12);
+}
+
+void advanceTimer1(uint64_t to)
+{
+	Timer &t = g_timer1;
+	uint64_t n = ticksSince(t.last, to, kTimer01Prescaler[g_io[A_TCCR1B] & 0x07]);
+	uint8_t mode = timer1Mode();
+	uint32_t top = timer1Top(mode);
+	uint32_t period = top + 1;
+
+	t.last = to;
+	if (n == 0)
+	{
+		return;
+	}
+	if (crosses(t.count, n, t.ocrA, period))
+	{
+		g_tifr |= (1 << OCF1A);
+	}
+	if (crosses(t.count, n, t.ocrB, period))
+	{
+		g_tifr |= (1 << OCF1B);
+	}
+	bool wrap = crosses(t.count, n, 0, period);
+	if (wrap && (top == 0xFFFF || ((mode != 4) && (mode != 12))))
+	{
+		g_tifr |= (1 << TOV1);
+	}
+	if (wrap && timer1Buffered(mode))
+	{
+		t.ocrA = io16(A_OCR1A);
+		t.ocrB = io16(A_OCR1B);
+	}
+	t.count = static_cast<uint32_t>((t.count + n) % period);
+}
+
+/*******************************************************************************
+ *                               USART                                         *
+ *******************************************************************************/
+uint64_t uartFrameCycles()
+{
+	uint32_t ubrr = static_cast<uint32_t>(((g_uart.ubrrh & 0x0F) << 8) | g_io[A_UBRRL]);
+	uint32_t perBit = ((g_io[A_UCSRA] & (1 << U2X)) ? 8u : 16u) * (ubrr + 1);
+	uint32_t dataBits = 5 + ((g_uart.ucsrc >> UCSZ0) & 0x03) + ((g_io[A_UCSRB] & (1 << UCSZ2)) ? 4 : 0);
+	uint32_t bits = 1 + (dataBits > 9 ? 9 : dataBits) + ((g_uart.ucsrc & (1 << UPM1)) ? 1 : 0)
+			+ ((g_uart.ucsrc & (1 << USBS)) ? 2 : 1);
+	return static_cast<uint64_t>(perBit) * bits;
+}
+
+void uartWrite(uint8_t data)
+{
+	if (!(g_io[A_UCSRB] & (1 << TXEN)))
+	{
+		return;
+	}
+	if (!g_uart.shiftBusy)
+	{
+		g_uart.shiftBusy = true;
+		g_uart.shiftData = data;
+		g_uart.shiftDone = g_periphTime + uartFrameCycles();
+	}
+	else if (!g_uart.bufferFull)
+	{
+		g_uart.bufferFull = true;
+		g_uart.bufferData = data;
+	}
+	/* Else: written while UDRE was clear, lost as on the target */
+}
+
+void advanceUart(uint64_t to)
+{
+	while (g_uart.shiftBusy && g_uart.shiftDone <= to)
+	{
+		if (g_uartHook)
+		{
+			g_uartHook(g_uartHookContext, g_uart.shiftData);
+		}
+		if (g_uart.bufferFull)
+		{
+			g_uart.bufferFull = false;
+			g_uart.shiftData = g_uart.bufferData;
+			g_uart.shiftDone += uartFrameCycles();
+		}
+		else
+		{
+			g_uart.shiftBusy = false;
+			g_uart.txc = true;
+		}
+	}
+
+	if (!g_uart.rxFull && !g_uart.rxQueue.empty() && g_uart.rxQueue.front().first <= to)
+	{
+		if (g_io[A_UCSRB] & (1 << RXEN))
+		{
+			g_uart.rxFull = true;
+			g_uart.rxData = g_uart.rxQueue.front().second;
+		}
+		g_uart.rxQueue.pop_front();
+	}
+}
+
+/*******************************************************************************
+ *                            Pins and external interrupts                     *
+ *******************************************************************************/
+void edge(AvrEmu_Port port, uint8_t pin, uint8_t level)
+{
+	uint8_t mcucr = g_io[A_MCUCR];
+	uint8_t sense;
+
+	if (port == AVR_EMU_PORTD && pin == 2)
+	{
+		sense = mcucr & 0x03;
+		if ((sense == 1) || (sense == 2 && !level) || (sense == 3 && level))
+		{
+			g_gifr |= (1 << INTF0);
+		}
+	}
+	else if (port == AVR_EMU_PORTD && pin == 3)
+	{
+		sense = (mcucr >> 2) & 0x03;
+		if ((sense == 1) || (sense == 2 && !level) || (sense == 3 && level))
+		{
+			g_gifr |= (1 << INTF1);
+		}
+	}
+	else if (port == AVR_EMU_PORTB && pin == 2)
+	{
+		if (((g_io[A_MCUCSR] >> ISC2) & 1) == level)
+		{
+			g_gifr |= (1 << INTF2);
+		}
+	}
+	else if (port == AVR_EMU_PORTD && pin == 6)
+	{
+		uint8_t mode = timer1Mode();
+		if (((g_io[A_TCCR1B] >> ICES1) & 1) == level && mode != 8 && mode != 10 && mode != 12 && mode != 14)
+		{
+			setIo16(A_ICR1, static_cast<uint16_t>(g_timer1.count));
+			g_shadow[A_ICR1] = g_io[A_ICR1];
+			g_shadow[A_ICR1 + 1] = g_io[A_ICR1 + 1];
+			g_tifr |= (1 << ICF1);
+		}
+	}
+}
+
+uint8_t portLevels(int port)
+{
+	uint8_t ddr = g_io[kPinAddress[port] + 1];
+	uint8_t out = g_io[kPinAddress[port] + 2];
+	return static_cast<uint8_t>((ddr & out) | (~ddr & g_inputs[port]));
+}
+
+void updatePins()
+{
+	for (int port = 0; port < 4; port++)
+	{
+		uint8_t levels = portLevels(port);
+		uint8_t ddr = g_io[kPinAddress[port] + 1];
+		uint8_t diff = static_cast<uint8_t>((levels ^ g_levels[port]) & ddr);
+		g_levels[port] = levels;
+		for (uint8_t pin = 0; pin < 8 && diff; pin++)
+		{
+			if ((diff & (1 << pin)) && g_pinHook)
+			{
+				g_pinHook(g_pinHookContext, static_cast<AvrEmu_Port>(port), pin, (levels >> pin) & 1);
+			}
+		}
+	}
+}
+
+/*******************************************************************************
+ *                            Emulator core                                    *
+ *******************************************************************************/
+void advancePeripherals(uint64_t to)
+{
+	advanceTimer8(g_timer0, g_io[A_TCCR0], A_OCR0, kTimer01Prescaler, TOV0, OCF0, to);
+	advanceTimer1(to);
+	advanceTimer8(g_timer2, g_io[A_TCCR2], A_OCR2, kTimer2Prescaler, TOV2, OCF2, to);
+	advanceUart(to);
+	g_periphTime = to;
+}
+
+void advanceTo(uint64_t to)
+{
+	/* Events run in time order, with the peripherals up to date at their time */
+	while (!g_events.empty() && g_events.begin()->first <= to)
+	{
+		auto it = g_events.begin();
+		Event e = it->second;
+		uint64_t at = it->first < g_periphTime ? g_periphTime : it->first;
+		g_events.erase(it);
+		advancePeripherals(at);
+		e.event(e.context);
+	}
+	advancePeripherals(to);
+}
+
+void handleStrobe(Strobe &s, uint8_t address)
+{
+	if (s.slot < 0x100)
+	{
+		uint8_t value = static_cast<uint8_t>(s.slot);
+		if (address == A_UDR)
+		{
+			uartWrite(value);
+		}
+		else if (address == A_TIFR)
+		{
+			g_tifr &= static_cast<uint8_t>(~value);
+		}
+		else
+		{
+			g_gifr &= static_cast<uint8_t>(~value);
+		}
+	}
+	else if (s.accessed && address == A_UDR)
+	{
+		g_uart.rxFull = false;		/* Reading UDR empties the receive buffer */
+	}
+	s.accessed = false;
+}
+
+void processWrites()
+{
+	bool pwm;
+
+	handleStrobe(g_udr, A_UDR);
+	handleStrobe(g_tifrSlot, A_TIFR);
+	handleStrobe(g_gifrSlot, A_GIFR);
+
+	if (changed(A_TCNT0)) g_timer0.count = g_io[A_TCNT0];
+	if (changed(A_TCNT2)) g_timer2.count = g_io[A_TCNT2];
+	if (changed16(A_TCNT1)) g_timer1.count = io16(A_TCNT1);
+
+	pwm = (g_io[A_TCCR0] & (1 << WGM00)) != 0;
+	if (changed(A_OCR0) && !pwm) g_timer0.ocrA = g_io[A_OCR0];
+	pwm = (g_io[A_TCCR2] & (1 << WGM20)) != 0;
+	if (changed(A_OCR2) && !pwm) g_timer2.ocrA = g_io[A_OCR2];
+	pwm = timer1Buffered(timer1Mode());
+	if (changed16(A_OCR1A) && !pwm) g_timer1.ocrA = io16(A_OCR1A);
+	if (changed16(A_OCR1B) && !pwm) g_timer1.ocrB = io16(A_OCR1B);
+
+	if (changed(A_UBRRH))
+	{
+		if (g_io[A_UBRRH] & (1 << URSEL))
+		{
+			g_uart.ucsrc = g_io[A_UBRRH];
+		}
+		else
+		{
+			g_uart.ubrrh = g_io[A_UBRRH];
+		}
+	}
+	if (changed(A_UCSRA) && (g_io[A_UCSRA] & (1 << TXC)))
+	{
+		g_uart.txc = false;		/* Write one to clear */
+	}
+
+	updatePins();
+}
+
+void publish()
+{
+	g_io[A_TCNT0] = static_cast<uint8_t>(g_timer0.count);
+	g_io[A_TCNT2] = static_cast<uint8_t>(g_timer2.count);
+	setIo16(A_TCNT1, static_cast<uint16_t>(g_timer1.count));
+	g_io[A_UCSRA] = static_cast<uint8_t>((g_io[A_UCSRA] & (1 << U2X)) | (g_uart.rxFull ? (1 << RXC) : 0)
+			| (g_uart.txc ? (1 << TXC) : 0) | (g_uart.bufferFull ? 0 : (1 << UDRE)));
+	for (int port = 0; port < 4; port++)
+	{
+		g_io[kPinAddress[port]] = portLevels(port);
+	}
+	g_udr.slot = static_cast<uint16_t>(0x100 | g_uart.rxData);
+	g_tifrSlot.slot = static_cast<uint16_t>(0x100 | g_tifr);
+	g_gifrSlot.slot = static_cast<uint16_t>(0x100 | g_gifr);
+	std::memcpy(g_shadow, g_io, sizeof(g_io));
+}
+
+bool levelInterrupt(uint8_t senseShift, uint8_t pin)
+{
+	return (((g_io[A_MCUCR] >> senseShift) & 0x03) == 0) && !((g_levels[AVR_EMU_PORTD] >> pin) & 1);
+}
+
+/* Highest priority pending vector (lowest number), 0 if none */
+int pendingVector()
+{
+	uint8_t gicr = g_io[A_GICR];
+	uint8_t timsk = g_io[A_TIMSK];
+	uint8_t ucsrb = g_io[A_UCSRB];
+	uint8_t active = static_cast<uint8_t>(timsk & g_tifr);
+
+	if ((gicr & (1 << INT0)) && ((g_gifr & (1 << INTF0)) || levelInterrupt(0, 2))) return 1;
+	if ((gicr & (1 << INT1)) && ((g_gifr & (1 << INTF1)) || levelInterrupt(2, 3))) return 2;
+	if ((gicr & (1 << INT2)) && (g_gifr & (1 << INTF2))) return 3;
+	if (active & (1 << OCF2)) return 4;
+	if (active & (1 << TOV2)) return 5;
+	if (active & (1 << ICF1)) return 6;
+	if (active & (1 << OCF1A)) return 7;
+	if (active & (1 << OCF1B)) return 8;
+	if (active & (1 << TOV1)) return 9;
+	if (active & (1 << OCF0)) return 10;
+	if (active & (1 << TOV0)) return 11;
+	if ((ucsrb & (1 << RXCIE)) && g_uart.rxFull) return 13;
+	if ((ucsrb & (1 << UDRIE)) && !g_uart.bufferFull) return 14;
+	if ((ucsrb & (1 << TXCIE)) && g_uart.txc) return 15;
+	return 0;
+}
+
+void noVector(void) {}
+
+void (*const g_vectors[21])(void) = {
+	noVector, __vector_1, __vector_2, __vector_3, __vector_4, __vector_5, __vector_6, __vector_7,
+	__vector_8, __vector_9, __vector_10, __vector_11, __vector_12, __vector_13, __vector_14,
+	__vector_15, __vector_16, __vector_17, __vector_18, __vector_19, __vector_20
+};
+
+void dispatch()
+{
+	static const uint8_t kFlag[16] = {0, INTF0, INTF1, INTF2, OCF2, TOV2, ICF1, OCF1A, OCF1B, TOV1, OCF0, TOV0};
+	int vector;
+
+	while (!g_inIsr && (g_io[A_SREG] & (1 << SREG_I)) && (vector = pendingVector()) != 0)
+	{
+		/* Flags cleared by hardware when the vector is executed */
+		if (vector <= 3)
+		{
+			g_gifr &= static_cast<uint8_t>(~(1 << kFlag[vector]));
+		}
+		else if (vector <= 11)
+		{
+			g_tifr &= static_cast<uint8_t>(~(1 << kFlag[vector]));
+		}
+		else if (vector == 15)
+		{
+			g_uart.txc = false;
+		}
+
+		g_inIsr = true;
+		g_vectorsRun++;
+		g_io[A_SREG] &= static_cast<uint8_t>(~(1 << SREG_I));
+		publish();
+		g_now += AVR_EMU_ISR_CYCLES;
+
+		g_vectors[vector]();
+
+		/* reti: take the last write of the ISR into account, then enable the interrupts again */
+		processWrites();
+		advanceTo(g_now);
+		g_io[A_SREG] |= (1 << SREG_I);
+		publish();
+		g_inIsr = false;
+	}
+}
+
+void sync(uint64_t cost)
+{
+	g_now += cost;
+	processWrites();
+	advanceTo(g_now);
+	publish();
+	dispatch();
+
+	if (g_running && g_now >= g_sliceEnd)
+	{
+		g_running = false;
+		swapcontext(&g_firmwareContext, &g_hostContext);
+	}
+}
+
+void trampoline()
+{
+	g_entry();
+	g_finished = true;
+	g_running = false;
+}
+
+} // namespace
+
+/*******************************************************************************
+ *                            Firmware side API                                *
+ *******************************************************************************/
+extern "C" volatile uint8_t *avr_emu_io8(uint8_t address)
+{
+	sync(AVR_EMU_ACCESS_CYCLES);
+	return &g_io[address & 0x3F];
+}
+
+extern "C" volatile uint16_t *avr_emu_io16(uint8_t address)
+{
+	sync(AVR_EMU_ACCESS_CYCLES);
+	return reinterpret_cast<volatile uint16_t *>(&g_io[address & 0x3E]);
+}
+
+extern "C" volatile uint16_t *avr_emu_strobe(uint8_t address)
+{
+	Strobe &s = (address == A_UDR) ? g_udr : (address == A_TIFR) ? g_tifrSlot : g_gifrSlot;
+
+	sync(AVR_EMU_ACCESS_CYCLES);
+	s.accessed = true;
+	return &s.slot;
+}
+
+extern "C" void avr_emu_delayCycles(uint64_t cycles)
+{
+	while (cycles > 0)
+	{
+		uint64_t step = cycles < AVR_EMU_DELAY_STEP ? cycles : AVR_EMU_DELAY_STEP;
+		sync(step);
+		cycles -= step;
+	}
+}
+
+extern "C" void avr_emu_sleep(void)
+{
+	uint64_t vectors = g_vectorsRun;
+
+	/* The sleep instruction itself, a write of SREG just before (sei) takes effect here */
+	sync(1);
+	if (!(g_io[A_MCUCR] & (1 << SE)) || g_vectorsRun != vectors)
+	{
+		return;
+	}
+
+	while (g_vectorsRun == vectors)
+	{
+		g_sleepCycles += AVR_EMU_DELAY_STEP;
+		sync(AVR_EMU_DELAY_STEP);
+	}
+}
+
+extern "C" char *itoa(int value, char *string, int radix)
+{
+	char digits[34];
+	unsigned int magnitude = (value < 0 && radix == 10) ? 0u - static_cast<unsigned int>(value)
+			: static_cast<unsigned int>(value);
+	int length = 0;
+	char *out = string;
+
+	if (radix < 2 || radix > 36)
+	{
+		*string = '\0';
+		return string;
+	}
+	do
+	{
+		unsigned int digit = magnitude % static_cast<unsigned int>(radix);
+		digits[length++] = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+		magnitude /= static_cast<unsigned int>(radix);
+	} while (magnitude);
+	if (value < 0 && radix == 10)
+	{
+		*out++ = '-';
+	}
+	while (length)
+	{
+		*out++ = digits[--length];
+	}
+	*out = '\0';
+	return string;
+}
+
+/*******************************************************************************
+ *                              Host side API                                  *
+ *******************************************************************************/
+extern "C" void avr_emu_reset(void)
+{
+	std::memset(g_io, 0, sizeof(g_io));
+	g_tifr = 0;
+	g_gifr = 0;
+	g_now = 0;
+	g_sleepCycles = 0;
+	g_periphTime = 0;
+	g_inIsr = false;
+	g_timer0 = Timer();
+	g_timer1 = Timer();
+	g_timer2 = Timer();
+	g_uart = Uart();
+	std::memset(g_inputs, 0xFF, sizeof(g_inputs));
+	std::memset(g_levels, 0, sizeof(g_levels));
+	g_events.clear();
+	g_io[A_UCSRA] = (1 << UDRE);
+	g_udr.accessed = g_tifrSlot.accessed = g_gifrSlot.accessed = false;
+	publish();
+	for (int port = 0; port < 4; port++)
+	{
+		g_levels[port] = portLevels(port);
+	}
+}
+
+extern "C" void avr_emu_start(void (*entry)(void))
+{
+	g_entry = entry;
+	g_finished = false;
+	g_firmwareStack.assign(1 << 20, 0);
+	getcontext(&g_firmwareContext);
+	g_firmwareContext.uc_stack.ss_sp = g_firmwareStack.data();
+	g_firmwareContext.uc_stack.ss_size = g_firmwareStack.size();
+	g_firmwareContext.uc_link = &g_hostContext;
+	makecontext(&g_firmwareContext, trampoline, 0);
+}
+
+extern "C" void avr_emu_runFor(uint64_t cycles)
+{
+	if (g_finished || g_entry == nullptr)
+	{
+		return;
+	}
+	g_sliceEnd = g_now + cycles;
+	g_running = true;
+	swapcontext(&g_hostContext, &g_firmwareContext);
+	g_running = false;
+}
+
+extern "C" uint8_t avr_emu_finished(void)
+{
+	return g_finished ? 1 : 0;
+}
+
+extern "C" uint64_t avr_emu_cycles(void)
+{
+	return g_now;
+}
+
+extern "C" double avr_emu_seconds(void)
+{
+	return static_cast<double>(g_now) / static_cast<double>(AVR_EMU_F_CPU);
+}
+
+extern "C" uint64_t avr_emu_sleepCycles(void)
+{
+	return g_sleepCycles;
+}
+
+extern "C" void avr_emu_setInput(AvrEmu_Port port, uint8_t pin, uint8_t level)
+{
+	uint8_t mask = static_cast<uint8_t>(1 << pin);
+	uint8_t old = (g_inputs[port] & mask) ? 1 : 0;
+
+	level = level ? 1 : 0;
+	if (old == level)
+	{
+		return;
+	}
+	g_inputs[port] = static_cast<uint8_t>(level ? (g_inputs[port] | mask) : (g_inputs[port] & ~mask));
+	if (!(g_io[kPinAddress[port] + 1] & mask))
+	{
+		g_levels[port] = static_cast<uint8_t>(level ? (g_levels[port] | mask) : (g_levels[port] & ~mask));
+		edge(port, pin, level);
+	}
+	g_io[kPinAddress[port]] = portLevels(port);
+	g_shadow[kPinAddress[port]] = g_io[kPinAddress[port]];
+}
+
+extern "C" uint8_t avr_emu_getPin(AvrEmu_Port port, uint8_t pin)
+{
+	return (portLevels(port) >> pin) & 1;
+}
+
+extern "C" void avr_emu_setPinHook(AvrEmu_PinHook hook, void *context)
+{
+	g_pinHook = hook;
+	g_pinHookContext = context;
+}
+
+extern "C" void avr_emu_uartInject(const uint8_t *data, size_t length)
+{
+	uint64_t frame = uartFrameCycles();
+	uint64_t at = g_uart.lastArrival > g_now ? g_uart.lastArrival : g_now;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		at += frame;
+		g_uart.rxQueue.emplace_back(at, data[i]);
+	}
+	g_uart.lastArrival = at;
+}
+
+extern "C" void avr_emu_setUartHook(AvrEmu_UartHook hook, void *context)
+{
+	g_uartHook = hook;
+	g_uartHookContext = context;
+}
+
+extern "C" void avr_emu_schedule(uint64_t cycle, AvrEmu_Event event, void *context)
+{
+	g_events.emplace(cycle, Event{event, context});
+}
+
+extern "C" uint8_t avr_emu_peek(uint8_t address)
+{
+	switch (address)
+	{
+	case A_UDR: return g_uart.rxData;
+	case A_TIFR: return g_tifr;
+	case A_GIFR: return g_gifr;
+	default: return g_io[address & 0x3F];
+	}
+}
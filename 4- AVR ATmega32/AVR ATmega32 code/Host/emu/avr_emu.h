@@ -0,0 +1,88 @@
+/******************************************************************************
+ * Module       : AVR Emulator (host)
+ * File Name    : avr_emu.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Host side API of the emulated ATmega32 (register file, timers,
+ *                USART, external interrupts, interrupt controller, virtual time)
+ *******************************************************************************/
+#ifndef HOST_AVR_EMU_H_
+#define HOST_AVR_EMU_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Virtual time model:
+ * 	- The time is counted in CPU cycles at F_CPU (AVR_EMU_F_CPU).
+ * 	- Every register access costs AVR_EMU_ACCESS_CYCLES, an interrupt entry AVR_EMU_ISR_CYCLES,
+ * 	  the delays cost their exact length. Plain C code between register accesses is free.
+ * 	- The sleep instruction (sleep_cpu with SE set in MCUCR) lets the time run until an interrupt
+ * 	  is executed, an interrupt enabled by the sei just before it still wakes it. Every sleep
+ * 	  mode is treated as idle: all the peripherals keep running.
+ * 	- The peripherals are brought up to date on every register access, so a polling loop
+ * 	  on a flag sees it change and the interrupts are dispatched as soon as they are enabled.
+ */
+#define AVR_EMU_F_CPU			(16000000ull)
+#define AVR_EMU_ACCESS_CYCLES	(2u)
+#define AVR_EMU_ISR_CYCLES		(8u)
+#define AVR_EMU_DELAY_STEP		(32u)	/* Delays are advanced in steps of this many cycles */
+
+/* Port index used by the pin functions */
+typedef enum
+{
+	AVR_EMU_PORTA, AVR_EMU_PORTB, AVR_EMU_PORTC, AVR_EMU_PORTD
+} AvrEmu_Port;
+
+/* Called when an output pin level changes (direction and port registers combined) */
+typedef void (*AvrEmu_PinHook)(void *context, AvrEmu_Port port, uint8_t pin, uint8_t level);
+/* Called for every byte leaving the USART transmitter */
+typedef void (*AvrEmu_UartHook)(void *context, uint8_t data);
+/* Event scheduled at a virtual time */
+typedef void (*AvrEmu_Event)(void *context);
+
+/* Reset the CPU state (registers, peripherals, time). The firmware is not restarted. */
+void avr_emu_reset(void);
+
+/*
+ * Run the firmware entry (normally main renamed to firmware_main) on its own stack.
+ * avr_emu_start only prepares it, avr_emu_runFor runs it for the given virtual time
+ * and returns, so the host can inspect and stimulate it between time slices.
+ */
+void avr_emu_start(void (*entry)(void));
+void avr_emu_runFor(uint64_t cycles);
+uint8_t avr_emu_finished(void);		/* The entry returned */
+
+/* Virtual time */
+uint64_t avr_emu_cycles(void);
+double avr_emu_seconds(void);
+uint64_t avr_emu_sleepCycles(void);	/* Part of the time spent in sleep */
+
+/* Pins driven from outside (inputs), with edge detection for INT0/INT1/INT2 and ICP1 */
+void avr_emu_setInput(AvrEmu_Port port, uint8_t pin, uint8_t level);
+/* Level seen on a pin: the output if the pin is an output, the input level otherwise */
+uint8_t avr_emu_getPin(AvrEmu_Port port, uint8_t pin);
+void avr_emu_setPinHook(AvrEmu_PinHook hook, void *context);
+
+/* USART: bytes received by the firmware (sent back to back at the configured baud rate) */
+void avr_emu_uartInject(const uint8_t *data, size_t length);
+void avr_emu_setUartHook(AvrEmu_UartHook hook, void *context);
+
+/* Call event(context) once the virtual time reaches cycle (from the emulator, like an interrupt) */
+void avr_emu_schedule(uint64_t cycle, AvrEmu_Event event, void *context);
+
+/* Raw view of the I/O space without side effects or time cost */
+uint8_t avr_emu_peek(uint8_t address);
+
+/* Advance the virtual time while keeping the peripherals and interrupts running (used by the delays) */
+void avr_emu_delayCycles(uint64_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_AVR_EMU_H_ */
@@ -0,0 +1,19 @@
+/******************************************************************************
+ * Module       : AVR Emulator (host)
+ * File Name    : interrupt.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Host replacement of <avr/interrupt.h>, an ISR is a plain function
+ *                named after its vector and called by the emulator
+ *******************************************************************************/
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR(vector, ...)	void vector(void); void vector(void)
+
+#define sei()	(SREG |= (1 << SREG_I))
+#define cli()	(SREG &= (uint8_t)~(1 << SREG_I))
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
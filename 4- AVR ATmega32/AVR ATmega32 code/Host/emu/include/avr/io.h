@@ -0,0 +1,273 @@
+/******************************************************************************
+ * Module       : AVR Emulator (host)
+ * File Name    : io.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Host replacement of <avr/io.h> for the ATmega32. Every register
+ *                access goes through the emulator, which advances the virtual
+ *                time, updates the peripherals and dispatches the interrupts.
+ *******************************************************************************/
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* I/O space accessors (addresses are the ATmega32 I/O addresses, 0x00 - 0x3F) */
+volatile uint8_t *avr_emu_io8(uint8_t address);
+volatile uint16_t *avr_emu_io16(uint8_t address);
+/* Registers where a write is an action (UDR, flag registers), see avr_emu.cpp */
+volatile uint16_t *avr_emu_strobe(uint8_t address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define _SFR_IO8(address)		(*avr_emu_io8(address))
+#define _SFR_IO16(address)		(*avr_emu_io16(address))
+#define _SFR_STROBE(address)	(*avr_emu_strobe(address))
+
+/*******************************************************************************
+ *                                  Registers                                  *
+ *******************************************************************************/
+#define TWBR	_SFR_IO8(0x00)
+#define TWSR	_SFR_IO8(0x01)
+#define TWAR	_SFR_IO8(0x02)
+#define TWDR	_SFR_IO8(0x03)
+#define ADCL	_SFR_IO8(0x04)
+#define ADCH	_SFR_IO8(0x05)
+#define ADCSRA	_SFR_IO8(0x06)
+#define ADMUX	_SFR_IO8(0x07)
+#define ACSR	_SFR_IO8(0x08)
+#define UBRRL	_SFR_IO8(0x09)
+#define UCSRB	_SFR_IO8(0x0A)
+#define UCSRA	_SFR_IO8(0x0B)
+#define UDR		_SFR_STROBE(0x0C)
+#define SPCR	_SFR_IO8(0x0D)
+#define SPSR	_SFR_IO8(0x0E)
+#define SPDR	_SFR_IO8(0x0F)
+#define PIND	_SFR_IO8(0x10)
+#define DDRD	_SFR_IO8(0x11)
+#define PORTD	_SFR_IO8(0x12)
+#define PINC	_SFR_IO8(0x13)
+#define DDRC	_SFR_IO8(0x14)
+#define PORTC	_SFR_IO8(0x15)
+#define PINB	_SFR_IO8(0x16)
+#define DDRB	_SFR_IO8(0x17)
+#define PORTB	_SFR_IO8(0x18)
+#define PINA	_SFR_IO8(0x19)
+#define DDRA	_SFR_IO8(0x1A)
+#define PORTA	_SFR_IO8(0x1B)
+#define EECR	_SFR_IO8(0x1C)
+#define EEDR	_SFR_IO8(0x1D)
+#define EEARL	_SFR_IO8(0x1E)
+#define EEARH	_SFR_IO8(0x1F)
+#define UBRRH	_SFR_IO8(0x20)
+#define UCSRC	_SFR_IO8(0x20)	/* Shares the address with UBRRH, selected by URSEL */
+#define WDTCR	_SFR_IO8(0x21)
+#define ASSR	_SFR_IO8(0x22)
+#define OCR2	_SFR_IO8(0x23)
+#define TCNT2	_SFR_IO8(0x24)
+#define TCCR2	_SFR_IO8(0x25)
+#define ICR1	_SFR_IO16(0x26)
+#define ICR1L	_SFR_IO8(0x26)
+#define ICR1H	_SFR_IO8(0x27)
+#define OCR1B	_SFR_IO16(0x28)
+#define OCR1BL	_SFR_IO8(0x28)
+#define OCR1BH	_SFR_IO8(0x29)
+#define OCR1A	_SFR_IO16(0x2A)
+#define OCR1AL	_SFR_IO8(0x2A)
+#define OCR1AH	_SFR_IO8(0x2B)
+#define TCNT1	_SFR_IO16(0x2C)
+#define TCNT1L	_SFR_IO8(0x2C)
+#define TCNT1H	_SFR_IO8(0x2D)
+#define TCCR1B	_SFR_IO8(0x2E)
+#define TCCR1A	_SFR_IO8(0x2F)
+#define SFIOR	_SFR_IO8(0x30)
+#define OSCCAL	_SFR_IO8(0x31)
+#define TCNT0	_SFR_IO8(0x32)
+#define TCCR0	_SFR_IO8(0x33)
+#define MCUCSR	_SFR_IO8(0x34)
+#define MCUCR	_SFR_IO8(0x35)
+#define TWCR	_SFR_IO8(0x36)
+#define SPMCR	_SFR_IO8(0x37)
+#define TIFR	_SFR_STROBE(0x38)
+#define TIMSK	_SFR_IO8(0x39)
+#define GIFR	_SFR_STROBE(0x3A)
+#define GICR	_SFR_IO8(0x3B)
+#define OCR0	_SFR_IO8(0x3C)
+#define SPL		_SFR_IO8(0x3D)
+#define SPH		_SFR_IO8(0x3E)
+#define SREG	_SFR_IO8(0x3F)
+
+/*******************************************************************************
+ *                                  Bits                                       *
+ *******************************************************************************/
+/* Port pins */
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PC7 7
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+/* SREG */
+#define SREG_I	7
+
+/* GICR / GIFR */
+#define INT1	7
+#define INT0	6
+#define INT2	5
+#define IVSEL	1
+#define IVCE	0
+#define INTF1	7
+#define INTF0	6
+#define INTF2	5
+
+/* MCUCR / MCUCSR */
+#define SE		7
+#define SM2		6
+#define SM1		5
+#define SM0		4
+#define ISC11	3
+#define ISC10	2
+#define ISC01	1
+#define ISC00	0
+#define JTD		7
+#define ISC2	6
+
+/* TIMSK / TIFR */
+#define OCIE2	7
+#define TOIE2	6
+#define TICIE1	5
+#define OCIE1A	4
+#define OCIE1B	3
+#define TOIE1	2
+#define OCIE0	1
+#define TOIE0	0
+#define OCF2	7
+#define TOV2	6
+#define ICF1	5
+#define OCF1A	4
+#define OCF1B	3
+#define TOV1	2
+#define OCF0	1
+#define TOV0	0
+
+/* TCCR0 */
+#define FOC0	7
+#define WGM00	6
+#define COM01	5
+#define COM00	4
+#define WGM01	3
+#define CS02	2
+#define CS01	1
+#define CS00	0
+
+/* TCCR2 */
+#define FOC2	7
+#define WGM20	6
+#define COM21	5
+#define COM20	4
+#define WGM21	3
+#define CS22	2
+#define CS21	1
+#define CS20	0
+
+/* TCCR1A / TCCR1B */
+#define COM1A1	7
+#define COM1A0	6
+#define COM1B1	5
+#define COM1B0	4
+#define FOC1A	3
+#define FOC1B	2
+#define WGM11	1
+#define WGM10	0
+#define ICNC1	7
+#define ICES1	6
+#define WGM13	4
+#define WGM12	3
+#define CS12	2
+#define CS11	1
+#define CS10	0
+
+/* UCSRA / UCSRB / UCSRC */
+#define RXC		7
+#define TXC		6
+#define UDRE	5
+#define FE		4
+#define DOR		3
+#define PE		2
+#define U2X		1
+#define MPCM	0
+#define RXCIE	7
+#define TXCIE	6
+#define UDRIE	5
+#define RXEN	4
+#define TXEN	3
+#define UCSZ2	2
+#define RXB8	1
+#define TXB8	0
+#define URSEL	7
+#define UMSEL	6
+#define UPM1	5
+#define UPM0	4
+#define USBS	3
+#define UCSZ1	2
+#define UCSZ0	1
+#define UCPOL	0
+
+/*******************************************************************************
+ *                              Interrupt vectors                              *
+ *******************************************************************************/
+#define INT0_vect			__vector_1
+#define INT1_vect			__vector_2
+#define INT2_vect			__vector_3
+#define TIMER2_COMP_vect	__vector_4
+#define TIMER2_OVF_vect		__vector_5
+#define TIMER1_CAPT_vect	__vector_6
+#define TIMER1_COMPA_vect	__vector_7
+#define TIMER1_COMPB_vect	__vector_8
+#define TIMER1_OVF_vect		__vector_9
+#define TIMER0_COMP_vect	__vector_10
+#define TIMER0_OVF_vect		__vector_11
+#define SPI_STC_vect		__vector_12
+#define USART_RXC_vect		__vector_13
+#define USART_UDRE_vect		__vector_14
+#define USART_TXC_vect		__vector_15
+#define ADC_vect			__vector_16
+#define EE_RDY_vect			__vector_17
+#define ANA_COMP_vect		__vector_18
+#define TWI_vect			__vector_19
+#define SPM_RDY_vect		__vector_20
+
+#endif /* HOST_AVR_IO_H_ */
@@ -0,0 +1,34 @@
+/******************************************************************************
+ * Module       : AVR Emulator (host)
+ * File Name    : sleep.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Host replacement of <avr/sleep.h>, the sleep instruction advances
+ *                the virtual time until an interrupt is executed
+ *******************************************************************************/
+#ifndef HOST_AVR_SLEEP_H_
+#define HOST_AVR_SLEEP_H_
+
+#include <avr/io.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void avr_emu_sleep(void);
+#ifdef __cplusplus
+}
+#endif
+
+#define SLEEP_MODE_IDLE			(0)
+#define SLEEP_MODE_ADC			(1 << SM0)
+#define SLEEP_MODE_PWR_DOWN		(1 << SM1)
+#define SLEEP_MODE_PWR_SAVE		((1 << SM0) | (1 << SM1))
+#define SLEEP_MODE_STANDBY		((1 << SM1) | (1 << SM2))
+#define SLEEP_MODE_EXT_STANDBY	((1 << SM0) | (1 << SM1) | (1 << SM2))
+
+#define set_sleep_mode(mode)	(MCUCR = (uint8_t)((MCUCR & ~((1 << SM0) | (1 << SM1) | (1 << SM2))) | (mode)))
+#define sleep_enable()			(MCUCR |= (1 << SE))
+#define sleep_disable()			(MCUCR &= (uint8_t)~(1 << SE))
+#define sleep_cpu()				avr_emu_sleep()
+
+#endif /* HOST_AVR_SLEEP_H_ */
@@ -0,0 +1,21 @@
+/******************************************************************************
+ * Module       : AVR Emulator (host)
+ * File Name    : stdlib.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Host <stdlib.h> plus the avr-libc extensions used by the firmware
+ *******************************************************************************/
+#ifndef HOST_STDLIB_H_
+#define HOST_STDLIB_H_
+
+#include_next <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+char *itoa(int value, char *string, int radix);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STDLIB_H_ */
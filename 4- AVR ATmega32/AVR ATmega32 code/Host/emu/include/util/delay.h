@@ -0,0 +1,36 @@
+/******************************************************************************
+ * Module       : AVR Emulator (host)
+ * File Name    : delay.h
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Host replacement of <util/delay.h>, the delays advance the virtual
+ *                time (interrupts keep running as on the target)
+ *******************************************************************************/
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#error "F_CPU must be defined for the delay functions"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void avr_emu_delayCycles(uint64_t cycles);
+#ifdef __cplusplus
+}
+#endif
+
+static inline void _delay_us(double us)
+{
+	avr_emu_delayCycles((uint64_t)(us * (F_CPU / 1000000.0)));
+}
+
+static inline void _delay_ms(double ms)
+{
+	avr_emu_delayCycles((uint64_t)(ms * (F_CPU / 1000.0)));
+}
+
+#endif /* HOST_UTIL_DELAY_H_ */
@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Module       : Host Runner
+ * File Name    : isvms_host.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Runs the unmodified firmware on the emulated ATmega32 and prints
+ *                what it sends over the USART
+ *
+ * Usage        : isvms_host [seconds] [commands]
+ *                seconds  : virtual time to run (default 1)
+ *                commands : bytes sent to the firmware USART after 100ms (e.g. "F" or "2F")
+ *******************************************************************************/
+#include "avr_emu.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" int firmware_main(void);
+
+namespace {
+
+void firmwareEntry(void)
+{
+	firmware_main();
+}
+
+void printUart(void *, uint8_t data)
+{
+	std::fputc(data, stdout);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	double seconds = (argc > 1) ? std::atof(argv[1]) : 1.0;
+	const char *commands = (argc > 2) ? argv[2] : "";
+	uint64_t total = static_cast<uint64_t>(seconds * AVR_EMU_F_CPU);
+	uint64_t injectAt = AVR_EMU_F_CPU / 10;
+
+	avr_emu_reset();
+	avr_emu_setUartHook(printUart, nullptr);
+	avr_emu_start(firmwareEntry);
+
+	if (*commands && total > injectAt)
+	{
+		avr_emu_runFor(injectAt);
+		avr_emu_uartInject(reinterpret_cast<const uint8_t *>(commands), std::strlen(commands));
+	}
+	avr_emu_runFor(total - avr_emu_cycles());
+
+	std::fflush(stdout);
+	std::fprintf(stderr, "ran %.3f s of virtual time%s\n", avr_emu_seconds(),
+			avr_emu_finished() ? " (firmware returned)" : "");
+	/* Motor outputs: direction pins on PORTC, duty on OCR0 (motor 1) and OCR2 (motor 2) */
+	std::fprintf(stderr, "PORTC 0x%02X OCR0 %u OCR2 %u\n", avr_emu_peek(0x15), avr_emu_peek(0x3C), avr_emu_peek(0x23));
+	/* CPU load: the share of the time the scheduler did not sleep in idle mode */
+	std::fprintf(stderr, "cpu active %.1f %% idle %.1f %%\n",
+			100.0 - avr_emu_sleepCycles() * 100.0 / avr_emu_cycles(), avr_emu_sleepCycles() * 100.0 / avr_emu_cycles());
+	return 0;
+}
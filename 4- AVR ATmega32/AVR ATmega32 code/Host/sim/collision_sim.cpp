@@ -0,0 +1,224 @@
+/******************************************************************************
+ * Module       : Collision Simulation (host)
+ * File Name    : collision_sim.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Closed loop check of the collision avoidance on the emulated ATmega32.
+ *                The car drives forward towards a wall, the ultrasonic echoes are
+ *                generated from its position and the wheel speeds follow the applied
+ *                motor duties (with their encoders). For every speed setting (1, 2, 3) the stopping margin
+ *                (closest distance to the wall) is reported, then once more at the top speed with the
+ *                joystick held forward (a packet every 50ms) instead of the 'F' command.
+ *                A run fails when the margin is under APP_STOP_MARGIN_MM, the exit code is the number
+ *                of failed runs.
+ *                The buzzer beeps are reported too: the gap at the first one and the interval
+ *                between the beeps at the warning distance and at the end of the approach.
+ *
+ * Usage        : isvms_collision_sim [wall mm] [top speed mm/s]
+ *                wall          : initial distance to the wall (default 2000)
+ *                top speed     : car speed at 100% duty (default 1000)
+ *******************************************************************************/
+#include "avr_emu.h"
+#include "wheel_model.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern "C" int firmware_main(void);
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr uint64_t kCyclesPerMs = AVR_EMU_F_CPU / 1000;
+constexpr double kTimeConstantS = 0.15;     /* Wheel speed response to the duty */
+constexpr double kEchoDelayUs = 200.0;      /* Trigger end to echo start */
+constexpr double kUsPerMm = 5.8;
+constexpr double kMaxRangeMm = 3400.0;
+constexpr double kSideMm = 1500.0;          /* Right and backward sensors see free space */
+constexpr double kStopMarginMm = 120.0;     /* APP_STOP_MARGIN_MM */
+constexpr char kSpeedCommands[] = {'1', '2', '3'};  /* MOTOR_SPEED_ONE, MOTOR_SPEED_TWO, MOTOR_MAX_SPEED */
+constexpr uint64_t kJoystickPeriodMs = 50;
+/* Echo input of the trigger pins PB5/PB6/PB7: right on INT0/PD2, forward and backward on INT1/PD3 */
+constexpr AvrEmu_Port kEchoPort[3] = {AVR_EMU_PORTD, AVR_EMU_PORTD, AVR_EMU_PORTD};
+constexpr uint8_t kEchoPin[3] = {2, 3, 3};
+
+struct Car
+{
+	double positionMm = 0.0;    /* Distance driven towards the wall */
+	double speedMmS = 0.0;
+	/* Encoders: right wheel on ICP1/PD6, left wheel on INT2/PB2 */
+	isvms::Wheel right{AVR_EMU_PORTD, 6, kTimeConstantS, 1000.0};
+	isvms::Wheel left{AVR_EMU_PORTB, 2, kTimeConstantS, 1000.0};
+	double wallMm = 2000.0;
+	double topSpeedMmS = 1000.0;
+	double minGapMm = 1e9;
+	double peakSpeedMmS = 0.0;
+	std::vector<std::pair<double, double>> beeps;  /* Time in ms and gap of every buzzer start */
+};
+
+Car g_car;
+
+/*******************************************************************************
+ *                                 Model                                       *
+ *******************************************************************************/
+double gap()
+{
+	return g_car.wallMm - g_car.positionMm;
+}
+
+/* 1ms physics step: the car moves at the mean speed of both wheels */
+void physicsStep(void *)
+{
+	g_car.right.step(0.001, isvms::appliedDuty(0));
+	g_car.left.step(0.001, isvms::appliedDuty(1));
+
+	g_car.speedMmS = (g_car.right.speedMmS() + g_car.left.speedMmS()) / 2.0;
+	g_car.positionMm += g_car.speedMmS * 0.001;
+	if (g_car.speedMmS > g_car.peakSpeedMmS)
+	{
+		g_car.peakSpeedMmS = g_car.speedMmS;
+	}
+	if (gap() < g_car.minGapMm)
+	{
+		g_car.minGapMm = gap();
+	}
+	avr_emu_schedule(avr_emu_cycles() + kCyclesPerMs, physicsStep, nullptr);
+}
+
+/* The context is the sensor index (0 right, 1 forward, 2 backward) */
+void echoHigh(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 1);
+}
+
+void echoLow(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 0);
+}
+
+/* Trigger falling edge on PB5/PB6/PB7: answer with the echo of the current distance. Buzzer on PC5 */
+void triggerHook(void *, AvrEmu_Port port, uint8_t pin, uint8_t level)
+{
+	if (port == AVR_EMU_PORTC && pin == 5 && level != 0)
+	{
+		g_car.beeps.emplace_back(static_cast<double>(avr_emu_cycles()) / kCyclesPerMs, gap());
+		return;
+	}
+	if (port != AVR_EMU_PORTB || pin < 5 || level != 0)
+	{
+		return;
+	}
+
+	int sensor = pin - 5;
+	double distance = (sensor == 1) ? gap() : kSideMm;
+	if (distance <= 0.0 || distance > kMaxRangeMm)
+	{
+		return;
+	}
+
+	void *context = reinterpret_cast<void *>(static_cast<intptr_t>(sensor));
+	uint64_t start = avr_emu_cycles() + static_cast<uint64_t>(kEchoDelayUs * AVR_EMU_F_CPU / 1e6);
+	avr_emu_schedule(start, echoHigh, context);
+	avr_emu_schedule(start + static_cast<uint64_t>(distance * kUsPerMm * AVR_EMU_F_CPU / 1e6), echoLow, context);
+}
+
+void firmwareEntry(void)
+{
+	firmware_main();
+}
+
+/* Joystick packet, full throttle and no turn, sent again every kJoystickPeriodMs */
+void joystickPacket(void *)
+{
+	const uint8_t x = 0;
+	const uint8_t y = 100;
+	const uint8_t packet[] = {'J', x, y, static_cast<uint8_t>('J' ^ x ^ y)};
+
+	avr_emu_uartInject(packet, sizeof(packet));
+	avr_emu_schedule(avr_emu_cycles() + kJoystickPeriodMs * kCyclesPerMs, joystickPacket, nullptr);
+}
+
+/* One run: select the speed, drive forward (with 'F' or the joystick) and wait for the car to settle */
+int runSpeed(char speedCommand, bool joystick)
+{
+	const uint8_t commands[] = {static_cast<uint8_t>(speedCommand), 'F'};
+
+	g_car.right.setTopSpeed(g_car.topSpeedMmS);
+	g_car.left.setTopSpeed(g_car.topSpeedMmS);
+	avr_emu_reset();
+	avr_emu_setPinHook(triggerHook, nullptr);
+	avr_emu_start(firmwareEntry);
+	/* Nobody near the car, both PIR outputs (PD4/PD5) idle low */
+	avr_emu_setInput(AVR_EMU_PORTD, 4, 0);
+	avr_emu_setInput(AVR_EMU_PORTD, 5, 0);
+	avr_emu_schedule(kCyclesPerMs, physicsStep, nullptr);
+
+	avr_emu_runFor(100 * kCyclesPerMs);
+	avr_emu_uartInject(commands, joystick ? 1 : sizeof(commands));
+	if (joystick)
+	{
+		joystickPacket(nullptr);
+	}
+	avr_emu_runFor(static_cast<uint64_t>((g_car.wallMm / g_car.topSpeedMmS) * 4000.0) * kCyclesPerMs);
+
+	double bound = kStopMarginMm;
+	const char *verdict = (g_car.minGapMm <= 0.0) ? "COLLISION" : (g_car.minGapMm < bound) ? "UNDER MARGIN" : "ok";
+	std::printf("speed %c%s  peak %6.0f mm/s  stopping margin %6.1f mm  final gap %6.1f mm  %s\n",
+				speedCommand, joystick ? " joystick" : "", g_car.peakSpeedMmS, g_car.minGapMm, gap(),
+				verdict);
+	if (g_car.beeps.size() >= 3)
+	{
+		const auto &beeps = g_car.beeps;
+		std::printf("  beeps %zu  first at gap %6.1f mm  interval %5.0f ms after it, %5.0f ms at the end\n",
+					beeps.size(), beeps[0].second, beeps[1].first - beeps[0].first,
+					beeps[beeps.size() - 1].first - beeps[beeps.size() - 2].first);
+	}
+	else
+	{
+		std::printf("  beeps %zu\n", g_car.beeps.size());
+	}
+	std::printf("  cpu active %5.1f %%  idle %5.1f %%\n", 100.0 - avr_emu_sleepCycles() * 100.0 / avr_emu_cycles(),
+				avr_emu_sleepCycles() * 100.0 / avr_emu_cycles());
+	std::fflush(stdout);
+	return (g_car.minGapMm >= bound) ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	int failures = 0;
+
+	g_car.wallMm = (argc > 1) ? std::atof(argv[1]) : 2000.0;
+	g_car.topSpeedMmS = (argc > 2) ? std::atof(argv[2]) : 1000.0;
+	std::printf("wall %.0f mm, top speed %.0f mm/s\n", g_car.wallMm, g_car.topSpeedMmS);
+	std::fflush(stdout);
+
+	/* The firmware keeps its state in globals, every speed runs in a fresh process */
+	for (size_t run = 0; run <= sizeof(kSpeedCommands); run++)
+	{
+		bool joystick = (run == sizeof(kSpeedCommands));
+		char speed = joystick ? kSpeedCommands[run - 1] : kSpeedCommands[run];
+		pid_t child = fork();
+		if (child == 0)
+		{
+			std::_Exit(runSpeed(speed, joystick) == 0 ? 0 : 1);
+		}
+		int status = 0;
+		waitpid(child, &status, 0);
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			failures++;
+		}
+	}
+
+	return failures;
+}
@@ -0,0 +1,361 @@
+/******************************************************************************
+ * Module       : Command Simulation (host)
+ * File Name    : command_sim.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Checks of the UART command handling on the emulated ATmega32, the car
+ *                stands still (the wheels and encoders follow the motor duties) and the
+ *                forward distance is scripted. Every case runs in a fresh process and
+ *                prints ok or FAIL, the exit code is the number of failed cases:
+ *                - a joystick stream (throttle 'P', turn 'F') with a lost and a corrupted byte
+ *                  must never start parking or run a payload byte as a command, and resyncs.
+ *                - line endings in the stream must not disable the joystick link timeout.
+ *                - a command received during a brake pulse must be driven at its end.
+ *                - a presence must stop the car and keep it still, no brake pulse on an
+ *                  obstacle and no drive command, until it ends.
+ *                - reversing at the second speed must ramp both wheels through 0 (STOP).
+ *
+ * Usage        : isvms_command_sim
+ *******************************************************************************/
+#include "avr_emu.h"
+#include "wheel_model.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern "C" int firmware_main(void);
+extern "C" unsigned char Parking_getState(void);		/* Parking_StateType, one byte with -fshort-enums */
+extern "C" signed char DcMotor_getDuty(unsigned char motor);
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr uint64_t kCyclesPerMs = AVR_EMU_F_CPU / 1000;
+constexpr double kTimeConstantS = 0.15;
+constexpr double kEchoDelayUs = 200.0;
+constexpr double kUsPerMm = 5.8;
+constexpr double kFreeMm = 1500.0;
+constexpr double kObstacleMm = 100.0;		/* Inside APP_STOP_MARGIN_MM */
+constexpr unsigned char kParkingIdle = 0;
+constexpr uint64_t kPirWarmupMs = 30000;	/* PIR_WARMUP_MS, no presence is reported before */
+/* Echo input of the trigger pins PB5/PB6/PB7: right on INT0/PD2, forward and backward on INT1/PD3 */
+constexpr AvrEmu_Port kEchoPort[3] = {AVR_EMU_PORTD, AVR_EMU_PORTD, AVR_EMU_PORTD};
+constexpr uint8_t kEchoPin[3] = {2, 3, 3};
+
+/* Axis values that are also commands: forward throttle 'P' (80) and right turn 'F' (70) */
+constexpr uint8_t kTurn = 'F';
+constexpr uint8_t kThrottle = 'P';
+
+isvms::Wheel g_right{AVR_EMU_PORTD, 6, kTimeConstantS, 1000.0};
+isvms::Wheel g_left{AVR_EMU_PORTB, 2, kTimeConstantS, 1000.0};
+double g_forwardMm = kFreeMm;
+
+/*******************************************************************************
+ *                                 Model                                       *
+ *******************************************************************************/
+void physicsStep(void *)
+{
+	g_right.step(0.001, isvms::appliedDuty(0));
+	g_left.step(0.001, isvms::appliedDuty(1));
+	avr_emu_schedule(avr_emu_cycles() + kCyclesPerMs, physicsStep, nullptr);
+}
+
+void echoHigh(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 1);
+}
+
+void echoLow(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 0);
+}
+
+/* Trigger falling edge on PB5/PB6/PB7: answer with the echo of the scripted distance */
+void triggerHook(void *, AvrEmu_Port port, uint8_t pin, uint8_t level)
+{
+	if (port != AVR_EMU_PORTB || pin < 5 || level != 0)
+	{
+		return;
+	}
+
+	int sensor = pin - 5;
+	double distance = (sensor == 1) ? g_forwardMm : kFreeMm;
+	void *context = reinterpret_cast<void *>(static_cast<intptr_t>(sensor));
+	uint64_t start = avr_emu_cycles() + static_cast<uint64_t>(kEchoDelayUs * AVR_EMU_F_CPU / 1e6);
+	avr_emu_schedule(start, echoHigh, context);
+	avr_emu_schedule(start + static_cast<uint64_t>(distance * kUsPerMm * AVR_EMU_F_CPU / 1e6), echoLow, context);
+}
+
+void firmwareEntry(void)
+{
+	firmware_main();
+}
+
+void start()
+{
+	avr_emu_reset();
+	avr_emu_setPinHook(triggerHook, nullptr);
+	avr_emu_start(firmwareEntry);
+	/* Nobody near the car, both PIR outputs (PD4/PD5) idle low */
+	avr_emu_setInput(AVR_EMU_PORTD, 4, 0);
+	avr_emu_setInput(AVR_EMU_PORTD, 5, 0);
+	avr_emu_schedule(kCyclesPerMs, physicsStep, nullptr);
+	avr_emu_runFor(100 * kCyclesPerMs);
+}
+
+void send(const std::vector<uint8_t> &bytes)
+{
+	avr_emu_uartInject(bytes.data(), bytes.size());
+}
+
+std::vector<uint8_t> joystickPacket(uint8_t x, uint8_t y)
+{
+	return {'J', x, y, static_cast<uint8_t>('J' ^ x ^ y)};
+}
+
+/* Sends a packet every 50ms for the given time, edit alters the bytes of packet number n */
+template <typename Edit>
+void joystickStream(uint64_t durationMs, Edit edit)
+{
+	for (uint64_t n = 0; n < durationMs / 50; n++)
+	{
+		std::vector<uint8_t> packet = joystickPacket(kTurn, kThrottle);
+		edit(n, packet);
+		send(packet);
+		avr_emu_runFor(50 * kCyclesPerMs);
+	}
+}
+
+/* Both wheels forward, the right one (inside of the right turn) slower */
+bool drivingRightTurn()
+{
+	return (isvms::appliedDuty(1) > 0.0) && (isvms::appliedDuty(0) >= 0.0) &&
+		   (isvms::appliedDuty(1) > isvms::appliedDuty(0));
+}
+
+bool stopped()
+{
+	return (isvms::appliedDuty(0) == 0.0) && (isvms::appliedDuty(1) == 0.0);
+}
+
+/* Runs for the given time, false if a motor was driven at any millisecond of it */
+bool stillFor(uint64_t durationMs)
+{
+	bool still = true;
+
+	for (uint64_t ms = 0; ms < durationMs; ms++)
+	{
+		avr_emu_runFor(kCyclesPerMs);
+		still = still && stopped();
+	}
+	return still;
+}
+
+/*******************************************************************************
+ *                                 Cases                                       *
+ *******************************************************************************/
+/* A header lost: the payload and check bytes arrive out of a packet and must be dropped */
+bool lostHeader()
+{
+	bool parking = false;
+
+	start();
+	joystickStream(1000, [](uint64_t n, std::vector<uint8_t> &packet) {
+		if (n == 5)
+		{
+			packet.erase(packet.begin());
+		}
+	});
+	parking = (Parking_getState() != kParkingIdle);
+	std::printf("  %-18s parking %s  driving %s\n", "lost header", parking ? "started" : "idle", drivingRightTurn() ? "yes" : "no");
+	return !parking && drivingRightTurn();
+}
+
+/* A payload byte lost or corrupted: the packet fails its check, the parser resyncs on the next header */
+bool badPayload(bool lost)
+{
+	bool parking = false;
+
+	start();
+	joystickStream(1000, [lost](uint64_t n, std::vector<uint8_t> &packet) {
+		if (n == 5 && lost)
+		{
+			packet.erase(packet.begin() + 1);
+		}
+		else if (n == 5)
+		{
+			packet[2] ^= 0x04;
+		}
+	});
+	parking = (Parking_getState() != kParkingIdle);
+	std::printf("  %-18s parking %s  driving %s\n", lost ? "lost payload" : "corrupted payload",
+				parking ? "started" : "idle", drivingRightTurn() ? "yes" : "no");
+	return !parking && drivingRightTurn();
+}
+
+/* "\r\n" after the packets, then the phone goes silent: the link timeout must still stop the car */
+bool lineEndingsTimeout()
+{
+	bool drivingBefore;
+	bool timedOut;
+
+	start();
+	joystickStream(500, [](uint64_t, std::vector<uint8_t> &packet) {
+		packet.push_back('\r');
+		packet.push_back('\n');
+	});
+	drivingBefore = drivingRightTurn();
+	avr_emu_runFor(500 * kCyclesPerMs);
+	timedOut = stopped();
+	std::printf("  %-18s driving %s  stopped after the timeout %s\n", "line endings", drivingBefore ? "yes" : "no",
+				timedOut ? "yes" : "no");
+	return drivingBefore && timedOut;
+}
+
+/* 'F', an obstacle appears in front, 'B' during the brake pulse: the car must back away after it */
+bool commandDuringBrake()
+{
+	bool pulse = false;
+	bool backward;
+
+	start();
+	send({'F'});
+	avr_emu_runFor(300 * kCyclesPerMs);
+	g_forwardMm = kObstacleMm;
+	for (int ms = 0; ms < 200 && !pulse; ms++)
+	{
+		avr_emu_runFor(kCyclesPerMs);
+		pulse = (isvms::appliedDuty(0) < 0.0) && (isvms::appliedDuty(1) < 0.0);
+	}
+	send({'B'});
+	avr_emu_runFor(500 * kCyclesPerMs);
+	backward = (isvms::appliedDuty(0) < 0.0) && (isvms::appliedDuty(1) < 0.0);
+	std::printf("  %-18s pulse %s  backing away after it %s\n", "brake pulse", pulse ? "yes" : "no", backward ? "yes" : "no");
+	return pulse && backward;
+}
+
+/* 'F', someone comes near (PIR0 on PD4): stopped, then an obstacle in front and 'F' and 'B' must not move it */
+bool presence()
+{
+	bool stoppedByPresence;
+	bool noBrake;
+	bool noCommand;
+	bool drivesAfter;
+
+	start();
+	avr_emu_runFor((kPirWarmupMs - 100) * kCyclesPerMs);
+	send({'F'});
+	avr_emu_runFor(300 * kCyclesPerMs);
+	avr_emu_setInput(AVR_EMU_PORTD, 4, 1);
+	avr_emu_runFor(300 * kCyclesPerMs);
+	stoppedByPresence = stopped();
+	g_forwardMm = kObstacleMm;
+	noBrake = stillFor(500);
+	g_forwardMm = kFreeMm;
+	send({'F'});
+	noCommand = stillFor(200);
+	send({'B'});
+	noCommand = stillFor(200) && noCommand;
+	avr_emu_setInput(AVR_EMU_PORTD, 4, 0);
+	avr_emu_runFor(300 * kCyclesPerMs);
+	noCommand = stopped() && noCommand;
+	send({'F'});
+	avr_emu_runFor(300 * kCyclesPerMs);
+	drivesAfter = (isvms::appliedDuty(0) > 0.0) && (isvms::appliedDuty(1) > 0.0);
+	std::printf("  %-18s stopped %s  brake pulse %s  commands run %s  drives after it %s\n", "presence",
+				stoppedByPresence ? "yes" : "no", noBrake ? "no" : "yes", noCommand ? "no" : "yes", drivesAfter ? "yes" : "no");
+	return stoppedByPresence && noBrake && noCommand && drivesAfter;
+}
+
+/* '2' and 'F', then 'B': the applied duty of both wheels must be 0 between forward and backward */
+bool reverse()
+{
+	signed char last[2];
+	bool throughStop[2] = {false, false};
+	bool crossed[2] = {false, false};
+
+	start();
+	send({'2'});
+	avr_emu_runFor(50 * kCyclesPerMs);
+	send({'F'});
+	avr_emu_runFor(800 * kCyclesPerMs);
+	send({'B'});
+	last[0] = DcMotor_getDuty(0);
+	last[1] = DcMotor_getDuty(1);
+	for (int ms = 0; ms < 500; ms++)
+	{
+		avr_emu_runFor(kCyclesPerMs);
+		for (unsigned char motor = 0; motor < 2; motor++)
+		{
+			signed char duty = DcMotor_getDuty(motor);
+			throughStop[motor] = throughStop[motor] || (duty == 0);
+			/* A sign change without a 0 on the way */
+			crossed[motor] = crossed[motor] || ((last[motor] > 0) && (duty < 0)) || ((last[motor] < 0) && (duty > 0));
+			last[motor] = duty;
+		}
+	}
+	std::printf("  %-18s through STOP %s %s  backward %d %d\n", "reverse", throughStop[0] && !crossed[0] ? "yes" : "no",
+				throughStop[1] && !crossed[1] ? "yes" : "no", last[0], last[1]);
+	return throughStop[0] && throughStop[1] && !crossed[0] && !crossed[1] && (last[0] < 0) && (last[1] < 0);
+}
+
+int runCase(int index)
+{
+	switch (index)
+	{
+	case 0:
+		return lostHeader() ? 0 : 1;
+	case 1:
+		return badPayload(true) ? 0 : 1;
+	case 2:
+		return badPayload(false) ? 0 : 1;
+	case 3:
+		return lineEndingsTimeout() ? 0 : 1;
+	case 4:
+		return commandDuringBrake() ? 0 : 1;
+	case 5:
+		return presence() ? 0 : 1;
+	case 6:
+		return reverse() ? 0 : 1;
+	default:
+		return -1;
+	}
+}
+
+} // namespace
+
+int main()
+{
+	int failures = 0;
+
+	/* The firmware keeps its state in globals, every case runs in a fresh process */
+	for (int index = 0;; index++)
+	{
+		std::fflush(stdout);
+		pid_t child = fork();
+		if (child == 0)
+		{
+			int result = runCase(index);
+			std::fflush(stdout);
+			std::_Exit(result < 0 ? 2 : result);
+		}
+		int status = 0;
+		waitpid(child, &status, 0);
+		if (WIFEXITED(status) && WEXITSTATUS(status) == 2)
+		{
+			break;
+		}
+		bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+		std::printf("%s\n", ok ? "ok" : "FAIL");
+		failures += ok ? 0 : 1;
+	}
+
+	return failures;
+}
@@ -0,0 +1,378 @@
+/******************************************************************************
+ * Module       : Parking Simulation (host)
+ * File Name    : parking_sim.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Closed loop run of the parking planner on the emulated ATmega32.
+ *                A differential drive car (wheels driven by the applied motor duties,
+ *                with their encoders)
+ *                drives along a row of parked cars with a slot of a given length.
+ *                The three ultrasonic sensors are ray cast against the scene. For every
+ *                slot length the outcome, the maneuver time and the final pose are
+ *                reported, followed by the success rate.
+ *                A slot fails on a collision, when it is kMustParkMm or longer and the car does
+ *                not end parked inside it, or when it is shorter than kNoSpaceMm and the planner
+ *                does not report NO_SPACE. The exit code is the number of failed slots.
+ *
+ * Usage        : isvms_parking_sim [first mm] [last mm] [step mm]
+ *                slot lengths to try (default 300 to 800 by 50)
+ *                ISVMS_TRACE in the environment prints the pose at every phase change
+ *******************************************************************************/
+#include "avr_emu.h"
+#include "wheel_model.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+
+extern "C" int firmware_main(void);
+extern "C" unsigned char Parking_getState(void);		/* Parking_StateType, one byte with -fshort-enums */
+extern "C" unsigned short Parking_getSlotLength(void);
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr uint64_t kCyclesPerMs = AVR_EMU_F_CPU / 1000;
+constexpr double kPi = 3.14159265358979;
+
+/* Car: 250 x 160 mm, wheels 140 mm apart on an axle 60 mm behind the centre */
+constexpr double kCarLength = 250.0;
+constexpr double kCarWidth = 160.0;
+constexpr double kTrack = 140.0;
+constexpr double kAxleOffset = -60.0;
+constexpr double kTopSpeed = 1000.0;			/* mm/s at 100% duty */
+constexpr double kTimeConstantS = 0.1;
+
+/* Scene: parked cars 100 mm right of the car, curb behind them, the slot starts at x = 300 */
+constexpr double kParkedNear = -180.0;
+constexpr double kParkedFar = -340.0;
+constexpr double kCurb = -360.0;
+constexpr double kSlotStart = 300.0;
+
+/* Sensors in the car frame: right (PB5), forward (PB6), backward (PB7) */
+constexpr double kSensorX[3] = {0.0, kCarLength / 2, -kCarLength / 2};
+constexpr double kSensorY[3] = {-kCarWidth / 2, 0.0, 0.0};
+constexpr double kSensorDir[3] = {-kPi / 2, 0.0, kPi};
+constexpr double kBeamHalfAngle = 7.5 * kPi / 180.0;
+constexpr double kMaxRange = 3400.0;
+constexpr double kEchoDelayUs = 200.0;
+constexpr double kUsPerMm = 5.8;
+/* Echo inputs: right INT0/PD2, forward and backward INT1/PD3 */
+constexpr AvrEmu_Port kEchoPort[3] = {AVR_EMU_PORTD, AVR_EMU_PORTD, AVR_EMU_PORTD};
+constexpr uint8_t kEchoPin[3] = {2, 3, 3};
+
+/* Parking_StateType */
+const char *const kStateNames[] = {
+	"IDLE", "SEARCH", "ALIGN", "PIVOT_IN", "REVERSE", "PIVOT_OUT", "CENTER", "DONE", "NO_SPACE", "FAILED", "ABORTED", "UNCENTERED"
+};
+constexpr unsigned char kStateDone = 7;
+constexpr unsigned char kStateNoSpace = 8;
+constexpr unsigned char kStateCount = sizeof(kStateNames) / sizeof(kStateNames[0]);
+constexpr double kMustParkMm = 400.0;
+constexpr double kNoSpaceMm = 370.0;			/* Car length and PARKING_MARGIN_MM both ends */
+
+/* Outcome of a slot, the exit code of its process */
+enum Outcome { kParked = 0, kNotParked = 1, kCollision = 2, kNoSpace = 3 };
+
+struct Rect
+{
+	double x0, x1, y0, y1;
+};
+
+struct Car
+{
+	double x = 0.0;		/* Centre */
+	double y = 0.0;
+	double heading = 0.0;
+	/* Encoders: right wheel on ICP1/PD6, left wheel on INT2/PB2 */
+	isvms::Wheel right{AVR_EMU_PORTD, 6, kTimeConstantS, kTopSpeed};
+	isvms::Wheel left{AVR_EMU_PORTB, 2, kTimeConstantS, kTopSpeed};
+	bool collided = false;
+};
+
+Rect g_obstacles[3];
+Car g_car;
+bool g_trace = false;				/* ISVMS_TRACE set: print the pose at every planner phase change */
+unsigned char g_lastState = 0;
+
+/*******************************************************************************
+ *                                 Model                                       *
+ *******************************************************************************/
+/* Distance along a ray to a rectangle (slab method), kMaxRange + 1 when missed */
+double rayToRect(double ox, double oy, double dx, double dy, const Rect &r)
+{
+	double tMin = 0.0;
+	double tMax = kMaxRange + 1.0;
+	const double o[2] = {ox, oy};
+	const double d[2] = {dx, dy};
+	const double lo[2] = {r.x0, r.y0};
+	const double hi[2] = {r.x1, r.y1};
+
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (std::fabs(d[axis]) < 1e-9)
+		{
+			if (o[axis] < lo[axis] || o[axis] > hi[axis])
+			{
+				return kMaxRange + 1.0;
+			}
+			continue;
+		}
+		double t1 = (lo[axis] - o[axis]) / d[axis];
+		double t2 = (hi[axis] - o[axis]) / d[axis];
+		if (t1 > t2)
+		{
+			std::swap(t1, t2);
+		}
+		tMin = std::fmax(tMin, t1);
+		tMax = std::fmin(tMax, t2);
+		if (tMin > tMax)
+		{
+			return kMaxRange + 1.0;
+		}
+	}
+	return tMin;
+}
+
+/* Closest echo of a sensor over three rays across its beam */
+double sensorDistance(int sensor)
+{
+	double c = std::cos(g_car.heading);
+	double s = std::sin(g_car.heading);
+	double ox = g_car.x + kSensorX[sensor] * c - kSensorY[sensor] * s;
+	double oy = g_car.y + kSensorX[sensor] * s + kSensorY[sensor] * c;
+	double best = kMaxRange + 1.0;
+
+	for (int ray = -1; ray <= 1; ray++)
+	{
+		double angle = g_car.heading + kSensorDir[sensor] + ray * kBeamHalfAngle;
+		for (const Rect &r : g_obstacles)
+		{
+			best = std::fmin(best, rayToRect(ox, oy, std::cos(angle), std::sin(angle), r));
+		}
+	}
+	return best;
+}
+
+void carCorners(double cx[4], double cy[4])
+{
+	const double lx[4] = {kCarLength / 2, kCarLength / 2, -kCarLength / 2, -kCarLength / 2};
+	const double ly[4] = {kCarWidth / 2, -kCarWidth / 2, -kCarWidth / 2, kCarWidth / 2};
+	double c = std::cos(g_car.heading);
+	double s = std::sin(g_car.heading);
+
+	for (int i = 0; i < 4; i++)
+	{
+		cx[i] = g_car.x + lx[i] * c - ly[i] * s;
+		cy[i] = g_car.y + lx[i] * s + ly[i] * c;
+	}
+}
+
+/* Separating axis test of the car against an axis aligned rectangle */
+bool overlaps(const Rect &r)
+{
+	double cx[4], cy[4];
+	const double rx[4] = {r.x0, r.x1, r.x1, r.x0};
+	const double ry[4] = {r.y0, r.y0, r.y1, r.y1};
+	const double axes[4][2] = {
+		{1.0, 0.0}, {0.0, 1.0},
+		{std::cos(g_car.heading), std::sin(g_car.heading)}, {-std::sin(g_car.heading), std::cos(g_car.heading)}
+	};
+
+	carCorners(cx, cy);
+	for (const auto &axis : axes)
+	{
+		double carMin = 1e18, carMax = -1e18, rectMin = 1e18, rectMax = -1e18;
+		for (int i = 0; i < 4; i++)
+		{
+			double p = cx[i] * axis[0] + cy[i] * axis[1];
+			double q = rx[i] * axis[0] + ry[i] * axis[1];
+			carMin = std::fmin(carMin, p);
+			carMax = std::fmax(carMax, p);
+			rectMin = std::fmin(rectMin, q);
+			rectMax = std::fmax(rectMax, q);
+		}
+		if (carMax < rectMin || rectMax < carMin)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* 1ms physics step: motor 1 drives the right wheel, motor 2 the left one */
+void physicsStep(void *)
+{
+	const double dt = 0.001;
+
+	g_car.right.step(dt, isvms::appliedDuty(0));
+	g_car.left.step(dt, isvms::appliedDuty(1));
+
+	double v = (g_car.right.speedMmS() + g_car.left.speedMmS()) / 2.0;
+	double w = (g_car.right.speedMmS() - g_car.left.speedMmS()) / kTrack;
+	/* Move the axle point, the centre follows it */
+	double ax = g_car.x + kAxleOffset * std::cos(g_car.heading);
+	double ay = g_car.y + kAxleOffset * std::sin(g_car.heading);
+	ax += v * std::cos(g_car.heading) * dt;
+	ay += v * std::sin(g_car.heading) * dt;
+	g_car.heading += w * dt;
+	g_car.x = ax - kAxleOffset * std::cos(g_car.heading);
+	g_car.y = ay - kAxleOffset * std::sin(g_car.heading);
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (overlaps(g_obstacles[i]) && !g_car.collided)
+		{
+			g_car.collided = true;
+			if (g_trace)
+			{
+				std::printf("  %8.3f s  collision with obstacle %d\n", avr_emu_seconds(), i);
+			}
+		}
+	}
+	if (g_trace && Parking_getState() != g_lastState)
+	{
+		g_lastState = Parking_getState();
+		std::printf("  %8.3f s  %-9s x %6.0f y %5.0f heading %6.1f deg  rear %4.0f front %4.0f right %4.0f\n",
+					avr_emu_seconds(), kStateNames[g_lastState], g_car.x - kSlotStart, g_car.y,
+					g_car.heading * 180.0 / kPi, sensorDistance(2), sensorDistance(1), sensorDistance(0));
+	}
+	avr_emu_schedule(avr_emu_cycles() + kCyclesPerMs, physicsStep, nullptr);
+}
+
+void echoHigh(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 1);
+}
+
+void echoLow(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 0);
+}
+
+/* Trigger falling edge on PB5/PB6/PB7: answer with the echo of the ray cast distance */
+void triggerHook(void *, AvrEmu_Port port, uint8_t pin, uint8_t level)
+{
+	if (port != AVR_EMU_PORTB || pin < 5 || level != 0)
+	{
+		return;
+	}
+
+	int sensor = pin - 5;
+	double distance = sensorDistance(sensor);
+	if (distance > kMaxRange)
+	{
+		return;
+	}
+
+	void *context = reinterpret_cast<void *>(static_cast<intptr_t>(sensor));
+	uint64_t start = avr_emu_cycles() + static_cast<uint64_t>(kEchoDelayUs * AVR_EMU_F_CPU / 1e6);
+	avr_emu_schedule(start, echoHigh, context);
+	avr_emu_schedule(start + static_cast<uint64_t>(distance * kUsPerMm * AVR_EMU_F_CPU / 1e6), echoLow, context);
+}
+
+void firmwareEntry(void)
+{
+	firmware_main();
+}
+
+/* Parked inside the slot: within its length, mostly behind the parked cars line, nearly straight */
+bool parkedInside(double slot)
+{
+	double cx[4], cy[4];
+
+	carCorners(cx, cy);
+	for (int i = 0; i < 4; i++)
+	{
+		if (cx[i] < kSlotStart || cx[i] > kSlotStart + slot || cy[i] > kParkedNear + 40.0)
+		{
+			return false;
+		}
+	}
+	return std::fabs(g_car.heading) <= 15.0 * kPi / 180.0;
+}
+
+/* One run: start the planner beside the first parked car and wait for it to finish */
+int runSlot(double slot)
+{
+	const uint8_t command = 'P';
+	uint64_t startMs = 100;
+	uint64_t ms = startMs;
+	unsigned char state = 0;
+
+	g_obstacles[0] = Rect{-1000.0, kSlotStart, kParkedFar, kParkedNear};
+	g_obstacles[1] = Rect{kSlotStart + slot, kSlotStart + slot + 1000.0, kParkedFar, kParkedNear};
+	g_obstacles[2] = Rect{-3000.0, 6000.0, kCurb - 40.0, kCurb};
+
+	avr_emu_reset();
+	avr_emu_setPinHook(triggerHook, nullptr);
+	avr_emu_start(firmwareEntry);
+	/* Nobody near the car, both PIR outputs (PD4/PD5) idle low */
+	avr_emu_setInput(AVR_EMU_PORTD, 4, 0);
+	avr_emu_setInput(AVR_EMU_PORTD, 5, 0);
+	avr_emu_schedule(kCyclesPerMs, physicsStep, nullptr);
+
+	avr_emu_runFor(startMs * kCyclesPerMs);
+	avr_emu_uartInject(&command, 1);
+	do
+	{
+		avr_emu_runFor(10 * kCyclesPerMs);
+		ms += 10;
+		state = Parking_getState();
+	} while ((state == 0 || state < kStateDone) && ms < 30000 && !g_car.collided);
+	avr_emu_runFor(300 * kCyclesPerMs);		/* Let the car settle */
+
+	bool success = (state == kStateDone) && !g_car.collided && parkedInside(slot);
+	std::printf("slot %5.0f  measured %5u  %-9s  %6.2f s  x %6.0f y %5.0f heading %6.1f deg  %s\n",
+				slot, Parking_getSlotLength(), (state < kStateCount) ? kStateNames[state] : "?", (ms - startMs) / 1000.0,
+				g_car.x - kSlotStart, g_car.y, g_car.heading * 180.0 / kPi,
+				g_car.collided ? "COLLISION" : success ? "parked" : "not parked");
+	std::fflush(stdout);
+	return g_car.collided ? kCollision : success ? kParked : (state == kStateNoSpace) ? kNoSpace : kNotParked;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	double first = (argc > 1) ? std::atof(argv[1]) : 300.0;
+	double last = (argc > 2) ? std::atof(argv[2]) : 800.0;
+	double step = (argc > 3) ? std::atof(argv[3]) : 50.0;
+	int runs = 0;
+	int parked = 0;
+	int collisions = 0;
+	int failures = 0;
+
+	g_trace = (std::getenv("ISVMS_TRACE") != nullptr);
+	std::printf("slot lengths %.0f to %.0f mm, car %.0f x %.0f mm\n", first, last, kCarLength, kCarWidth);
+	std::fflush(stdout);
+
+	/* The firmware keeps its state in globals, every slot runs in a fresh process */
+	for (double slot = first; slot <= last; slot += step)
+	{
+		pid_t child = fork();
+		if (child == 0)
+		{
+			std::_Exit(runSlot(slot));
+		}
+		int status = 0;
+		waitpid(child, &status, 0);
+		int outcome = WIFEXITED(status) ? WEXITSTATUS(status) : kCollision;
+		bool ok = (outcome != kCollision) && (slot < kMustParkMm || outcome == kParked) &&
+				  (slot >= kNoSpaceMm || outcome == kNoSpace);
+		runs++;
+		parked += (outcome == kParked) ? 1 : 0;
+		collisions += (outcome == kCollision) ? 1 : 0;
+		failures += ok ? 0 : 1;
+	}
+
+	std::printf("parked %d / %d, collisions %d, failed %d\n", parked, runs, collisions, failures);
+	return failures;
+}
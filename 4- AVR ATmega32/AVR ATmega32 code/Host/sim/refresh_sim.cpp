@@ -0,0 +1,171 @@
+/******************************************************************************
+ * Module       : Ultrasonic Refresh Simulation (host)
+ * File Name    : refresh_sim.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Checks the refresh rate of the three ultrasonic sensors on the emulated
+ *                ATmega32: the completed full cycles (Ultrasonic_getCycleCount) are counted
+ *                against the virtual time while the car drives forward, with every sensor
+ *                close, at the maximum range, not answering at all (echo timeouts) and mixed.
+ *                Every case runs in a fresh process and prints its rate with ok or FAIL, the
+ *                exit code is the number of cases under the required rate.
+ *
+ * Usage        : isvms_refresh_sim [seconds]
+ *                seconds       : measured time per case after the start up (default 3)
+ *******************************************************************************/
+#include "avr_emu.h"
+#include "wheel_model.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern "C" int firmware_main(void);
+extern "C" unsigned short Ultrasonic_getCycleCount(void);	/* Side effect free, safe between two time slices */
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr uint64_t kCyclesPerMs = AVR_EMU_F_CPU / 1000;
+constexpr double kRequiredHz = 15.0;
+constexpr double kTimeConstantS = 0.15;
+constexpr double kEchoDelayUs = 200.0;
+constexpr double kUsPerMm = 5.8;
+constexpr double kNoEcho = -1.0;
+/* Echo input of the trigger pins PB5/PB6/PB7: right on INT0/PD2, forward and backward on INT1/PD3 */
+constexpr AvrEmu_Port kEchoPort[3] = {AVR_EMU_PORTD, AVR_EMU_PORTD, AVR_EMU_PORTD};
+constexpr uint8_t kEchoPin[3] = {2, 3, 3};
+
+struct Case
+{
+	const char *name;
+	double distanceMm[3];	/* Right, forward, backward, kNoEcho for a sensor that never answers */
+};
+
+/* The forward distance stays out of the collision avoidance margins, the car keeps driving */
+constexpr Case kCases[] = {
+	{"close", {150.0, 1000.0, 150.0}},
+	{"maximum range", {3350.0, 3350.0, 3350.0}},
+	{"no echo", {kNoEcho, kNoEcho, kNoEcho}},
+	{"mixed", {kNoEcho, 3350.0, 150.0}},
+};
+
+isvms::Wheel g_right{AVR_EMU_PORTD, 6, kTimeConstantS, 1000.0};
+isvms::Wheel g_left{AVR_EMU_PORTB, 2, kTimeConstantS, 1000.0};
+const Case *g_case = nullptr;
+unsigned g_triggers = 0;		/* Backward sensor triggers, the last round of a cycle */
+
+/*******************************************************************************
+ *                                 Model                                       *
+ *******************************************************************************/
+void physicsStep(void *)
+{
+	g_right.step(0.001, isvms::appliedDuty(0));
+	g_left.step(0.001, isvms::appliedDuty(1));
+	avr_emu_schedule(avr_emu_cycles() + kCyclesPerMs, physicsStep, nullptr);
+}
+
+void echoHigh(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 1);
+}
+
+void echoLow(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 0);
+}
+
+/* Trigger falling edge on PB5/PB6/PB7: answer with the echo of the case distance */
+void triggerHook(void *, AvrEmu_Port port, uint8_t pin, uint8_t level)
+{
+	if (port != AVR_EMU_PORTB || pin < 5 || level != 0)
+	{
+		return;
+	}
+
+	int sensor = pin - 5;
+	double distance = g_case->distanceMm[sensor];
+	g_triggers += (sensor == 2) ? 1 : 0;
+	if (distance == kNoEcho)
+	{
+		return;
+	}
+
+	void *context = reinterpret_cast<void *>(static_cast<intptr_t>(sensor));
+	uint64_t start = avr_emu_cycles() + static_cast<uint64_t>(kEchoDelayUs * AVR_EMU_F_CPU / 1e6);
+	avr_emu_schedule(start, echoHigh, context);
+	avr_emu_schedule(start + static_cast<uint64_t>(distance * kUsPerMm * AVR_EMU_F_CPU / 1e6), echoLow, context);
+}
+
+void firmwareEntry(void)
+{
+	firmware_main();
+}
+
+/*******************************************************************************
+ *                                 Cases                                       *
+ *******************************************************************************/
+bool runCase(const Case &c, double seconds)
+{
+	static const uint8_t kForward = 'F';
+	uint16_t firstCycle;
+	unsigned firstTriggers;
+	double cycleHz;
+	double triggerHz;
+
+	g_case = &c;
+	avr_emu_reset();
+	avr_emu_setPinHook(triggerHook, nullptr);
+	avr_emu_start(firmwareEntry);
+	/* Nobody near the car, both PIR outputs (PD4/PD5) idle low */
+	avr_emu_setInput(AVR_EMU_PORTD, 4, 0);
+	avr_emu_setInput(AVR_EMU_PORTD, 5, 0);
+	avr_emu_schedule(kCyclesPerMs, physicsStep, nullptr);
+	avr_emu_runFor(100 * kCyclesPerMs);
+	avr_emu_uartInject(&kForward, 1);
+	avr_emu_runFor(500 * kCyclesPerMs);
+
+	firstCycle = Ultrasonic_getCycleCount();
+	firstTriggers = g_triggers;
+	avr_emu_runFor(static_cast<uint64_t>(seconds * AVR_EMU_F_CPU));
+	cycleHz = static_cast<uint16_t>(Ultrasonic_getCycleCount() - firstCycle) / seconds;
+	triggerHz = (g_triggers - firstTriggers) / seconds;
+
+	std::printf("%-14s %5.1f cycles/s  (backward triggers %5.1f /s)  driving %s  ", c.name, cycleHz, triggerHz,
+				(isvms::appliedDuty(0) > 0.0 && isvms::appliedDuty(1) > 0.0) ? "yes" : "no");
+	return cycleHz >= kRequiredHz;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	double seconds = (argc > 1) ? std::atof(argv[1]) : 3.0;
+	int failures = 0;
+
+	std::printf("required %.0f Hz, measured over %.1f s\n", kRequiredHz, seconds);
+	/* The firmware keeps its state in globals, every case runs in a fresh process */
+	for (const Case &c : kCases)
+	{
+		std::fflush(stdout);
+		pid_t child = fork();
+		if (child == 0)
+		{
+			bool ok = runCase(c, seconds);
+			std::fflush(stdout);
+			std::_Exit(ok ? 0 : 1);
+		}
+		int status = 0;
+		waitpid(child, &status, 0);
+		bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+		std::printf("%s\n", ok ? "ok" : "FAIL");
+		failures += ok ? 0 : 1;
+	}
+
+	return failures;
+}
@@ -0,0 +1,296 @@
+/******************************************************************************
+ * Module       : Speed Simulation (host)
+ * File Name    : speed_sim.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Step response of the wheel speed control on the emulated ATmega32.
+ *                The wheels follow the duty applied by the firmware and drive their
+ *                encoders. The right motor is weaker than the left one and the battery
+ *                can be low. For every duty (the pivots and the driving duty of the
+ *                parking, the three speed settings) the car is started from rest and
+ *                the rise time (10 to 90%), overshoot, settling time (5%) and
+ *                steady state error of each wheel are reported, next to the open loop
+ *                response (the commanded duty applied directly) on the same wheels.
+ *                A joystick stream follows: the setpoint moves by a few percent around
+ *                MOTOR_SPEED_ONE with every packet (20Hz), the error is the mean speed over
+ *                its last two cycles (800ms) against the mean setpoint.
+ *                A closed loop error over kStepErrorPct (kStreamErrorPct for the stream) fails the
+ *                run when the wheel can reach its highest setpoint within kReachableDuty. Else, or
+ *                under SPEED_PI_MIN_RPM (driven open loop), the closed loop must not end slower
+ *                than the open loop by more than that. The exit code is the number of failed runs.
+ *
+ * Usage        : isvms_speed_sim [right motor gain] [battery levels...]
+ *                right motor gain : right wheel speed per duty relative to the left (default 0.9)
+ *                battery levels   : top speed factors to run (default 1.0 0.8)
+ *******************************************************************************/
+#include "avr_emu.h"
+#include "wheel_model.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C" int firmware_main(void);
+extern "C" signed char DcMotor_getDuty(unsigned char motor);
+extern "C" void DcMotor_setTarget(signed char motor1Duty, signed char motor2Duty);
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr uint64_t kCyclesPerMs = AVR_EMU_F_CPU / 1000;
+constexpr double kTimeConstantS = 0.1;
+constexpr double kTopSpeed = 1000.0;        /* mm/s at 100% duty, full battery */
+constexpr uint64_t kStartMs = 100;
+constexpr uint64_t kRunMs = 1500;
+constexpr uint64_t kSteadyMs = 300;         /* Steady state error: mean over the end of the run */
+/* PARKING_PIVOT_DUTY, PARKING_DUTY, MOTOR_SPEED_ONE, MOTOR_SPEED_TWO, MOTOR_MAX_SPEED */
+constexpr int kDuties[] = {20, 40, 70, 85, 100};
+constexpr int kStreamDuty = 70;
+constexpr int kStreamSteps[] = {0, 3, 5, 3, 0, -3, -5, -3};  /* Setpoint offsets of the packets */
+constexpr uint64_t kStreamPeriodMs = 50;
+constexpr uint64_t kStreamMeanMs = 800;        /* Two cycles of the steps */
+constexpr double kReachableDuty = 0.95;         /* Highest open loop duty the PI is expected to track with */
+constexpr double kOpenLoopBelow = 75.0 / 294.0 * kTopSpeed;   /* SPEED_PI_MIN_RPM / SPEED_PI_FULL_DUTY_RPM */
+constexpr double kStepErrorPct = 2.0;
+constexpr double kStreamErrorPct = 3.0;
+
+/* Speed of one wheel every ms, closed loop and open loop */
+struct Trace
+{
+	std::vector<double> closed;
+	std::vector<double> open;
+};
+
+struct Setup
+{
+	double rightGain = 0.9;
+	double battery = 1.0;
+	int duty = 0;
+	bool stream = false;		/* Joystick stream around the duty instead of a step */
+};
+
+Setup g_setup;
+Trace g_traces[2];              /* Right, left */
+double g_openSpeed[2] = {0.0, 0.0};
+/* Encoders: right wheel on ICP1/PD6, left wheel on INT2/PB2 */
+isvms::Wheel g_right{AVR_EMU_PORTD, 6, kTimeConstantS, kTopSpeed};
+isvms::Wheel g_left{AVR_EMU_PORTB, 2, kTimeConstantS, kTopSpeed};
+
+/*******************************************************************************
+ *                                 Model                                       *
+ *******************************************************************************/
+double topSpeed(int wheel)
+{
+	return kTopSpeed * g_setup.battery * ((wheel == 0) ? g_setup.rightGain : 1.0);
+}
+
+/* 1ms physics step of the real wheels and of their open loop twins */
+void physicsStep(void *)
+{
+	const double dt = 0.001;
+
+	g_right.step(dt, isvms::appliedDuty(0));
+	g_left.step(dt, isvms::appliedDuty(1));
+	for (int i = 0; i < 2; i++)
+	{
+		double target = DcMotor_getDuty(static_cast<unsigned char>(i)) / 100.0 * topSpeed(i);
+		g_openSpeed[i] += (target - g_openSpeed[i]) * (dt / kTimeConstantS);
+	}
+
+	if (avr_emu_cycles() >= kStartMs * kCyclesPerMs)
+	{
+		g_traces[0].closed.push_back(g_right.speedMmS());
+		g_traces[1].closed.push_back(g_left.speedMmS());
+		g_traces[0].open.push_back(g_openSpeed[0]);
+		g_traces[1].open.push_back(g_openSpeed[1]);
+	}
+	avr_emu_schedule(avr_emu_cycles() + kCyclesPerMs, physicsStep, nullptr);
+}
+
+void firmwareEntry(void)
+{
+	firmware_main();
+}
+
+/* Mean speed error of a trace over the end of the stream, in percent of the mean setpoint */
+double streamError(const std::vector<double> &speed, double setpoint)
+{
+	double mean = 0.0;
+
+	for (size_t ms = speed.size() - kStreamMeanMs; ms < speed.size(); ms++)
+	{
+		mean += speed[ms] / kStreamMeanMs;
+	}
+	return (mean - setpoint) * 100.0 / setpoint;
+}
+
+/* Step response figures of one trace against the setpoint, the times from the command, returns the steady error */
+double report(const char *name, const std::vector<double> &speed, double setpoint)
+{
+	double peak = 0.0;
+	double steady = 0.0;
+	int rise10 = -1;
+	int rise90 = -1;
+	int settle = 0;
+
+	for (size_t ms = 0; ms < speed.size(); ms++)
+	{
+		peak = std::fmax(peak, speed[ms]);
+		if (rise10 < 0 && speed[ms] >= 0.1 * setpoint)
+		{
+			rise10 = static_cast<int>(ms);
+		}
+		if (rise90 < 0 && speed[ms] >= 0.9 * setpoint)
+		{
+			rise90 = static_cast<int>(ms);
+		}
+		if (std::fabs(speed[ms] - setpoint) > 0.05 * setpoint)
+		{
+			settle = static_cast<int>(ms) + 1;
+		}
+	}
+	for (size_t ms = speed.size() - kSteadyMs; ms < speed.size(); ms++)
+	{
+		steady += speed[ms] / kSteadyMs;
+	}
+
+	std::printf("    %-6s  rise ", name);
+	if (rise10 >= 0 && rise90 >= 0)
+	{
+		std::printf("%4d ms", rise90 - rise10);
+	}
+	else
+	{
+		std::printf("   - ms");
+	}
+	std::printf("  overshoot %5.1f %%  settling ", std::fmax(0.0, (peak - setpoint) * 100.0 / setpoint));
+	if (settle < static_cast<int>(speed.size()))
+	{
+		std::printf("%4d ms", settle);
+	}
+	else
+	{
+		std::printf("   - ms");
+	}
+	std::printf("  steady %6.0f mm/s  error %6.1f %%\n", steady, (steady - setpoint) * 100.0 / setpoint);
+	return (steady - setpoint) * 100.0 / setpoint;
+}
+
+/* Bound of one wheel: the error when the setpoint is regulated and reachable, else no worse than the open loop */
+bool check(int wheel, double peakSetpoint, double bound, double openError, double closedError)
+{
+	bool reachable = (peakSetpoint >= kOpenLoopBelow) && (peakSetpoint <= kReachableDuty * topSpeed(wheel));
+	bool ok = reachable ? (std::fabs(closedError) <= bound) : (closedError >= openError - bound);
+
+	if (!ok)
+	{
+		std::printf("  %s wheel FAIL: %s\n", (wheel == 0) ? "right" : "left",
+					reachable ? "error out of bounds" : "closed loop slower than open loop");
+	}
+	return ok;
+}
+
+/* One run: start both wheels forward from rest at the duty of the setup */
+int runStep(void)
+{
+	double setpoint = g_setup.duty / 100.0 * kTopSpeed;
+	int failures = 0;
+
+	g_right.setTopSpeed(topSpeed(0));
+	g_left.setTopSpeed(topSpeed(1));
+	avr_emu_reset();
+	avr_emu_start(firmwareEntry);
+	avr_emu_schedule(kCyclesPerMs, physicsStep, nullptr);
+	avr_emu_runFor(kStartMs * kCyclesPerMs);
+
+	/*
+	 * Both wheels step like a motion command, or a joystick packet moves the target every
+	 * kStreamPeriodMs. The firmware is called between two time slices: a call from an emulator
+	 * event would nest its register accesses in the event dispatch.
+	 */
+	for (uint64_t packet = 0; packet < kRunMs / kStreamPeriodMs; packet++)
+	{
+		int duty = g_setup.duty;
+		if (g_setup.stream)
+		{
+			duty += kStreamSteps[packet % (sizeof(kStreamSteps) / sizeof(kStreamSteps[0]))];
+		}
+		DcMotor_setTarget(static_cast<signed char>(duty), static_cast<signed char>(duty));
+		avr_emu_runFor(kStreamPeriodMs * kCyclesPerMs);
+	}
+
+	if (g_setup.stream)
+	{
+		std::printf("stream %3d %% +-%d  battery %3.0f %%  mean setpoint %4.0f mm/s\n", g_setup.duty, kStreamSteps[2],
+					g_setup.battery * 100.0, setpoint);
+		for (int i = 0; i < 2; i++)
+		{
+			double open = streamError(g_traces[i].open, setpoint);
+			double closed = streamError(g_traces[i].closed, setpoint);
+			std::printf("  %-5s wheel  open error %6.1f %%  closed error %6.1f %%\n", (i == 0) ? "right" : "left", open, closed);
+			failures += check(i, (g_setup.duty + kStreamSteps[2]) / 100.0 * kTopSpeed, kStreamErrorPct, open, closed) ? 0 : 1;
+		}
+		std::fflush(stdout);
+		return failures;
+	}
+
+	std::printf("duty %3d %%  battery %3.0f %%  setpoint %4.0f mm/s\n", g_setup.duty, g_setup.battery * 100.0, setpoint);
+	for (int i = 0; i < 2; i++)
+	{
+		std::printf("  %s wheel\n", (i == 0) ? "right" : "left");
+		double open = report("open", g_traces[i].open, setpoint);
+		double closed = report("closed", g_traces[i].closed, setpoint);
+		failures += check(i, setpoint, kStepErrorPct, open, closed) ? 0 : 1;
+	}
+	std::fflush(stdout);
+	return failures;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	std::vector<double> batteries;
+	int failures = 0;
+
+	g_setup.rightGain = (argc > 1) ? std::atof(argv[1]) : 0.9;
+	for (int i = 2; i < argc; i++)
+	{
+		batteries.push_back(std::atof(argv[i]));
+	}
+	if (batteries.empty())
+	{
+		batteries = {1.0, 0.8};
+	}
+	std::printf("right motor gain %.2f, wheel time constant %.0f ms\n", g_setup.rightGain, kTimeConstantS * 1000.0);
+	std::fflush(stdout);
+
+	/* The firmware keeps its state in globals, every run is a fresh process */
+	for (double battery : batteries)
+	{
+		g_setup.battery = battery;
+		for (size_t run = 0; run <= sizeof(kDuties) / sizeof(kDuties[0]); run++)
+		{
+			g_setup.stream = (run == sizeof(kDuties) / sizeof(kDuties[0]));
+			g_setup.duty = g_setup.stream ? kStreamDuty : kDuties[run];
+			pid_t child = fork();
+			if (child == 0)
+			{
+				std::_Exit(runStep());
+			}
+			int status = 0;
+			waitpid(child, &status, 0);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			{
+				failures++;
+			}
+		}
+	}
+
+	return failures;
+}
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * Module       : Binary Telemetry Simulation (host)
+ * File Name    : telemetry_sim.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Checks the binary telemetry of the emulated ATmega32 (firmware built with
+ *                TELEMETRY_MODE_BINARY) end to end: the USART output while the car drives
+ *                forward is decoded by the host TelemetryDecoder. Every frame must pass its
+ *                CRC with no sequence gap, at the APP_TELEMETRY_PERIOD_MS rate, and carry the
+ *                scripted distances and the forward duties. The same stream is decoded again
+ *                with one payload byte of a frame corrupted: the decoder must count exactly one
+ *                CRC error and one lost frame. Prints ok or FAIL per check, the exit code is
+ *                the number of failed checks.
+ *
+ * Usage        : isvms_telemetry_sim [seconds]
+ *                seconds       : driving time (default 2)
+ *******************************************************************************/
+#include "avr_emu.h"
+#include "telemetry_decoder.hpp"
+#include "wheel_model.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+extern "C" int firmware_main(void);
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr uint64_t kCyclesPerMs = AVR_EMU_F_CPU / 1000;
+constexpr double kPeriodMs = 20.0;				/* APP_TELEMETRY_PERIOD_MS in binary mode */
+constexpr double kTimeConstantS = 0.15;
+constexpr double kEchoDelayUs = 200.0;
+constexpr double kUsPerMm = 5.8;
+constexpr double kToleranceMm = 20.0;
+/* Right, forward, backward: the forward one out of the collision avoidance margins */
+constexpr double kDistanceMm[3] = {150.0, 1000.0, 400.0};
+/* Echo input of the trigger pins PB5/PB6/PB7: right on INT0/PD2, forward and backward on INT1/PD3 */
+constexpr AvrEmu_Port kEchoPort[3] = {AVR_EMU_PORTD, AVR_EMU_PORTD, AVR_EMU_PORTD};
+constexpr uint8_t kEchoPin[3] = {2, 3, 3};
+constexpr uint8_t kAllValid = isvms::kFlagRightValid | isvms::kFlagForwardValid | isvms::kFlagBackwardValid;
+
+isvms::Wheel g_right{AVR_EMU_PORTD, 6, kTimeConstantS, 1000.0};
+isvms::Wheel g_left{AVR_EMU_PORTB, 2, kTimeConstantS, 1000.0};
+std::vector<uint8_t> g_stream;
+
+/*******************************************************************************
+ *                                 Model                                       *
+ *******************************************************************************/
+void physicsStep(void *)
+{
+	g_right.step(0.001, isvms::appliedDuty(0));
+	g_left.step(0.001, isvms::appliedDuty(1));
+	avr_emu_schedule(avr_emu_cycles() + kCyclesPerMs, physicsStep, nullptr);
+}
+
+void echoHigh(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 1);
+}
+
+void echoLow(void *sensor)
+{
+	intptr_t i = reinterpret_cast<intptr_t>(sensor);
+	avr_emu_setInput(kEchoPort[i], kEchoPin[i], 0);
+}
+
+/* Trigger falling edge on PB5/PB6/PB7: answer with the echo of the scripted distance */
+void triggerHook(void *, AvrEmu_Port port, uint8_t pin, uint8_t level)
+{
+	if (port != AVR_EMU_PORTB || pin < 5 || level != 0)
+	{
+		return;
+	}
+
+	int sensor = pin - 5;
+	void *context = reinterpret_cast<void *>(static_cast<intptr_t>(sensor));
+	uint64_t start = avr_emu_cycles() + static_cast<uint64_t>(kEchoDelayUs * AVR_EMU_F_CPU / 1e6);
+	avr_emu_schedule(start, echoHigh, context);
+	avr_emu_schedule(start + static_cast<uint64_t>(kDistanceMm[sensor] * kUsPerMm * AVR_EMU_F_CPU / 1e6), echoLow, context);
+}
+
+void recordUart(void *, uint8_t data)
+{
+	g_stream.push_back(data);
+}
+
+void firmwareEntry(void)
+{
+	firmware_main();
+}
+
+/*******************************************************************************
+ *                                 Checks                                      *
+ *******************************************************************************/
+bool report(const char *name, bool ok)
+{
+	std::printf("  %-44s %s\n", name, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+bool near(uint16_t measuredMm, double expectedMm)
+{
+	return std::fabs(measuredMm - expectedMm) <= kToleranceMm;
+}
+
+/*
+ * Corrupts a payload byte of the frame that starts at the given delimiter, a COBS code byte
+ * would break the framing instead of the CRC. Returns false if no frame follows it.
+ */
+bool corruptFrame(std::vector<uint8_t> &stream, std::size_t delimiter)
+{
+	std::size_t start = delimiter + 1;
+	std::size_t code = start;
+
+	while (code < stream.size() && stream[code] != 0)
+	{
+		std::size_t next = code + stream[code];
+		/* The first data byte of the block, made a different non zero value */
+		if (next > code + 1 && code + 1 < stream.size() && stream[code + 1] != 0)
+		{
+			stream[code + 1] = (stream[code + 1] == 0xFF) ? 0x01 : static_cast<uint8_t>(stream[code + 1] + 1);
+			return true;
+		}
+		code = next;
+	}
+	return false;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	static const uint8_t kForward = 'F';
+	double seconds = (argc > 1) ? std::atof(argv[1]) : 2.0;
+	std::vector<isvms::TelemetryFrame> frames;
+	int failures = 0;
+
+	avr_emu_reset();
+	avr_emu_setPinHook(triggerHook, nullptr);
+	avr_emu_setUartHook(recordUart, nullptr);
+	avr_emu_start(firmwareEntry);
+	/* Nobody near the car, both PIR outputs (PD4/PD5) idle low */
+	avr_emu_setInput(AVR_EMU_PORTD, 4, 0);
+	avr_emu_setInput(AVR_EMU_PORTD, 5, 0);
+	avr_emu_schedule(kCyclesPerMs, physicsStep, nullptr);
+	avr_emu_runFor(100 * kCyclesPerMs);
+	avr_emu_uartInject(&kForward, 1);
+	avr_emu_runFor(static_cast<uint64_t>(seconds * AVR_EMU_F_CPU));
+
+	isvms::TelemetryDecoder decoder([&frames](const isvms::TelemetryFrame &frame) { frames.push_back(frame); });
+	decoder.feed(g_stream.data(), g_stream.size());
+	const isvms::TelemetryStats &stats = decoder.stats();
+	double expectedFrames = (seconds * 1000.0 + 100.0) / kPeriodMs;
+
+	std::printf("%zu bytes, frames %u (expected %.0f), crc errors %u, framing errors %u, lost %u\n", g_stream.size(),
+				stats.frames, expectedFrames, stats.crcErrors, stats.framingErrors, stats.lostFrames);
+	failures += report("every frame decoded", (stats.crcErrors == 0) && (stats.framingErrors == 0) && (stats.lostFrames == 0)) ? 0 : 1;
+	failures += report("frame rate", (stats.frames >= 0.95 * expectedFrames) && (stats.frames <= expectedFrames + 1.0)) ? 0 : 1;
+
+	/* The last frame, once the sensors and the motors have settled */
+	isvms::TelemetryFrame last = frames.empty() ? isvms::TelemetryFrame{} : frames.back();
+	std::printf("last frame: sequence %u  %llu ms  right %u forward %u backward %u mm  duty %d %d  flags 0x%02X\n", last.sequence,
+				static_cast<unsigned long long>(last.timeMs), last.distanceRightMm, last.distanceForwardMm,
+				last.distanceBackwardMm, last.motor1Duty, last.motor2Duty, last.flags);
+	failures += report("distances", near(last.distanceRightMm, kDistanceMm[0]) && near(last.distanceForwardMm, kDistanceMm[1]) &&
+										 near(last.distanceBackwardMm, kDistanceMm[2]) && ((last.flags & kAllValid) == kAllValid)) ? 0 : 1;
+	failures += report("forward duties", (last.motor1Duty > 0) && (last.motor2Duty > 0)) ? 0 : 1;
+	failures += report("timestamps", (frames.size() > 1) &&
+										 (std::fabs((last.timeMs - frames.front().timeMs) - kPeriodMs * (frames.size() - 1)) <= kPeriodMs)) ? 0 : 1;
+
+	/* A payload byte of a frame in the middle of the stream corrupted */
+	std::vector<uint8_t> corrupted = g_stream;
+	std::size_t delimiter = corrupted.size() / 2;
+	while (delimiter < corrupted.size() && corrupted[delimiter] != 0)
+	{
+		delimiter++;
+	}
+	bool done = corruptFrame(corrupted, delimiter);
+	isvms::TelemetryDecoder damaged(nullptr);
+	damaged.feed(corrupted.data(), corrupted.size());
+	std::printf("corrupted: frames %u, crc errors %u, framing errors %u, lost %u\n", damaged.stats().frames,
+				damaged.stats().crcErrors, damaged.stats().framingErrors, damaged.stats().lostFrames);
+	failures += report("corrupted frame counted as a CRC error", done && (damaged.stats().crcErrors == 1) &&
+																	(damaged.stats().framingErrors == 0) &&
+																	(damaged.stats().lostFrames == 1) &&
+																	(damaged.stats().frames == stats.frames - 1)) ? 0 : 1;
+
+	return failures;
+}
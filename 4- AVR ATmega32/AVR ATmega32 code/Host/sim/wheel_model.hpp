@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Module       : Wheel Model (host)
+ * File Name    : wheel_model.hpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Drive wheels of the simulations: the speed follows the duty the
+ *                firmware applies (PWM compare registers and H-bridge inputs) with a
+ *                first order response, and every wheel drives its slotted disc
+ *                encoder input with edges at their exact interpolated times.
+ *******************************************************************************/
+#ifndef HOST_SIM_WHEEL_MODEL_HPP_
+#define HOST_SIM_WHEEL_MODEL_HPP_
+
+#include "avr_emu.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace isvms {
+
+/* Must match HAL/MOTOR and HAL/ENCODER */
+constexpr double kWheelCircumferenceMm = 204.2;		/* 65 mm wheel */
+constexpr double kEncoderSlots = 20.0;
+constexpr uint8_t kIoOcr0 = 0x3C;					/* Motor 1 (right) PWM */
+constexpr uint8_t kIoOcr2 = 0x23;					/* Motor 2 (left) PWM */
+constexpr uint8_t kIoPortC = 0x15;					/* Bridge inputs: PC3/PC4 motor 1, PC7/PC6 motor 2 */
+
+/* Signed duty (-1 to 1) the firmware applies to a motor (0 right, 1 left), positive is forward (CCW) */
+inline double appliedDuty(int motor)
+{
+	uint8_t portC = avr_emu_peek(kIoPortC);
+	double duty = avr_emu_peek(motor == 0 ? kIoOcr0 : kIoOcr2) / 255.0;
+	bool ccw = (portC >> (motor == 0 ? 3 : 7)) & 1;
+	bool cw = (portC >> (motor == 0 ? 4 : 6)) & 1;
+
+	return (ccw == cw) ? 0.0 : ccw ? duty : -duty;
+}
+
+/* One wheel and its encoder (rising edge every slot, 50% duty cycle) */
+class Wheel
+{
+public:
+	Wheel(AvrEmu_Port encoderPort, uint8_t encoderPin, double timeConstantS, double topSpeedMmS)
+		: m_port(encoderPort), m_pin(encoderPin), m_timeConstantS(timeConstantS), m_topSpeedMmS(topSpeedMmS)
+	{
+	}
+
+	/* Advance by dt seconds from now, duty is the signed duty (-1 to 1) over the step */
+	void step(double dt, double duty)
+	{
+		double halfSlots = m_halfSlots;
+
+		m_speedMmS += (duty * m_topSpeedMmS - m_speedMmS) * (dt / m_timeConstantS);
+		m_halfSlots += std::fabs(m_speedMmS) * dt * (2.0 * kEncoderSlots / kWheelCircumferenceMm);
+
+		/* Every half slot crossed within the step toggles the encoder, at the time it is crossed */
+		for (double edge = std::floor(halfSlots) + 1.0; edge <= m_halfSlots; edge += 1.0)
+		{
+			double at = dt * (edge - halfSlots) / (m_halfSlots - halfSlots);
+			bool high = (static_cast<uint64_t>(edge) & 1u) != 0;
+			avr_emu_schedule(avr_emu_cycles() + static_cast<uint64_t>(at * AVR_EMU_F_CPU),
+							 high ? &Wheel::encoderHigh : &Wheel::encoderLow, this);
+		}
+	}
+
+	double speedMmS() const { return m_speedMmS; }
+	void setTopSpeed(double topSpeedMmS) { m_topSpeedMmS = topSpeedMmS; }
+
+private:
+	static void encoderHigh(void *wheel)
+	{
+		Wheel *self = static_cast<Wheel *>(wheel);
+		avr_emu_setInput(self->m_port, self->m_pin, 1);
+	}
+
+	static void encoderLow(void *wheel)
+	{
+		Wheel *self = static_cast<Wheel *>(wheel);
+		avr_emu_setInput(self->m_port, self->m_pin, 0);
+	}
+
+	AvrEmu_Port m_port;
+	uint8_t m_pin;
+	double m_timeConstantS;
+	double m_topSpeedMmS;
+	double m_speedMmS = 0.0;
+	double m_halfSlots = 0.0;	/* Encoder position, the input is high on odd half slots */
+};
+
+} // namespace isvms
+
+#endif /* HOST_SIM_WHEEL_MODEL_HPP_ */
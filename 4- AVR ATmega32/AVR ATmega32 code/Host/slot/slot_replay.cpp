@@ -0,0 +1,334 @@
+/******************************************************************************
+ * Module       : Slot Replay (host)
+ * File Name    : slot_replay.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Streams right sensor profiles through the firmware slot estimator
+ *                (SERVICE/PARKING/slot_estimator.c, compiled unmodified) and prints the gaps.
+ *
+ *                Without arguments, replays synthetic curb profiles with a known ground
+ *                truth (speed ramps, stops, noise, spikes, dropouts, no curb) and checks the
+ *                measured lengths. Returns 1 when a gap is missed or off by more than the
+ *                tolerance.
+ *
+ * Usage        : isvms_slot_replay [options]
+ *                  --csv FILE           replay a recorded profile instead
+ *                  --dump NAME          print the synthetic profile NAME as CSV
+ *                  --tolerance MM       length tolerance of the synthetic check (default 40)
+ *
+ * Profile CSV  : time_us,distance_mm,valid,speed_mm_s   one sensor sample per line, '#' comments
+ *******************************************************************************/
+extern "C" {
+#include "slot_estimator.h"
+}
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+constexpr double kBeamTan = 0.25;               /* Beam half width per mm of range (about 14 degrees) */
+constexpr double kMaxRangeMM = 4000.0;
+constexpr double kSamplePeriodUs = 60000.0;     /* One cycle of the sensors, the right one is read once in it */
+
+struct Sample
+{
+    std::uint32_t timeUs;
+    std::uint16_t distanceMM;
+    bool valid;
+    std::int16_t speedMMs;
+};
+
+/* Parked car along the row, x from the start of the run */
+struct Car
+{
+    double start;
+    double end;
+};
+
+struct Scene
+{
+    const char *name;
+    const char *description;
+    std::vector<Car> cars;
+    double sideMM;          /* Lateral distance to the parked cars */
+    double curbMM;          /* Lateral distance to the curb, 0 when none */
+    double lengthMM;        /* Length of the run */
+    double (*speed)(double t);  /* Real speed in mm/s */
+    double speedScale;      /* Reported speed / real speed (odometry error) */
+    double noiseMM;         /* Gaussian noise */
+    double spikeRate;       /* Share of samples reading a close echo */
+    double dropoutRate;     /* Share of samples with no echo */
+    bool checked;           /* Lengths are checked against the tolerance */
+};
+
+struct Gap
+{
+    double start;
+    double end;
+};
+
+double steady(double) { return 400.0; }
+double ramp(double t) { return std::min(150.0 + 150.0 * t, 600.0); }
+double stopAndGo(double t) { return (t > 2.0 && t < 3.0) ? 0.0 : 400.0; }
+double wavy(double t) { return 400.0 + 150.0 * std::sin(2.0 * t); }
+
+const std::vector<Scene> &scenes()
+{
+    static const std::vector<Scene> list = {
+        {"steady", "400 mm/s, clean echoes", {{-500, 600}, {1100, 1450}, {1800, 2600}, {3400, 5000}},
+         100, 280, 4000, steady, 1.0, 0, 0, 0, true},
+        {"ramp", "speeding up from 150 to 600 mm/s", {{-500, 600}, {1100, 1450}, {1800, 2600}, {3400, 5000}},
+         100, 280, 4000, ramp, 1.0, 0, 0, 0, true},
+        {"stop-and-go", "1 s stop inside a slot", {{-500, 600}, {1100, 1450}, {1800, 2600}, {3400, 5000}},
+         100, 280, 4000, stopAndGo, 1.0, 0, 0, 0, true},
+        {"wavy", "speed swinging 250..550 mm/s", {{-500, 600}, {1100, 1450}, {1800, 2600}, {3400, 5000}},
+         100, 280, 4000, wavy, 1.0, 0, 0, 0, true},
+        {"noisy", "8 mm noise, 4 % spikes, 4 % dropouts", {{-500, 600}, {1100, 1450}, {1800, 2600}, {3400, 5000}},
+         100, 280, 4000, steady, 1.0, 8, 0.04, 0.04, true},
+        {"no-curb", "nothing behind the slots, no echo there", {{-500, 600}, {1100, 1450}, {1800, 2600}, {3400, 5000}},
+         150, 0, 4000, steady, 1.0, 0, 0, 0, true},
+        {"speed-error", "speed over-reported by 10 %, not checked", {{-500, 600}, {1100, 1450}, {1800, 2600}, {3400, 5000}},
+         100, 280, 4000, steady, 1.1, 0, 0, 0, false},
+    };
+    return list;
+}
+
+/* Ground truth gaps: between consecutive cars, inside the run */
+std::vector<Gap> truthGaps(const Scene &scene)
+{
+    std::vector<Gap> gaps;
+    for (std::size_t i = 1; i < scene.cars.size(); i++)
+    {
+        if (scene.cars[i].start < scene.lengthMM)
+        {
+            gaps.push_back({scene.cars[i - 1].end, scene.cars[i].start});
+        }
+    }
+    return gaps;
+}
+
+/* Sample the scene: the beam sees a car within kBeamTan * range of the sensor position */
+std::vector<Sample> generate(const Scene &scene)
+{
+    std::vector<Sample> samples;
+    std::mt19937 rng(1234);
+    std::normal_distribution<double> noise(0.0, scene.noiseMM > 0 ? scene.noiseMM : 1e-9);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    double x = 0.0;
+    double t = 0.0;
+    const double dt = 0.001;
+    double nextSample = 0.0;
+
+    while (x < scene.lengthMM)
+    {
+        if (t >= nextSample)
+        {
+            double reach = scene.sideMM * kBeamTan;
+            bool seesCar = false;
+            for (const Car &car : scene.cars)
+            {
+                seesCar |= (x >= car.start - reach) && (x <= car.end + reach);
+            }
+
+            double distance = seesCar ? scene.sideMM : scene.curbMM;
+            bool valid = distance > 0.0 && distance < kMaxRangeMM;
+            double draw = unit(rng);
+            if (draw < scene.spikeRate)
+            {
+                distance = 60.0 + 40.0 * unit(rng);
+                valid = true;
+            }
+            else if (draw < scene.spikeRate + scene.dropoutRate)
+            {
+                valid = false;
+            }
+            distance += noise(rng);
+
+            samples.push_back({static_cast<std::uint32_t>(t * 1e6),
+                               static_cast<std::uint16_t>(valid ? std::max(distance, 20.0) : kMaxRangeMM),
+                               valid,
+                               static_cast<std::int16_t>(scene.speed(t) * scene.speedScale)});
+            /* Round period with a little jitter, like the echo lengths */
+            nextSample += (kSamplePeriodUs + 4000.0 * (unit(rng) - 0.5)) * 1e-6;
+        }
+        x += scene.speed(t) * dt;
+        t += dt;
+    }
+    return samples;
+}
+
+std::vector<Slot_GapType> stream(const std::vector<Sample> &samples)
+{
+    std::vector<Slot_GapType> gaps;
+    Slot_EstimatorType estimator;
+    Slot_GapType gap;
+
+    SlotEstimator_reset(&estimator);
+    for (const Sample &sample : samples)
+    {
+        if (SlotEstimator_update(&estimator, sample.timeUs, sample.distanceMM, sample.valid ? TRUE : FALSE,
+                                 sample.speedMMs, &gap))
+        {
+            gaps.push_back(gap);
+        }
+    }
+    return gaps;
+}
+
+void printGap(const Slot_GapType &gap)
+{
+    std::printf("start %6ld  end %6ld  length %5u  side %4u  depth %4u  confidence %3u",
+                static_cast<long>(gap.startMM), static_cast<long>(gap.endMM), gap.lengthMM, gap.sideMM,
+                gap.depthMM, gap.confidence);
+}
+
+bool readCsv(const char *path, std::vector<Sample> &samples)
+{
+    FILE *file = std::fopen(path, "r");
+    char line[128];
+
+    if (!file)
+    {
+        std::perror(path);
+        return false;
+    }
+    while (std::fgets(line, sizeof(line), file))
+    {
+        unsigned long timeUs;
+        unsigned distance;
+        int valid;
+        int speed;
+        if (line[0] == '#' || std::sscanf(line, "%lu,%u,%d,%d", &timeUs, &distance, &valid, &speed) != 4)
+        {
+            continue;   /* Comment or header */
+        }
+        samples.push_back({static_cast<std::uint32_t>(timeUs), static_cast<std::uint16_t>(distance), valid != 0,
+                           static_cast<std::int16_t>(speed)});
+    }
+    std::fclose(file);
+    return true;
+}
+
+int replayCsv(const char *path)
+{
+    std::vector<Sample> samples;
+
+    if (!readCsv(path, samples))
+    {
+        return 2;
+    }
+    std::printf("%s: %zu samples\n", path, samples.size());
+    for (const Slot_GapType &gap : stream(samples))
+    {
+        printGap(gap);
+        std::printf("\n");
+    }
+    return 0;
+}
+
+int dump(const char *name)
+{
+    for (const Scene &scene : scenes())
+    {
+        if (std::strcmp(scene.name, name) == 0)
+        {
+            std::printf("# %s: %s\ntime_us,distance_mm,valid,speed_mm_s\n", scene.name, scene.description);
+            for (const Sample &sample : generate(scene))
+            {
+                std::printf("%u,%u,%d,%d\n", sample.timeUs, sample.distanceMM, sample.valid ? 1 : 0, sample.speedMMs);
+            }
+            return 0;
+        }
+    }
+    std::fprintf(stderr, "unknown profile %s\n", name);
+    return 2;
+}
+
+/* Match every true gap with the measured one overlapping it */
+bool checkScene(const Scene &scene, double tolerance)
+{
+    std::vector<Gap> truth = truthGaps(scene);
+    std::vector<Slot_GapType> measured = stream(generate(scene));
+    bool ok = true;
+
+    std::printf("%s (%s)\n", scene.name, scene.description);
+    for (const Gap &gap : truth)
+    {
+        const Slot_GapType *match = nullptr;
+        for (const Slot_GapType &candidate : measured)
+        {
+            if (candidate.endMM > gap.start && candidate.startMM < gap.end)
+            {
+                match = &candidate;
+            }
+        }
+
+        double length = gap.end - gap.start;
+        std::printf("  true %5.0f  ", length);
+        if (!match)
+        {
+            std::printf("missed\n");
+            ok &= !scene.checked;
+            continue;
+        }
+        double error = match->lengthMM - length;
+        printGap(*match);
+        std::printf("  error %+5.0f%s\n", error,
+                    (scene.checked && std::fabs(error) > tolerance) ? "  OUT OF TOLERANCE" : "");
+        ok &= !scene.checked || std::fabs(error) <= tolerance;
+    }
+    if (measured.size() > truth.size())
+    {
+        std::printf("  %zu extra gaps\n", measured.size() - truth.size());
+        ok &= !scene.checked;
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    double tolerance = 40.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--csv" && i + 1 < argc)
+        {
+            return replayCsv(argv[++i]);
+        }
+        else if (option == "--dump" && i + 1 < argc)
+        {
+            return dump(argv[++i]);
+        }
+        else if (option == "--tolerance" && i + 1 < argc)
+        {
+            tolerance = std::atof(argv[++i]);
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--csv FILE] [--dump NAME] [--tolerance MM]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int failed = 0;
+    for (const Scene &scene : scenes())
+    {
+        failed += checkScene(scene, tolerance) ? 0 : 1;
+    }
+    std::printf("%d / %zu profiles within %.0f mm\n", static_cast<int>(scenes().size()) - failed, scenes().size(),
+                tolerance);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Module       : Telemetry Decoder (host)
+ * File Name    : telemetry_decoder.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the host side decoder of the binary telemetry frames
+ *******************************************************************************/
+#include "telemetry_decoder.hpp"
+
+#include <utility>
+
+namespace isvms {
+
+namespace {
+
+/* Longest COBS block kept while waiting for a delimiter, anything longer is noise */
+constexpr std::size_t kMaxBlockSize = 64;
+
+std::uint16_t get16(const std::uint8_t *data)
+{
+    return static_cast<std::uint16_t>(data[0] | (data[1] << 8));
+}
+
+} // namespace
+
+std::uint16_t crc16CcittFalse(const std::uint8_t *data, std::size_t length)
+{
+    std::uint16_t crc = 0xFFFF;
+
+    while (length--)
+    {
+        crc ^= static_cast<std::uint16_t>(*data++) << 8;
+        for (int i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x8000) ? static_cast<std::uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<std::uint16_t>(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+bool cobsDecode(const std::uint8_t *data, std::size_t length, std::vector<std::uint8_t> &out)
+{
+    std::size_t i = 0;
+
+    out.clear();
+    while (i < length)
+    {
+        std::uint8_t code = data[i++];
+        if (code == 0 || i + code - 1 > length)
+        {
+            return false;
+        }
+        for (std::uint8_t j = 1; j < code; j++)
+        {
+            if (data[i] == 0)
+            {
+                return false;
+            }
+            out.push_back(data[i++]);
+        }
+        /* A block shorter than 255 stands for a zero, except at the end of the frame */
+        if (code != 0xFF && i < length)
+        {
+            out.push_back(0);
+        }
+    }
+
+    return true;
+}
+
+TelemetryDecoder::TelemetryDecoder(FrameCallback callback)
+    : callback_(std::move(callback))
+{
+    block_.reserve(kMaxBlockSize);
+}
+
+bool TelemetryDecoder::decodeFrame(const std::uint8_t *encoded, std::size_t length, TelemetryFrame &frame)
+{
+    std::vector<std::uint8_t> raw;
+
+    if (!cobsDecode(encoded, length, raw) || raw.size() != kTelemetryFrameSize)
+    {
+        return false;
+    }
+    if (crc16CcittFalse(raw.data(), kTelemetryPayloadSize) != get16(&raw[kTelemetryPayloadSize]))
+    {
+        return false;
+    }
+
+    frame.sequence = raw[0];
+    frame.timestampMs = get16(&raw[1]);
+    frame.distanceRightMm = get16(&raw[3]);
+    frame.distanceForwardMm = get16(&raw[5]);
+    frame.distanceBackwardMm = get16(&raw[7]);
+    frame.motor1Duty = static_cast<std::int8_t>(raw[9]);
+    frame.motor2Duty = static_cast<std::int8_t>(raw[10]);
+    frame.flags = raw[11];
+
+    return true;
+}
+
+void TelemetryDecoder::feed(const std::uint8_t *data, std::size_t length)
+{
+    for (std::size_t i = 0; i < length; i++)
+    {
+        if (data[i] == 0)
+        {
+            endOfFrame();
+        }
+        else if (block_.size() < kMaxBlockSize)
+        {
+            block_.push_back(data[i]);
+        }
+    }
+}
+
+void TelemetryDecoder::endOfFrame()
+{
+    TelemetryFrame frame;
+    bool synchronized = synchronized_;
+
+    synchronized_ = true;
+    if (block_.empty())
+    {
+        return;
+    }
+
+    bool ok = decodeFrame(block_.data(), block_.size(), frame);
+    if (!ok)
+    {
+        /* Tell a damaged frame from bad framing, only the first one may be a partial frame */
+        std::vector<std::uint8_t> raw;
+        if (synchronized)
+        {
+            if (cobsDecode(block_.data(), block_.size(), raw) && raw.size() == kTelemetryFrameSize)
+            {
+                stats_.crcErrors++;
+            }
+            else
+            {
+                stats_.framingErrors++;
+            }
+        }
+        block_.clear();
+        return;
+    }
+    block_.clear();
+
+    if (haveLast_)
+    {
+        stats_.lostFrames += static_cast<std::uint8_t>(frame.sequence - lastSequence_ - 1);
+        timeMs_ += static_cast<std::uint16_t>(frame.timestampMs - lastTimestampMs_);
+    }
+    else
+    {
+        timeMs_ = frame.timestampMs;
+    }
+    haveLast_ = true;
+    lastSequence_ = frame.sequence;
+    lastTimestampMs_ = frame.timestampMs;
+    frame.timeMs = timeMs_;
+
+    stats_.frames++;
+    if (callback_)
+    {
+        callback_(frame);
+    }
+}
+
+} // namespace isvms
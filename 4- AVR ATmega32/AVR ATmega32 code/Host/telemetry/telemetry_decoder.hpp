@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Module       : Telemetry Decoder (host)
+ * File Name    : telemetry_decoder.hpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the host side decoder of the binary telemetry
+ *                frames sent by SERVICE/TELEMETRY (COBS + CRC-16)
+ *******************************************************************************/
+#ifndef HOST_TELEMETRY_DECODER_HPP_
+#define HOST_TELEMETRY_DECODER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace isvms {
+
+/* Frame layout, must match SERVICE/TELEMETRY/telemetry.h */
+constexpr std::size_t kTelemetryPayloadSize = 12;
+constexpr std::size_t kTelemetryFrameSize = kTelemetryPayloadSize + 2;
+
+constexpr std::uint8_t kFlagRightValid    = 1u << 0;
+constexpr std::uint8_t kFlagForwardValid  = 1u << 1;
+constexpr std::uint8_t kFlagBackwardValid = 1u << 2;
+constexpr std::uint8_t kFlagWarning       = 1u << 3;
+constexpr std::uint8_t kFlagTxOverflow    = 1u << 4;
+
+/* One decoded telemetry sample */
+struct TelemetryFrame
+{
+    std::uint8_t sequence = 0;
+    std::uint16_t timestampMs = 0;      /* As sent, wraps every 65.536s */
+    std::uint64_t timeMs = 0;           /* Unwrapped by the decoder */
+    std::uint16_t distanceRightMm = 0;
+    std::uint16_t distanceForwardMm = 0;
+    std::uint16_t distanceBackwardMm = 0;
+    std::int8_t motor1Duty = 0;
+    std::int8_t motor2Duty = 0;
+    std::uint8_t flags = 0;
+};
+
+/* Link quality counters */
+struct TelemetryStats
+{
+    std::uint32_t frames = 0;           /* Frames that passed the CRC */
+    std::uint32_t crcErrors = 0;
+    std::uint32_t framingErrors = 0;    /* Bad COBS or wrong length */
+    std::uint32_t lostFrames = 0;       /* Sequence gaps */
+};
+
+/*
+ * CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+ */
+std::uint16_t crc16CcittFalse(const std::uint8_t *data, std::size_t length);
+
+/*
+ * Decode one COBS block (without the 0x00 delimiter).
+ * Returns false on a malformed block.
+ */
+bool cobsDecode(const std::uint8_t *data, std::size_t length, std::vector<std::uint8_t> &out);
+
+/*
+ * Stream decoder: feed the raw serial bytes in any chunking, every valid frame
+ * is delivered to the callback in order.
+ */
+class TelemetryDecoder
+{
+public:
+    using FrameCallback = std::function<void(const TelemetryFrame &)>;
+
+    explicit TelemetryDecoder(FrameCallback callback);
+
+    void feed(const std::uint8_t *data, std::size_t length);
+
+    const TelemetryStats &stats() const { return stats_; }
+
+    /* Decode one encoded frame (without the delimiter), no stream state is used */
+    static bool decodeFrame(const std::uint8_t *encoded, std::size_t length, TelemetryFrame &frame);
+
+private:
+    void endOfFrame();
+
+    FrameCallback callback_;
+    std::vector<std::uint8_t> block_;
+    TelemetryStats stats_;
+    bool synchronized_ = false;         /* The first block may be a partial frame */
+    bool haveLast_ = false;
+    std::uint8_t lastSequence_ = 0;
+    std::uint16_t lastTimestampMs_ = 0;
+    std::uint64_t timeMs_ = 0;
+};
+
+} // namespace isvms
+
+#endif /* HOST_TELEMETRY_DECODER_HPP_ */
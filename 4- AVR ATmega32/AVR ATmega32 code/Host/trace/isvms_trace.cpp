@@ -0,0 +1,276 @@
+/******************************************************************************
+ * Module       : Trace Tool (host)
+ * File Name    : isvms_trace.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Turns serial captures holding event trace dumps (command 'T') into
+ *                per event histograms and a Chrome trace timeline. For every interrupt
+ *                and task: the count and the duration from entry to exit, and for the
+ *                tasks the start latency after the scheduler tick that released them.
+ *                The timeline opens in chrome://tracing or ui.perfetto.dev, one process
+ *                per dump with the interrupts and the tasks on their own rows.
+ *
+ * Usage        : isvms_trace <capture> [trace.json] [--tasks name,name,...]
+ *                capture : raw serial bytes, "-" for stdin (e.g. isvms_host_trace 2 FT | isvms_trace -)
+ *                --tasks : task table names in order (default: the APP/Application.c table)
+ *******************************************************************************/
+#include "trace_decoder.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/* Must match the task table of APP/Application.c (MOTOR_SPEED_CONTROL and TRACE_ENABLE on) */
+const std::vector<std::string> kDefaultTasks = {
+    "readDistance", "collisionAvoidance", "App_commandTask", "DcMotor_rampTick", "DcMotor_speedTick",
+    "Parking_task", "App_feedbackTask", "Pattern_task", "PIR_task", "App_telemetryTask", "App_lcdTask",
+    "LCD_task", "Trace_task"};
+
+constexpr std::uint16_t kTickId = 0x08;     /* TIMER1_COMPB, the scheduler tick */
+constexpr int kBuckets = 16;                /* Powers of 2 microseconds, the last one is open */
+
+/* Histogram over [0, 1), [1, 2), [2, 4) ... microseconds */
+struct Histogram
+{
+    std::uint32_t counts[kBuckets] = {};
+    std::uint32_t total = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+
+    void add(double us)
+    {
+        int bucket = 0;
+        while (bucket < kBuckets - 1 && us >= static_cast<double>(1u << bucket))
+        {
+            bucket++;
+        }
+        counts[bucket]++;
+        min = (total == 0 || us < min) ? us : min;
+        max = (total == 0 || us > max) ? us : max;
+        sum += us;
+        total++;
+    }
+
+    void print(const char *what) const
+    {
+        if (total == 0)
+        {
+            return;
+        }
+        std::printf("  %-8s n %5u  min %8.1f us  mean %8.1f us  max %8.1f us\n", what, total, min, sum / total, max);
+        int first = 0;
+        int last = kBuckets - 1;
+        while (counts[first] == 0)
+        {
+            first++;
+        }
+        while (counts[last] == 0)
+        {
+            last--;
+        }
+        for (int b = first; b <= last; b++)
+        {
+            char range[32];
+            if (b == 0)
+            {
+                std::snprintf(range, sizeof(range), "< 1 us");
+            }
+            else if (b == kBuckets - 1)
+            {
+                std::snprintf(range, sizeof(range), ">= %u us", 1u << (b - 1));
+            }
+            else
+            {
+                std::snprintf(range, sizeof(range), "%u-%u us", 1u << (b - 1), 1u << b);
+            }
+            int bar = static_cast<int>((counts[b] * 40 + total - 1) / total);
+            std::printf("    %14s %6u  %.*s\n", range, counts[b], bar, "########################################");
+        }
+    }
+};
+
+struct EventStats
+{
+    Histogram duration;     /* Entry to exit */
+    Histogram latency;      /* Tasks: start after the releasing tick */
+};
+
+std::vector<std::string> g_tasks = kDefaultTasks;
+std::map<std::uint16_t, EventStats> g_stats;
+std::string g_json;
+std::uint32_t g_lostEvents = 0;
+
+/*******************************************************************************
+ *                                 Dumps                                       *
+ *******************************************************************************/
+void jsonEvent(const char *phase, const std::string &name, unsigned pid, unsigned tid, double ts, double dur,
+               const char *category)
+{
+    char line[256];
+
+    if (phase[0] == 'M')
+    {
+        std::snprintf(line, sizeof(line), "%s\n{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                      g_json.empty() ? "" : ",", category, pid, tid, name.c_str());
+    }
+    else
+    {
+        std::snprintf(line, sizeof(line), "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,"
+                      "\"ts\":%.1f,\"dur\":%.1f}",
+                      g_json.empty() ? "" : ",", name.c_str(), category, pid, tid, ts, dur);
+    }
+    g_json += line;
+}
+
+/* Pair the entries and exits, interrupts do not nest and neither do tasks, but tasks are interrupted */
+void onDump(const isvms::TraceDump &dump)
+{
+    const isvms::TraceEvent *open[2] = {nullptr, nullptr};     /* Interrupt, task */
+    double lastTick = -1.0;
+    unsigned pid = dump.number;
+
+    std::printf("dump %u: %zu events over %.1f ms, %u overwritten before it%s\n", dump.number, dump.events.size(),
+                dump.events.empty() ? 0.0 : dump.events.back().timeUs / 1000.0, dump.lost,
+                dump.complete ? "" : ", frames missing");
+    g_lostEvents += dump.lost;
+    jsonEvent("M", "dump " + std::to_string(dump.number), pid, 0, 0.0, 0.0, "process_name");
+    jsonEvent("M", "interrupts", pid, 1, 0.0, 0.0, "thread_name");
+    jsonEvent("M", "tasks", pid, 2, 0.0, 0.0, "thread_name");
+
+    for (const isvms::TraceEvent &event : dump.events)
+    {
+        std::uint16_t id = static_cast<std::uint16_t>(event.id & ~isvms::kTraceExit);
+        int row = (id >= isvms::kTraceTaskBase) ? 1 : 0;
+
+        if (!(event.id & isvms::kTraceExit))
+        {
+            open[row] = &event;
+            if (id == kTickId)
+            {
+                lastTick = event.timeUs;
+            }
+            else if (row == 1 && lastTick >= 0.0)
+            {
+                g_stats[id].latency.add(event.timeUs - lastTick);
+            }
+            continue;
+        }
+
+        /* An exit without its entry started before the buffer */
+        if (open[row] == nullptr || open[row]->id != id)
+        {
+            open[row] = nullptr;
+            continue;
+        }
+        double duration = event.timeUs - open[row]->timeUs;
+        g_stats[id].duration.add(duration);
+        jsonEvent("X", isvms::traceEventName(id, g_tasks), pid, static_cast<unsigned>(row + 1), open[row]->timeUs,
+                  duration, row ? "task" : "isr");
+        open[row] = nullptr;
+    }
+}
+
+std::vector<std::string> split(const char *list)
+{
+    std::vector<std::string> names;
+    std::string name;
+
+    for (const char *c = list; ; c++)
+    {
+        if (*c == ',' || *c == '\0')
+        {
+            names.push_back(name);
+            name.clear();
+            if (*c == '\0')
+            {
+                break;
+            }
+        }
+        else
+        {
+            name += *c;
+        }
+    }
+    return names;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *capturePath = nullptr;
+    const char *jsonPath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--tasks") == 0 && i + 1 < argc)
+        {
+            g_tasks = split(argv[++i]);
+        }
+        else if (capturePath == nullptr)
+        {
+            capturePath = argv[i];
+        }
+        else
+        {
+            jsonPath = argv[i];
+        }
+    }
+    if (capturePath == nullptr)
+    {
+        std::fprintf(stderr, "usage: isvms_trace <capture|-> [trace.json] [--tasks name,name,...]\n");
+        return 2;
+    }
+
+    FILE *in = (std::strcmp(capturePath, "-") == 0) ? stdin : std::fopen(capturePath, "rb");
+    if (in == nullptr)
+    {
+        std::perror(capturePath);
+        return 1;
+    }
+
+    isvms::TraceDecoder decoder(onDump);
+    std::uint8_t buffer[4096];
+    std::size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), in)) > 0)
+    {
+        decoder.feed(buffer, n);
+    }
+    decoder.finish();
+    if (in != stdin)
+    {
+        std::fclose(in);
+    }
+
+    const isvms::TraceStats &stats = decoder.stats();
+    std::printf("%u dumps, %u frames, %u missing, %u overwritten events\n\n", stats.dumps, stats.frames,
+                stats.missingFrames, g_lostEvents);
+    for (const auto &entry : g_stats)
+    {
+        std::printf("%s\n", isvms::traceEventName(entry.first, g_tasks).c_str());
+        entry.second.duration.print("duration");
+        entry.second.latency.print("latency");
+    }
+
+    if (jsonPath != nullptr)
+    {
+        FILE *out = std::fopen(jsonPath, "w");
+        if (out == nullptr)
+        {
+            std::perror(jsonPath);
+            return 1;
+        }
+        std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[%s\n]}\n", g_json.c_str());
+        std::fclose(out);
+    }
+
+    return (stats.dumps > 0) ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Module       : Trace Decoder (host)
+ * File Name    : trace_decoder.cpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Source file for the host side decoder of the event trace dumps
+ *******************************************************************************/
+#include "trace_decoder.hpp"
+#include "telemetry_decoder.hpp"
+
+#include <utility>
+
+namespace isvms {
+
+namespace {
+
+/* Longest block kept while waiting for a delimiter, anything longer is not a trace frame */
+constexpr std::size_t kMaxBlockSize = 128;
+
+/* Interrupt ids 1 to 14, must match SERVICE/TRACE/trace.h */
+const char *const kVectorNames[] = {
+    "INT0", "INT1", "INT2", "TIMER0_OVF", "TIMER0_COMP", "TIMER1_OVF", "TIMER1_COMPA",
+    "TIMER1_COMPB", "TIMER2_OVF", "TIMER2_COMP", "USART_RXC", "USART_UDRE", "USART_TXC", "TIMER1_CAPT"};
+
+std::uint16_t get16(const std::uint8_t *data)
+{
+    return static_cast<std::uint16_t>(data[0] | (data[1] << 8));
+}
+
+} // namespace
+
+std::string traceEventName(std::uint16_t id, const std::vector<std::string> &taskNames)
+{
+    id = static_cast<std::uint16_t>(id & ~kTraceExit);
+    if (id >= kTraceTaskBase)
+    {
+        std::size_t task = id - kTraceTaskBase;
+        return (task < taskNames.size()) ? taskNames[task] : "task " + std::to_string(task);
+    }
+    if (id >= 1 && id <= sizeof(kVectorNames) / sizeof(kVectorNames[0]))
+    {
+        return kVectorNames[id - 1];
+    }
+    return "event " + std::to_string(id);
+}
+
+TraceDecoder::TraceDecoder(DumpCallback callback)
+    : callback_(std::move(callback))
+{
+    block_.reserve(kMaxBlockSize);
+}
+
+void TraceDecoder::feed(const std::uint8_t *data, std::size_t length)
+{
+    for (std::size_t i = 0; i < length; i++)
+    {
+        if (data[i] == 0)
+        {
+            endOfBlock();
+        }
+        else if (block_.size() < kMaxBlockSize)
+        {
+            block_.push_back(data[i]);
+        }
+    }
+}
+
+void TraceDecoder::endOfBlock()
+{
+    std::vector<std::uint8_t> raw;
+
+    if (block_.empty())
+    {
+        return;
+    }
+    bool ok = cobsDecode(block_.data(), block_.size(), raw);
+    block_.clear();
+
+    /* 7 + 4 * events bytes, an odd length no telemetry frame has */
+    if (!ok || raw.size() < kTraceHeaderSize + 2 || (raw.size() - kTraceHeaderSize - 2) % kTraceEventSize != 0 ||
+        crc16CcittFalse(raw.data(), raw.size() - 2) != get16(&raw[raw.size() - 2]))
+    {
+        stats_.otherBlocks++;
+        return;
+    }
+    stats_.frames++;
+
+    std::uint8_t number = raw[0];
+    std::uint8_t index = raw[1];
+    std::uint8_t count = raw[2];
+
+    if (inDump_ && (number != dump_.number || index < nextFrame_))
+    {
+        /* The end of the previous dump was lost */
+        finish();
+    }
+    if (!inDump_)
+    {
+        dump_ = TraceDump();
+        dump_.number = number;
+        dump_.lost = get16(&raw[3]);
+        inDump_ = true;
+        nextFrame_ = 0;
+        frameCount_ = count;
+    }
+    if (index != nextFrame_)
+    {
+        stats_.missingFrames += static_cast<std::uint32_t>(index - nextFrame_);
+        dump_.complete = false;
+    }
+    nextFrame_ = static_cast<std::uint8_t>(index + 1);
+
+    for (std::size_t i = kTraceHeaderSize; i + 2 < raw.size(); i += kTraceEventSize)
+    {
+        TraceEvent event;
+        event.id = get16(&raw[i]);
+        event.ticks = get16(&raw[i + 2]);
+        dump_.events.push_back(event);
+    }
+
+    if (nextFrame_ >= frameCount_)
+    {
+        deliver();
+    }
+}
+
+void TraceDecoder::finish()
+{
+    if (inDump_)
+    {
+        stats_.missingFrames += static_cast<std::uint32_t>(frameCount_ - nextFrame_);
+        dump_.complete = false;
+        deliver();
+    }
+}
+
+void TraceDecoder::deliver()
+{
+    double timeUs = 0.0;
+
+    /* Unwrap the Timer1 counts, consecutive events are less than one wrap (32.768ms) apart */
+    for (std::size_t i = 1; i < dump_.events.size(); i++)
+    {
+        timeUs += static_cast<std::uint16_t>(dump_.events[i].ticks - dump_.events[i - 1].ticks) / kTraceTicksPerUs;
+        dump_.events[i].timeUs = timeUs;
+    }
+
+    inDump_ = false;
+    stats_.dumps++;
+    if (callback_)
+    {
+        callback_(dump_);
+    }
+}
+
+} // namespace isvms
@@ -0,0 +1,88 @@
+/******************************************************************************
+ * Module       : Trace Decoder (host)
+ * File Name    : trace_decoder.hpp
+ * Author       : A7la Team :)
+ * Created on   : 16/10/2026
+ * Description  : Header file for the host side decoder of the event trace dumps
+ *                sent by SERVICE/TRACE (COBS + CRC-16 frames among the CSV lines)
+ *******************************************************************************/
+#ifndef HOST_TRACE_DECODER_HPP_
+#define HOST_TRACE_DECODER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace isvms {
+
+/* Frame layout and event ids, must match SERVICE/TRACE/trace.h */
+constexpr std::size_t kTraceHeaderSize = 5;
+constexpr std::size_t kTraceEventSize = 4;
+constexpr std::uint16_t kTraceExit = 0x8000;
+constexpr std::uint16_t kTraceTaskBase = 0x100;
+constexpr double kTraceTicksPerUs = 2.0;       /* Timer1 at F_CPU/8 */
+
+/* One recorded event, the time is unwrapped from the first event of the dump */
+struct TraceEvent
+{
+    std::uint16_t id = 0;           /* With kTraceExit on the exit of an interrupt or a task */
+    std::uint16_t ticks = 0;        /* Timer1 count as recorded */
+    double timeUs = 0.0;
+};
+
+/* One dump, oldest event first */
+struct TraceDump
+{
+    std::uint8_t number = 0;
+    std::uint16_t lost = 0;         /* Events overwritten before the dump */
+    bool complete = true;           /* False when frames are missing, the times after a gap are unreliable */
+    std::vector<TraceEvent> events;
+};
+
+struct TraceStats
+{
+    std::uint32_t frames = 0;           /* Trace frames that passed the CRC */
+    std::uint32_t dumps = 0;
+    std::uint32_t missingFrames = 0;
+    std::uint32_t otherBlocks = 0;      /* CSV lines, telemetry frames or damaged frames */
+};
+
+/*
+ * Stream decoder: feed the raw serial bytes in any chunking, every dump is
+ * delivered to the callback once its last frame is received.
+ */
+class TraceDecoder
+{
+public:
+    using DumpCallback = std::function<void(const TraceDump &)>;
+
+    explicit TraceDecoder(DumpCallback callback);
+
+    void feed(const std::uint8_t *data, std::size_t length);
+
+    /* End of the capture: deliver a dump whose last frames never came */
+    void finish();
+
+    const TraceStats &stats() const { return stats_; }
+
+private:
+    void endOfBlock();
+    void deliver();
+
+    DumpCallback callback_;
+    std::vector<std::uint8_t> block_;
+    TraceStats stats_;
+    TraceDump dump_;
+    bool inDump_ = false;
+    std::uint8_t nextFrame_ = 0;
+    std::uint8_t frameCount_ = 0;
+};
+
+/* Name of an event id without the exit flag: the interrupt vector, or the task name when known */
+std::string traceEventName(std::uint16_t id, const std::vector<std::string> &taskNames);
+
+} // namespace isvms
+
+#endif /* HOST_TRACE_DECODER_HPP_ */